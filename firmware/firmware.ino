@@ -1,6 +1,7 @@
 #include "src/config.h"
 #include "src/network/NetworkHandler.h"
 #include "src/webserver/LocalWebServer.h"
+#include "src/webserver/ValueSocket.h"
 #include "src/display/DisplayHandler.h"
 #include "src/comport/Comport1.h"
 #include "src/comport/Comport2.h"
@@ -11,6 +12,10 @@
 #include "src/services/PreferencesService.h"
 #include "src/services/ModbusPollingService.h"
 #include "src/services/RegisterMappingService.h"
+#include "src/services/TelemetryService.h"
+#include "src/services/HistoryService.h"
+#include "src/services/WarmStartService.h"
+#include "src/services/JsonPool.h"
 
 Comport1 c1;
 Comport2 c2;
@@ -34,6 +39,9 @@ void setup() {
     displayHandler.write("v" FIRMWARE_VERSION);
     displayHandler.addNewLine();
     
+    // Reserve the JSON document arena before any service reads its configuration
+    JsonPool::init();
+    
     // Initialize Status Service (must be early)
     Serial.println("Initializing Status Service...");
     StatusService::init();
@@ -46,10 +54,17 @@ void setup() {
     Serial.println("Initializing Modbus Service...");
     ModbusService::init();
     
+    // Initialize History Service (load tracked register selection)
+    Serial.println("Initializing History Service...");
+    HistoryService::init();
+    
     // Build register mapping for COM1
     Serial.println("Building Register Mapping...");
     RegisterMappingService::buildMapping();
     
+    // Serve the last known values on COM1 until polling has refreshed them
+    WarmStartService::restore();
+    
     Serial.println("Services initialized");
     PreferencesService::printStorageInfo();
     
@@ -60,15 +75,23 @@ void setup() {
     // Start web server with all API routes
     Serial.println("Starting web server...");
     LocalWebServer::start();
+    Serial.printf("Web server serving %lu ms after boot\n", (unsigned long)millis());
+    
+    // Initialize Telemetry Service (after the web server so its task can be watched)
+    Serial.println("Initializing Telemetry Service...");
+    TelemetryService::init();
 
     // Setup UART interfaces
     const auto& uartCfg = InterfacesService::getConfig();
     
     Serial.println("Setting up UART2 (Comport2 - Master)...");
-    c2.setup(uartCfg.uart2.baudrate, utils::getSerialConfigEnum(uartCfg.uart2.dataBits, uartCfg.uart2.stopBits, uartCfg.uart2.parity));
+    c2.setup(uartCfg.uart2.baudrate, utils::getSerialConfigEnum(uartCfg.uart2.dataBits, uartCfg.uart2.stopBits, uartCfg.uart2.parity),
+             uartCfg.uart2.frameIntervalUs(), uartCfg.uart2.charTimeUs(),
+             uartCfg.uart2TimeoutMinMs, uartCfg.uart2TimeoutMaxMs);
     
     Serial.println("Setting up UART1 (Comport1 - Slave)...");
-    c1.setup(uartCfg.uart1.baudrate, utils::getSerialConfigEnum(uartCfg.uart1.dataBits, uartCfg.uart1.stopBits, uartCfg.uart1.parity), &c2);
+    c1.setup(uartCfg.uart1.baudrate, utils::getSerialConfigEnum(uartCfg.uart1.dataBits, uartCfg.uart1.stopBits, uartCfg.uart1.parity), &c2,
+             uartCfg.uart1.frameIntervalUs());
     
     // Initialize Modbus Polling Service for COM2
     Serial.println("Initializing Modbus Polling Service...");
@@ -84,8 +107,14 @@ void setup() {
 void loop() {
     // Update Modbus polling service
     ModbusPollingService::update();
+    ModbusService::update();
+    TelemetryService::update();
+    ValueSocket::update();
+    WarmStartService::update();
 
     if (digitalRead(35)) {
+        ModbusService::flush();
+        WarmStartService::saveToRtc();
         ESP.restart();
     }
     
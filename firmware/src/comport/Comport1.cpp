@@ -3,10 +3,26 @@
 #include "../services/StatusService.h"
 #include "../services/RegisterMappingService.h"
 #include "../services/ModbusService.h"
+#include "../services/TelemetryService.h"
 
 #define MAX_REGISTERS 65535
 
-void Comport1::setup(uint32_t baudrate, SerialConfig config, Comport2* com2) {
+namespace {
+
+// Records handler service time (entry to return) into StatusService
+struct ServiceTimer {
+    uint8_t functionCode;
+    uint32_t startUs;
+
+    explicit ServiceTimer(uint8_t fc) : functionCode(fc), startUs(micros()) {
+        TelemetryService::watchCurrentTask("com1");
+    }
+    ~ServiceTimer() { StatusService::recordCom1Service(functionCode, micros() - startUs); }
+};
+
+} // namespace
+
+void Comport1::setup(uint32_t baudrate, SerialConfig config, Comport2* com2, uint32_t frameIntervalUs) {
     _comport2 = com2;
     RTUutils::prepareHardwareSerial(_COM);
     _COM.begin(baudrate, config, COMPORT1_RX, COMPORT1_TX);
@@ -25,11 +41,15 @@ void Comport1::setup(uint32_t baudrate, SerialConfig config, Comport2* com2) {
             return this->slaveHandlerFC06(request);
         });
 
-    _modbus.begin(_COM);
+    // Interval computed from the port settings (InterfacesData::frameIntervalUs: the configured
+    // gap, else 3.5 characters, 1750 us above 19200 baud); only the default of 0 leaves it to eModbus
+    Serial.printf("[COM1] Inter-frame interval: %u us\n", frameIntervalUs);
+    _modbus.begin(_COM, -1, frameIntervalUs);
 }
 
 // FC03: worker do serve Modbus function code 0x03 (READ_HOLD_REGISTER)
 ModbusMessage Comport1::slaveHandlerFC03(ModbusMessage request) {
+  ServiceTimer timer(READ_HOLD_REGISTER);
 
   StatusService::addUart1Received(1);
 
@@ -46,6 +66,7 @@ ModbusMessage Comport1::slaveHandlerFC03(ModbusMessage request) {
   if (!RegisterMappingService::groupExists(serverID)) {
     Serial.printf("[COM1] FC03: Unknown group/server ID %d\n", serverID);
     response.setError(serverID, request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
+    StatusService::addUart1Error(ILLEGAL_DATA_ADDRESS);
     StatusService::addUart1Sent(1);
     return response;
   }
@@ -73,11 +94,13 @@ ModbusMessage Comport1::slaveHandlerFC03(ModbusMessage request) {
     if (!allFound) {
       Serial.printf("[COM1] FC03: Register not found in mapping at address %d\n", address);
       response.setError(serverID, request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
+      StatusService::addUart1Error(ILLEGAL_DATA_ADDRESS);
     }
   } else {
     // No, either address or words are outside the limits. Set up error response.
     Serial.printf("[COM1] FC03: Illegal address %d or words %d (max: %d)\n", address, words, maxRegs);
     response.setError(serverID, request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
+    StatusService::addUart1Error(ILLEGAL_DATA_ADDRESS);
   }
   
   StatusService::addUart1Sent(1);
@@ -87,6 +110,7 @@ ModbusMessage Comport1::slaveHandlerFC03(ModbusMessage request) {
 
 // FC06: worker to serve Modbus function code 0x06 (WRITE_HOLD_REGISTER)
 ModbusMessage Comport1::slaveHandlerFC06(ModbusMessage request) {
+  ServiceTimer timer(WRITE_HOLD_REGISTER);
 
   StatusService::addUart1Received(1);
 
@@ -103,6 +127,7 @@ ModbusMessage Comport1::slaveHandlerFC06(ModbusMessage request) {
   if (!RegisterMappingService::groupExists(serverID)) {
     Serial.printf("[COM1] FC06: Unknown group/server ID %d\n", serverID);
     response.setError(serverID, request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
+    StatusService::addUart1Error(ILLEGAL_DATA_ADDRESS);
     StatusService::addUart1Sent(1);
     return response;
   }
@@ -114,13 +139,18 @@ ModbusMessage Comport1::slaveHandlerFC06(ModbusMessage request) {
   if (!RegisterMappingService::getRegisterInfo(serverID, address, slaveId, actualRegId)) {
     Serial.printf("[COM1] FC06: Address %d not found in mapping\n", address);
     response.setError(serverID, request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
+    StatusService::addUart1Error(ILLEGAL_DATA_ADDRESS);
     StatusService::addUart1Sent(1);
     return response;
   }
 
   // Get remote address for this group
-  auto* group = ModbusService::getGroup(serverID);
-  uint8_t remoteAddress = group ? group->remoteAddress : serverID;
+  uint8_t remoteAddress = serverID;
+  {
+    ModbusService::ReadGuard config;
+    auto* group = config.getGroup(serverID);
+    if (group) remoteAddress = group->remoteAddress;
+  }
   
   // Trigger write on COM2 (pass value directly, don't use global data)
   if (_comport2) {
@@ -142,12 +172,14 @@ ModbusMessage Comport1::slaveHandlerFC06(ModbusMessage request) {
     } else {
       Serial.printf("[COM1] FC06: Failed to queue write request\n");
       response.setError(serverID, request.getFunctionCode(), REQUEST_QUEUE_FULL);
+      StatusService::addUart1Error(REQUEST_QUEUE_FULL);
       StatusService::addUart1Sent(1);
       return response;
     }
   } else {
     Serial.printf("[COM1] FC06: COM2 not available for write\n");
     response.setError(serverID, request.getFunctionCode(), REQUEST_QUEUE_FULL);
+    StatusService::addUart1Error(REQUEST_QUEUE_FULL);
     StatusService::addUart1Sent(1);
     return response;
   }
@@ -19,7 +19,7 @@ class Comport2;
 class Comport1 {
 public:
     Comport1() : _COM(1), _modbus(20000, COMPORT1_TX_EN), _comport2(nullptr) {};
-    void setup(uint32_t baudrate, SerialConfig config, Comport2* com2 = nullptr);
+    void setup(uint32_t baudrate, SerialConfig config, Comport2* com2 = nullptr, uint32_t frameIntervalUs = 0);
 private:
     HardwareSerial _COM;
     ModbusServerRTU _modbus;
@@ -1,82 +1,271 @@
 #include "Comport2.h"
+#include <algorithm>
 #include "../services/ModbusService.h"
 #include "../services/StatusService.h"
 #include "../services/ModbusPollingService.h"
+#include "../services/TelemetryService.h"
+#include "../services/HistoryService.h"
+
+void Comport2::setup(uint32_t baudrate, SerialConfig config, uint32_t frameIntervalUs, uint32_t charTimeUs,
+                     uint32_t timeoutFloorMs, uint32_t timeoutCeilingMs) {
+    _timeoutFloorMs = timeoutFloorMs;
+    _timeoutCeilingMs = timeoutCeilingMs;
+    _frameIntervalUs = frameIntervalUs;
+    _charTimeUs = charTimeUs;
 
-void Comport2::setup(uint32_t baudrate, SerialConfig config) {
     RTUutils::prepareHardwareSerial(_COM);
     _COM.begin(baudrate, config, COMPORT2_RX, COMPORT2_TX);
 
     _modbus.onDataHandler([this](ModbusMessage response, uint32_t token) {this->handleData(response, token);});
     _modbus.onErrorHandler([this](Error error, uint32_t token) {this->handleError(error, token);});
 
-    _modbus.setTimeout(500);
+    // Until a remote has been measured its requests use the ceiling
+    _appliedTimeoutMs = _timeoutCeilingMs;
+    _modbus.setTimeout(_appliedTimeoutMs);
+    _lastCompletionUs = micros();
 
-    _modbus.begin(_COM);
+    Serial.printf("[COM2] Inter-frame interval: %u us\n", _frameIntervalUs);
+    _modbus.begin(_COM, -1, _frameIntervalUs);
 }
 
 boolean Comport2::addRequest(uint32_t token, uint8_t slaveAddress, FunctionCode functionCode, uint16_t registerAddress, uint16_t value_or_count) {
 
-    Error err = _modbus.addRequest(token, slaveAddress, functionCode, registerAddress, value_or_count);
+    TelemetryService::AllocationScope scope(TelemetryService::POLLING);
+
+    uint32_t requestId;
+    {
+        std::lock_guard<std::mutex> lock(_pendingLock);
+
+        // Reads are idempotent: attach to an identical request that is already queued
+        if (functionCode == READ_HOLD_REGISTER) {
+            uint32_t existing = findPendingRead(slaveAddress, functionCode, registerAddress, value_or_count);
+            if (existing != 0) {
+                auto& waiters = _pending[existing].waiters;
+                if (std::find(waiters.begin(), waiters.end(), token) == waiters.end()) {
+                    waiters.push_back(token);
+                }
+                StatusService::addUart2DuplicateAvoided(1);
+                return true;
+            }
+        }
+
+        // Register before queueing, the response may arrive before addRequest returns
+        requestId = _nextRequestId++;
+        if (_nextRequestId == 0) _nextRequestId = 1;
+
+        PendingRequest& pending = _pending[requestId];
+        pending.slaveAddress = slaveAddress;
+        pending.functionCode = functionCode;
+        pending.registerAddress = registerAddress;
+        pending.valueOrCount = value_or_count;
+        pending.queuedUs = micros();
+        pending.waiters.push_back(token);
+
+        auto it = _timing.find(slaveAddress);
+        if (it == _timing.end()) {
+            it = _timing.emplace(slaveAddress, RemoteTiming(slaveAddress)).first;
+        }
+        pending.rtoMs = it->second.rtoMs(_timeoutFloorMs, _timeoutCeilingMs);
+        applyTimeout();
+    }
+
+    Error err = _modbus.addRequest(requestId, slaveAddress, functionCode, registerAddress, value_or_count);
     if (err!=SUCCESS) {
+        {
+            std::lock_guard<std::mutex> lock(_pendingLock);
+            _pending.erase(requestId);
+            applyTimeout();
+        }
         ModbusError e(err);
         Serial.printf("Error creating request: %02X - %s\n", (int)e, (const char *)e);
         return false;
     }
+    // FC03/FC06 request frames are 8 bytes including CRC
+    ModbusPollingService::onRequestSent(8);
     StatusService::addUart2Sent(1);
     return true;
 }
 
+size_t Comport2::getInFlightCount() {
+    std::lock_guard<std::mutex> lock(_pendingLock);
+    return _pending.size();
+}
 
-void Comport2::handleData(ModbusMessage response, uint32_t token) {
-    // Decrement ongoing request counter
-    ModbusPollingService::onResponseReceived();
-    
+uint32_t Comport2::findPendingRead(uint8_t slaveAddress, FunctionCode functionCode, uint16_t registerAddress, uint16_t count) {
+    // Linear scan: the in-flight set is bounded by the polling back-pressure
+    // Request IDs increase in queue order (wrapping), the newest identical read is the candidate
+    uint32_t match = 0;
+    for (const auto& entry : _pending) {
+        const PendingRequest& p = entry.second;
+        if (p.slaveAddress == slaveAddress && p.functionCode == functionCode &&
+            p.registerAddress == registerAddress && p.valueOrCount == count &&
+            (match == 0 || (int32_t)(entry.first - match) > 0)) {
+            match = entry.first;
+        }
+    }
+    if (match == 0) return 0;
+
+    // A write to the range queued after that read changes the value: the caller must read it again
+    for (const auto& entry : _pending) {
+        const PendingRequest& p = entry.second;
+        if (p.slaveAddress == slaveAddress && p.functionCode == WRITE_HOLD_REGISTER &&
+            p.registerAddress >= registerAddress && p.registerAddress - registerAddress < count &&
+            (int32_t)(entry.first - match) > 0) {
+            return 0;
+        }
+    }
+    return match;
+}
+
+std::vector<RemoteTiming> Comport2::getRemoteTimings() {
+    std::lock_guard<std::mutex> lock(_pendingLock);
+    std::vector<RemoteTiming> result;
+    result.reserve(_timing.size());
+    for (const auto& entry : _timing) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+bool Comport2::completePending(uint32_t requestId, Error error, size_t responseSize, PendingRequest& out) {
+    std::lock_guard<std::mutex> lock(_pendingLock);
+    auto it = _pending.find(requestId);
+    if (it == _pending.end()) {
+        return false;
+    }
+    out = std::move(it->second);
+    _pending.erase(it);
+
+    // The bus serves one request at a time in queue order, so a request
+    // starts on the wire when it was queued or when the previous one finished
+    uint32_t nowUs = micros();
+    uint32_t startUs = out.queuedUs;
+    if ((int32_t)(_lastCompletionUs - startUs) > 0) {
+        startUs = _lastCompletionUs;
+    }
+    uint32_t rttUs = nowUs - startUs;
+    _lastCompletionUs = nowUs;
+    StatusService::recordCom2QueueWait(startUs - out.queuedUs);
+
+    RemoteTiming& timing = _timing.emplace(out.slaveAddress, RemoteTiming(out.slaveAddress)).first->second;
+    if (error == TIMEOUT) {
+        timing.addTimeout();
+    } else if (error == SUCCESS || error < 0x80) {
+        // Data or a Modbus exception: the remote answered, the sample is valid
+        if (rttUs > out.rtoMs * 1000) {
+            timing.lateResponses++;
+        }
+        timing.addSample(rttUs);
+        StatusService::recordCom2Rtt(out.functionCode, rttUs);
+
+        // Turnaround = RTT minus the silent interval and both frames on the wire
+        // Request frames (FC03/FC06) are 8 bytes, responses carry a 2 byte CRC
+        size_t responseBytes = (error == SUCCESS ? responseSize : 3) + 2;
+        uint32_t wireUs = _frameIntervalUs + (8 + responseBytes) * _charTimeUs;
+        timing.addTurnaround(rttUs > wireUs ? rttUs - wireUs : 0);
+    }
+
+    applyTimeout();
+    return true;
+}
+
+void Comport2::applyTimeout() {
+    // eModbus RTU has a single client-wide timeout that the worker reads when it
+    // starts a request, so cover the slowest remote still waiting in the queue
+    uint32_t timeoutMs = 0;
+    for (const auto& entry : _pending) {
+        if (entry.second.rtoMs > timeoutMs) {
+            timeoutMs = entry.second.rtoMs;
+        }
+    }
+    if (timeoutMs == 0 || timeoutMs == _appliedTimeoutMs) {
+        return;
+    }
+    _appliedTimeoutMs = timeoutMs;
+    _modbus.setTimeout(timeoutMs);
+}
+
+void Comport2::handleData(ModbusMessage response, uint32_t requestId) {
+    TelemetryService::watchCurrentTask("com2");
+
+    // Decrement ongoing request counter (response frame plus CRC)
+    ModbusPollingService::onResponseReceived(response.size() + 2);
+
+    PendingRequest pending;
+    if (!completePending(requestId, SUCCESS, response.size(), pending)) {
+        Serial.printf("[Response] Unknown request %u\n", requestId);
+        return;
+    }
+
+    // Update UART statistics
+    StatusService::addUart2Received(1);
+
+    uint16_t value = 0;
+    if (pending.functionCode == WRITE_HOLD_REGISTER) {
+        // FC06 echoes the request: slave + fc + address + value
+        if (response.size() < 6) return;
+        response.get(4, value);
+    } else {
+        // For holding register read (function code 0x03), data starts at byte 3
+        if (response.size() < 5) return;  // At least: slave + fc + byte_count + 2 bytes data
+        response.get(3, value);
+    }
+
+    // Fan the value out to every caller merged into this request
+    for (uint32_t token : pending.waiters) {
+        applyValue(token, value);
+    }
+}
+
+void Comport2::applyValue(uint32_t token, uint16_t value) {
     // Decode token to get group ID, slave ID, and register ID
     uint8_t groupId = (token >> 24) & 0xFF;
     uint8_t slaveId = (token >> 16) & 0xFF;
     uint16_t registerId = token & 0xFFFF;
-    
-    // Extract register value from response
-    // For holding register read (function code 0x03), data starts at byte 2
-    if (response.size() >= 4) {  // At least: slave + fc + byte_count + 2 bytes data
-        uint16_t value = 0;
-        response.get(3, value);
-        
-        // Update the register value in ModbusService
-        bool updated = false;
-        if (slaveId == 0) {
-            // Group-level register
-            updated = ModbusService::updateRegisterValue(groupId, registerId, value);
-            Serial.printf("[Response] Group %d, Register %d : %d\n", 
-                         groupId, registerId, value);
-        } else {
-            // Slave register
-            updated = ModbusService::updateSlaveRegisterValue(groupId, slaveId, registerId, value);
-            Serial.printf("[Response] Group %d, Slave %d, Register %d : %d\n", 
-                         groupId, slaveId, registerId, value);
-        }
-        
-        // Update UART statistics
-        StatusService::addUart2Received(1);
+
+    HistoryService::record(token, value);
+
+    // Update the register value in ModbusService
+    if (slaveId == 0) {
+        // Group-level register
+        ModbusService::updateRegisterValue(groupId, registerId, value);
+        Serial.printf("[Response] Group %d, Register %d : %d\n",
+                     groupId, registerId, value);
+    } else {
+        // Slave register
+        ModbusService::updateSlaveRegisterValue(groupId, slaveId, registerId, value);
+        Serial.printf("[Response] Group %d, Slave %d, Register %d : %d\n",
+                     groupId, slaveId, registerId, value);
     }
 }
 
-void Comport2::handleError(Error error, uint32_t token) {
+void Comport2::handleError(Error error, uint32_t requestId) {
+    TelemetryService::watchCurrentTask("com2");
+
     // Decrement ongoing request counter (even on error)
     ModbusPollingService::onResponseReceived();
-    
-    uint8_t groupId = (token >> 24) & 0xFF;
-    uint8_t slaveId = (token >> 16) & 0xFF;
-    uint16_t registerId = token & 0xFFFF;
-    
+
+    PendingRequest pending;
+    if (!completePending(requestId, error, 0, pending)) {
+        Serial.printf("[Error] Unknown request %u\n", requestId);
+        return;
+    }
+
+    StatusService::addUart2Error(error);
+
     ModbusError e(error);
-    if (slaveId == 0) {
-        Serial.printf("[Error] Group %d, Register %d: %02X - %s\n", 
-                     groupId, registerId, (int)e, (const char *)e);
-    } else {
-        Serial.printf("[Error] Group %d, Slave %d, Register %d: %02X - %s\n", 
-                     groupId, slaveId, registerId, (int)e, (const char *)e);
+    for (uint32_t token : pending.waiters) {
+        uint8_t groupId = (token >> 24) & 0xFF;
+        uint8_t slaveId = (token >> 16) & 0xFF;
+        uint16_t registerId = token & 0xFFFF;
+
+        if (slaveId == 0) {
+            Serial.printf("[Error] Group %d, Register %d: %02X - %s\n",
+                         groupId, registerId, (int)e, (const char *)e);
+        } else {
+            Serial.printf("[Error] Group %d, Slave %d, Register %d: %02X - %s\n",
+                         groupId, slaveId, registerId, (int)e, (const char *)e);
+        }
     }
     StatusService::addUart2Received(1);
-}
\ No newline at end of file
+}
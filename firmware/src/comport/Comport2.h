@@ -2,6 +2,10 @@
 #define __COMPORT2_H__
 
 #include <ModbusClientRTU.h>
+#include <map>
+#include <vector>
+#include <mutex>
+#include "../models/RemoteTiming.h"
 
 #define COMPORT2_RX 32
 #define COMPORT2_TX 33
@@ -15,22 +19,82 @@
 
 class Comport2 {
 public:
-    Comport2() : _COM(2), _modbus(COMPORT2_TX_EN) {
+    Comport2() : _COM(2), _modbus(COMPORT2_TX_EN), _nextRequestId(1),
+                 _timeoutFloorMs(50), _timeoutCeilingMs(500), _appliedTimeoutMs(0), _lastCompletionUs(0),
+                 _frameIntervalUs(0), _charTimeUs(0) {
     };
-    void setup(uint32_t baudrate, SerialConfig config);
-    
+    void setup(uint32_t baudrate, SerialConfig config, uint32_t frameIntervalUs, uint32_t charTimeUs,
+               uint32_t timeoutFloorMs = 50, uint32_t timeoutCeilingMs = 500);
+
     // Add a request (made public for polling service)
+    // Reads of a target range that is already in flight are merged into the queued request,
+    // unless a write to that range was queued after it
     boolean addRequest(uint32_t token, uint8_t slaveAddress, FunctionCode functionCode, uint16_t registerAddress, uint16_t value_or_count);
 
+    // Number of requests queued in eModbus and not yet answered
+    size_t getInFlightCount();
+
+    // Copy of the round-trip statistics of every remote address seen so far
+    std::vector<RemoteTiming> getRemoteTimings();
+
+    uint32_t getTimeoutFloorMs() const { return _timeoutFloorMs; }
+    uint32_t getTimeoutCeilingMs() const { return _timeoutCeilingMs; }
+    uint32_t getAppliedTimeoutMs() const { return _appliedTimeoutMs; }
+    uint32_t getFrameIntervalUs() const { return _frameIntervalUs; }
+
 private:
     HardwareSerial _COM;
     ModbusClientRTU _modbus;
 
+    /**
+     * A request queued in the eModbus client
+     * Every caller token interested in the result is kept in waiters
+     */
+    struct PendingRequest {
+        uint8_t slaveAddress;
+        FunctionCode functionCode;
+        uint16_t registerAddress;
+        uint16_t valueOrCount;
+        uint32_t queuedUs;          // micros() when handed to eModbus
+        uint32_t rtoMs;             // Timeout computed for the remote at queue time
+        std::vector<uint32_t> waiters;
+    };
+
+    // In-flight requests keyed by the eModbus token (internal request ID)
+    std::map<uint32_t, PendingRequest> _pending;
+    std::mutex _pendingLock;
+    uint32_t _nextRequestId;
+
+    // Per remote address round-trip statistics and derived timeouts
+    std::map<uint8_t, RemoteTiming> _timing;
+    uint32_t _timeoutFloorMs;
+    uint32_t _timeoutCeilingMs;
+    uint32_t _appliedTimeoutMs;     // Timeout currently set on the eModbus client
+    uint32_t _lastCompletionUs;     // micros() of the last response or error
+
+    // Bus timing used to separate wire time from device turnaround
+    uint32_t _frameIntervalUs;      // Silent interval eModbus keeps before each frame
+    uint32_t _charTimeUs;           // Time to transmit one character
+
+    // Find an in-flight read for the same target range, returns 0 if none
+    // or if a write to the range was queued after it (merging would return the old value)
+    uint32_t findPendingRead(uint8_t slaveAddress, FunctionCode functionCode, uint16_t registerAddress, uint16_t count);
+
+    // Remove a finished request from the in-flight set and account its round trip
+    // responseSize is the received frame length without CRC (0 on timeout)
+    bool completePending(uint32_t requestId, Error error, size_t responseSize, PendingRequest& out);
+
+    // Set the client timeout to cover every request still queued (caller holds _pendingLock)
+    void applyTimeout();
+
     // Handle the response
-    void handleData(ModbusMessage response, uint32_t token);
+    void handleData(ModbusMessage response, uint32_t requestId);
 
     // Handle the error
-    void handleError(Error error, uint32_t token);
+    void handleError(Error error, uint32_t requestId);
+
+    // Apply a response value to the register identified by a caller token
+    void applyValue(uint32_t token, uint16_t value);
 
 };
-#endif // __COMPORT2_H__
\ No newline at end of file
+#endif // __COMPORT2_H__
@@ -9,4 +9,66 @@
 
 #define ENABLE_DISPLAY
 
+// Telemetry: heap/stack sampling period and ring buffer length (60 x 5 s = 5 minutes)
+#define TELEMETRY_SAMPLE_INTERVAL_MS 5000
+#define TELEMETRY_SAMPLE_COUNT 60
+#define TELEMETRY_MAX_TASKS 6
+
+// Register history: tracked registers, raw delta blocks and rollup rings per register
+#define HISTORY_MAX_SERIES 4
+#define HISTORY_BLOCK_BYTES 240         // Encoded samples per raw block
+#define HISTORY_RAW_BLOCKS 8
+#define HISTORY_HEARTBEAT_MS 60000      // Store an unchanged value at least this often
+#define HISTORY_MINUTE_SLOTS 120        // 2 hours of 1-minute rollups
+#define HISTORY_HOUR_SLOTS 72           // 3 days of 1-hour rollups
+#define HISTORY_DAY_SLOTS 30            // 30 days of 1-day rollups
+
+// Value push: interval between WebSocket delta batches
+#define VALUE_PUSH_INTERVAL_MS 500
+
+// Warm start: register values restored at boot until COM2 has refreshed them
+#define WARM_START_RTC_INTERVAL_MS 1000      // Copy to RTC memory (survives soft resets)
+#define WARM_START_FLASH_INTERVAL_MS 900000  // Write to SPIFFS (survives power loss), 15 minutes
+#define WARM_START_RTC_MAX_SLOTS 1024        // RTC memory is small, larger sites use flash only
+
+// Configuration persistence: save once edits settle, but no later than the max delay
+#define CONFIG_SAVE_DELAY_MS 2000
+#define CONFIG_SAVE_MAX_DELAY_MS 10000
+#define CONFIG_JOURNAL_MAX_BYTES 8192   // Compact the journal into a new checkpoint above this
+#define CONFIG_STREAM_GROUP_MAX_BYTES 8192   // Largest single group in an import (its document fits the JSON pool)
+#define CONFIG_LEGACY_GROUP_MAX_BYTES 32768  // Largest single group in the JSON config file of earlier firmware (boot only)
+#define CONFIG_STAGING_WAIT_MS 200      // A change waits this long for readers to leave the previous configuration
+
+// Configuration capacity: the model lives in fixed pools of these sizes (see /api/capacity)
+// Sized for the largest Samsung site: 16 outdoor units with 256 indoor units between them
+#define MODBUS_MAX_GROUPS 16
+#define MODBUS_MAX_SLAVES 255            // Per group (every slave address)
+#define MODBUS_MAX_TOTAL_SLAVES 256      // Over all groups, the slaves share one arena
+#define MODBUS_MAX_GROUP_REGISTERS 64    // Group-level registers per group
+#define MODBUS_MAX_SLAVE_REGISTERS 64    // Registers per slave (per register template)
+#define MODBUS_MAX_SLAVE_VALUES 8192     // Slave register values over all groups (256 units with 32 each)
+#define MODBUS_MAX_TEMPLATES 32          // Register templates, including copies of slaves being edited
+#define MODBUS_MAX_SLOTS (MODBUS_MAX_GROUPS * MODBUS_MAX_GROUP_REGISTERS + MODBUS_MAX_SLAVE_VALUES)  // COM1 registers over all groups
+
+// Name arena: interned group, template and register names (16-bit offsets, so at most 64 KiB)
+#define NAME_POOL_CHUNK_BYTES 2048
+#define NAME_POOL_MAX_BYTES 65536
+
+// JSON documents: one arena reserved at boot (power of two), PSRAM when the board has it
+// A parsed document takes up to about 1.5 times its text, so the internal arena serves
+// the largest request body or import group (8 KB) with room for the small ones beside it
+#define JSON_POOL_BYTES 16384
+#define JSON_POOL_PSRAM_BYTES 262144
+#define JSON_POOL_MAX_DOCUMENTS 8       // API requests get 503 while this many documents exist
+
+// Configuration partition (see partitions.csv), emulated by a file on host builds
+#define CONFIG_PARTITION_LABEL "hvaccfg"
+#define CONFIG_PARTITION_SUBTYPE 0x40
+#define CONFIG_PARTITION_HOST_FILE "hvaccfg.bin"
+#define CONFIG_PARTITION_HOST_SIZE 0x20000
+
+// REST request bodies: largest JSON body accepted (413 above this)
+#define REQUEST_BODY_MAX_BYTES 8192
+#define BATCH_BODY_MAX_BYTES 8192       // /api/modbus/batch (about 100 operations, whole sites go through /api/modbus/import)
+
 #endif // __CONFIG_H__
\ No newline at end of file
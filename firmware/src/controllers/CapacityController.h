@@ -0,0 +1,42 @@
+#ifndef CAPACITY_CONTROLLER_H
+#define CAPACITY_CONTROLLER_H
+
+#include <ESPAsyncWebServer.h>
+#include "../webserver/JsonResponse.h"
+#include <ArduinoJson.h>
+#include "../services/ModbusService.h"
+
+/**
+ * CapacityController handles /api/capacity endpoints
+ */
+class CapacityController {
+public:
+    /**
+     * Register routes
+     */
+    static void registerRoutes(AsyncWebServer& server) {
+        // GET /api/capacity - Configuration size against the compile-time limits
+        server.on("/api/capacity", HTTP_GET, [](AsyncWebServerRequest *request) {
+            handleGetCapacity(request);
+        });
+    }
+    
+private:
+    /**
+     * GET /api/capacity
+     * Returns used, max and free for groups, slaves per group, registers per group and
+     * per slave, register templates and name bytes, plus the memory reserved for them
+     */
+    static void handleGetCapacity(AsyncWebServerRequest *request) {
+        JsonResponse* response = new JsonResponse();
+        
+        const auto capacity = ModbusService::getCapacity();
+        JsonObject obj = response->getRoot().as<JsonObject>();
+        capacity.toJson(obj);
+        
+        response->setLength();
+        request->send(response);
+    }
+};
+
+#endif // CAPACITY_CONTROLLER_H
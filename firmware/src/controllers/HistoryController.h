@@ -0,0 +1,194 @@
+#ifndef HISTORY_CONTROLLER_H
+#define HISTORY_CONTROLLER_H
+
+#include <ESPAsyncWebServer.h>
+#include "../webserver/JsonResponse.h"
+#include <ArduinoJson.h>
+#include <memory>
+#include "../services/HistoryService.h"
+#include "../services/ModbusService.h"
+#include "../webserver/HistorySource.h"
+
+/**
+ * HistoryController handles /api/history endpoints
+ */
+class HistoryController {
+public:
+    /**
+     * Register routes (sub-paths first, handlers also match URLs below their path)
+     */
+    static void registerRoutes(AsyncWebServer& server) {
+        // GET /api/history/series - List tracked registers
+        server.on("/api/history/series", HTTP_GET, [](AsyncWebServerRequest *request) {
+            handleGetSeries(request);
+        });
+        
+        // POST /api/history/series - Start tracking a register
+        server.on("/api/history/series", HTTP_POST, [](AsyncWebServerRequest *request) {
+            handlePostSeries(request);
+        });
+        
+        // DELETE /api/history/series - Stop tracking a register
+        server.on("/api/history/series", HTTP_DELETE, [](AsyncWebServerRequest *request) {
+            handleDeleteSeries(request);
+        });
+        
+        // GET /api/history - Stream the history of a register
+        server.on("/api/history", HTTP_GET, [](AsyncWebServerRequest *request) {
+            handleGetHistory(request);
+        });
+    }
+    
+private:
+    static void sendError(AsyncWebServerRequest *request, int code, const char* message) {
+        JsonResponse* response = new JsonResponse();
+        response->setCode(code);
+        response->getRoot()["error"] = message;
+        response->setLength();
+        request->send(response);
+    }
+    
+    /**
+     * Read group/slave/reg parameters into a token, returns false if group or reg is missing
+     */
+    static bool parseToken(AsyncWebServerRequest *request, uint32_t& token) {
+        if (!request->hasParam("group") || !request->hasParam("reg")) {
+            return false;
+        }
+        uint8_t groupId = request->getParam("group")->value().toInt();
+        uint8_t slaveId = request->hasParam("slave") ? request->getParam("slave")->value().toInt() : 0;
+        uint16_t regId = request->getParam("reg")->value().toInt();
+        token = HistoryService::makeToken(groupId, slaveId, regId);
+        return true;
+    }
+    
+    /**
+     * Check that the register addressed by a token is configured
+     */
+    static bool registerExists(uint32_t token) {
+        ModbusService::ReadGuard config;
+        auto* group = config.getGroup((token >> 24) & 0xFF);
+        if (!group) return false;
+        uint8_t slaveId = (token >> 16) & 0xFF;
+        if (slaveId == 0) {
+            return group->getRegister(token & 0xFFFF) != nullptr;
+        }
+        auto* slave = group->getSlave(slaveId);
+        return slave && slave->indexOf(token & 0xFFFF) >= 0;
+    }
+    
+    /**
+     * GET /api/history/series
+     * Returns tracked registers and how much history each holds
+     */
+    static void handleGetSeries(AsyncWebServerRequest *request) {
+        JsonResponse* response = new JsonResponse();
+        JsonObject obj = response->getRoot().as<JsonObject>();
+        obj["capacity"] = HISTORY_MAX_SERIES;
+        auto seriesArray = obj.createNestedArray("series");
+        
+        for (uint32_t token : HistoryService::getTrackedTokens()) {
+            uint32_t epoch = 0;
+            int slot = HistoryService::findSeries(token, epoch);
+            if (slot < 0) continue;
+            
+            auto entry = seriesArray.createNestedObject();
+            entry["group"] = (token >> 24) & 0xFF;
+            entry["slave"] = (token >> 16) & 0xFF;
+            entry["reg"] = token & 0xFFFF;
+            HistoryService::readSeries(slot, epoch, [&entry](const HistorySeries& s) {
+                entry["raw_samples"] = s.rawSampleCount();
+                entry["minutes"] = s.minutesWritten < HISTORY_MINUTE_SLOTS ? s.minutesWritten : HISTORY_MINUTE_SLOTS;
+                entry["hours"] = s.hoursWritten < HISTORY_HOUR_SLOTS ? s.hoursWritten : HISTORY_HOUR_SLOTS;
+                entry["days"] = s.daysWritten < HISTORY_DAY_SLOTS ? s.daysWritten : HISTORY_DAY_SLOTS;
+            });
+        }
+        
+        response->setLength();
+        request->send(response);
+    }
+    
+    /**
+     * POST /api/history/series?group={group-id}[&slave={slave-id}]&reg={register-id}
+     * Starts tracking a register
+     */
+    static void handlePostSeries(AsyncWebServerRequest *request) {
+        uint32_t token;
+        if (!parseToken(request, token)) {
+            sendError(request, 400, "Group ID and register ID are required");
+            return;
+        }
+        if (!registerExists(token)) {
+            sendError(request, 404, "Register not found");
+            return;
+        }
+        if (!HistoryService::track(token)) {
+            sendError(request, 400, "All history series are in use");
+            return;
+        }
+        
+        JsonResponse* response = new JsonResponse();
+        response->setCode(201);
+        response->getRoot()["message"] = "Register history enabled";
+        response->setLength();
+        request->send(response);
+    }
+    
+    /**
+     * DELETE /api/history/series?group={group-id}[&slave={slave-id}]&reg={register-id}
+     * Stops tracking a register and discards its history
+     */
+    static void handleDeleteSeries(AsyncWebServerRequest *request) {
+        uint32_t token;
+        if (!parseToken(request, token)) {
+            sendError(request, 400, "Group ID and register ID are required");
+            return;
+        }
+        if (!HistoryService::untrack(token)) {
+            sendError(request, 404, "Register is not tracked");
+            return;
+        }
+        
+        JsonResponse* response = new JsonResponse();
+        response->getRoot()["message"] = "Register history disabled";
+        response->setLength();
+        request->send(response);
+    }
+    
+    /**
+     * GET /api/history?group={group-id}[&slave={slave-id}]&reg={register-id}[&from={seconds}][&tier=raw,minute,hour,day]
+     * Streams raw samples and rollups newer than from (seconds since boot)
+     */
+    static void handleGetHistory(AsyncWebServerRequest *request) {
+        uint32_t token;
+        if (!parseToken(request, token)) {
+            sendError(request, 400, "Group ID and register ID are required");
+            return;
+        }
+        
+        uint32_t epoch = 0;
+        int slot = HistoryService::findSeries(token, epoch);
+        if (slot < 0) {
+            sendError(request, 404, "Register is not tracked");
+            return;
+        }
+        
+        uint32_t fromS = request->hasParam("from") ? request->getParam("from")->value().toInt() : 0;
+        
+        uint8_t tiers = HistorySource::TIER_RAW | HistorySource::TIER_MINUTE | HistorySource::TIER_HOUR |
+                        HistorySource::TIER_DAY;
+        if (request->hasParam("tier")) {
+            const String& tier = request->getParam("tier")->value();
+            tiers = 0;
+            if (tier.indexOf("raw") >= 0) tiers |= HistorySource::TIER_RAW;
+            if (tier.indexOf("minute") >= 0) tiers |= HistorySource::TIER_MINUTE;
+            if (tier.indexOf("hour") >= 0) tiers |= HistorySource::TIER_HOUR;
+            if (tier.indexOf("day") >= 0) tiers |= HistorySource::TIER_DAY;
+        }
+        
+        ChunkedSource::send(request, "application/json",
+                            std::make_shared<HistorySource>(token, slot, epoch, fromS, tiers));
+    }
+};
+
+#endif // HISTORY_CONTROLLER_H
@@ -2,10 +2,12 @@
 #define INTERFACES_CONTROLLER_H
 
 #include <ESPAsyncWebServer.h>
-#include <AsyncJson.h>
+#include "../webserver/JsonResponse.h"
 #include <ArduinoJson.h>
 #include "../services/InterfacesService.h"
+#include "../services/ModbusService.h"
 #include "../utils.h"
+#include "../webserver/RequestBody.h"
 
 /**
  * InterfacesController handles /api/interfaces endpoints
@@ -30,14 +32,12 @@ public:
     }
     
 private:
-    static String postData;
-    
     /**
      * GET /api/interfaces
      * Returns current UART interface settings
      */
     static void handleGetInterfaces(AsyncWebServerRequest *request) {
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         JsonObject obj = response->getRoot().as<JsonObject>();
         
         const auto& config = InterfacesService::getConfig();
@@ -51,13 +51,7 @@ private:
      * POST body handler for /api/interfaces
      */
     static void handlePostInterfacesBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-        if (index == 0) {
-            postData = "";
-        }
-        
-        for (size_t i = 0; i < len; i++) {
-            postData += (char)data[i];
-        }
+        RequestBody::collect(request, data, len, index, total);
     }
     
     /**
@@ -65,17 +59,21 @@ private:
      * Updates UART interface settings
      */
     static void handlePostInterfaces(AsyncWebServerRequest *request) {
-        DynamicJsonDocument doc(512);
-        DeserializationError error = deserializeJson(doc, postData);
+        size_t length = 0;
+        char* body = RequestBody::require(request, length);
+        if (!body) return;
+        
+        // Mutable input: parsed in place where the ArduinoJson version supports zero-copy
+        JsonPool::Document doc;
+        DeserializationError error = deserializeJson(doc, body, length);
         
         if (error) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             JsonObject obj = response->getRoot().as<JsonObject>();
             obj["error"] = "Invalid JSON";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         // Parse new configuration
@@ -83,31 +81,29 @@ private:
         InterfacesData newConfig = InterfacesData::fromJson(docObj);
         
         // Validate
-        if (!newConfig.uart1.isValid() || !newConfig.uart2.isValid()) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+        if (!newConfig.uart1.isValid() || !newConfig.uart2.isValid() || !newConfig.isTimeoutValid()) {
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             JsonObject obj = response->getRoot().as<JsonObject>();
             obj["error"] = "Invalid interface configuration";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
         // Update configuration
         if (!InterfacesService::updateConfig(newConfig)) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(500);
             JsonObject obj = response->getRoot().as<JsonObject>();
             obj["error"] = "Failed to save configuration";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
         // Success response
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         JsonObject obj = response->getRoot().as<JsonObject>();
         obj["message"] = "Settings saved successfully, device will restart to apply changes";
         
@@ -116,15 +112,11 @@ private:
         
         response->setLength();
         request->send(response);
-
-        postData = "";
         
-        // Restart device to apply new settings
+        // Restart device to apply new settings (pending Modbus changes are written first)
+        ModbusService::flush();
         utils::scheduleRestart(2000, "Applying new interface settings");
     }
 };
 
-// Static member initialization
-String InterfacesController::postData;
-
 #endif // INTERFACES_CONTROLLER_H
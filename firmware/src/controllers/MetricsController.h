@@ -0,0 +1,57 @@
+#ifndef METRICS_CONTROLLER_H
+#define METRICS_CONTROLLER_H
+
+#include <ESPAsyncWebServer.h>
+#include "../webserver/JsonResponse.h"
+#include <ArduinoJson.h>
+#include <memory>
+#include "../services/ModbusPollingService.h"
+#include "../webserver/PrometheusSource.h"
+
+/**
+ * MetricsController handles /api/metrics/* endpoints and the Prometheus /metrics scrape
+ */
+class MetricsController {
+public:
+    /**
+     * Register routes
+     */
+    static void registerRoutes(AsyncWebServer& server) {
+        // GET /api/metrics/poll - Polling cycle statistics
+        server.on("/api/metrics/poll", HTTP_GET, [](AsyncWebServerRequest *request) {
+            handleGetPollMetrics(request);
+        });
+        
+        // GET /metrics - Prometheus text exposition format
+        server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request) {
+            handleGetPrometheus(request);
+        });
+    }
+    
+private:
+    /**
+     * GET /api/metrics/poll
+     * Returns full cycle and per-group duration histograms, requests and bytes per cycle
+     */
+    static void handleGetPollMetrics(AsyncWebServerRequest *request) {
+        JsonResponse* response = new JsonResponse();
+        
+        const auto metrics = ModbusPollingService::getMetrics(true);
+        JsonObject obj = response->getRoot().as<JsonObject>();
+        metrics.toJson(obj, true);
+        
+        response->setLength();
+        request->send(response);
+    }
+    
+    /**
+     * GET /metrics
+     * Streams counters, gauges and histograms as a chunked response
+     */
+    static void handleGetPrometheus(AsyncWebServerRequest *request) {
+        ChunkedSource::send(request, "text/plain; version=0.0.4; charset=utf-8",
+                            std::make_shared<PrometheusSource>());
+    }
+};
+
+#endif // METRICS_CONTROLLER_H
@@ -2,10 +2,13 @@
 #define MODBUS_CONTROLLER_H
 
 #include <ESPAsyncWebServer.h>
-#include <AsyncJson.h>
+#include "../webserver/JsonResponse.h"
 #include <ArduinoJson.h>
 #include "../services/ModbusService.h"
-#include "../services/RegisterMappingService.h"
+#include "../webserver/ConfigETag.h"
+#include "../webserver/ConfigImport.h"
+#include "../webserver/RequestBody.h"
+#include "../webserver/GroupsSource.h"
 
 /**
  * ModbusController handles /api/modbus/* endpoints
@@ -34,19 +37,16 @@ public:
         // PATCH /api/modbus/group/update - Update group
         server.on("/api/modbus/group/update", HTTP_PATCH, [](AsyncWebServerRequest *request) {
             handleUpdateGroup(request);
-            RegisterMappingService::buildMapping();
         });
         
         // DELETE /api/modbus/group/delete - Delete group
         server.on("/api/modbus/group/delete", HTTP_DELETE, [](AsyncWebServerRequest *request) {
             handleDeleteGroup(request);
-            RegisterMappingService::buildMapping();
         });
         
         // POST /api/modbus/group/update/register - Add register
         server.on("/api/modbus/group/update/register", HTTP_POST, [](AsyncWebServerRequest *request) {
             handlePostRegister(request);
-            RegisterMappingService::buildMapping();
         }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
             handlePostRegisterBody(request, data, len, index, total);
         });
@@ -54,37 +54,41 @@ public:
         // PATCH /api/modbus/group/update/register - Update register
         server.on("/api/modbus/group/update/register", HTTP_PATCH, [](AsyncWebServerRequest *request) {
             handlePatchRegister(request);
-            RegisterMappingService::buildMapping();
         }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
             handlePatchRegisterBody(request, data, len, index, total);
         });
         
+        // POST /api/modbus/batch - Apply a list of operations, saved and remapped once
+        server.on("/api/modbus/batch", HTTP_POST, [](AsyncWebServerRequest *request) {
+            handleBatch(request);
+        }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            RequestBody::collect(request, data, len, index, total, BATCH_BODY_MAX_BYTES);
+        });
+        
+        // POST /api/modbus/import - Replace the configuration with a JSON export
+        server.on("/api/modbus/import", HTTP_POST, [](AsyncWebServerRequest *request) {
+            handleImport(request);
+        }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            ConfigImport::collect(request, data, len, index, total);
+        });
+        
         // DELETE /api/modbus/group/update/register - Delete register
         server.on("/api/modbus/group/update/register", HTTP_DELETE, [](AsyncWebServerRequest *request) {
             handleDeleteRegister(request);
-            RegisterMappingService::buildMapping();
         });
     }
     
 private:
-    static String postData;
-    
     /**
      * GET /api/modbus/groups
-     * Returns all groups without register values
+     * Returns all groups without register values (streamed, ETag/304 per configuration generation)
      */
     static void handleGetGroups(AsyncWebServerRequest *request) {
-        AsyncJsonResponse* response = new AsyncJsonResponse();
-        
-        JsonArray root = response->getRoot().to<JsonArray>();
-        
-        const auto& groups = ModbusService::getGroups();
-        for (const auto& group : groups) {
-            auto groupObj = root.createNestedObject();
-            group.toJson(groupObj, false);  // Without values
-        }
+        if (ConfigETag::sendNotModified(request)) return;
         
-        response->setLength();
+        AsyncWebServerResponse* response = ChunkedSource::beginResponse(request, "application/json",
+            std::make_shared<GroupsSource>(false));  // Without values
+        ConfigETag::addHeaders(response);
         request->send(response);
     }
     
@@ -94,7 +98,7 @@ private:
      */
     static void handleGetGroup(AsyncWebServerRequest *request) {
         if (!request->hasParam("id")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Group ID is required";
             response->setLength();
@@ -103,10 +107,19 @@ private:
         }
         
         uint8_t groupId = request->getParam("id")->value().toInt();
-        auto* group = ModbusService::getGroup(groupId);
+        size_t index = 0;
+        bool found = false;
+        {
+            ModbusService::ReadGuard config;
+            const auto& groups = config.groups();
+            while (index < groups.size() && groups[index].id != groupId) {
+                index++;
+            }
+            found = index < groups.size();
+        }
         
-        if (!group) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+        if (!found) {
+            JsonResponse* response = new JsonResponse();
             response->setCode(404);
             response->getRoot()["error"] = "Group not found";
             response->setLength();
@@ -114,11 +127,8 @@ private:
             return;
         }
         
-        AsyncJsonResponse* response = new AsyncJsonResponse();
-        JsonObject obj = response->getRoot().as<JsonObject>();
-        group->toJson(obj, true);  // With values
-        response->setLength();
-        request->send(response);
+        ChunkedSource::send(request, "application/json",
+            std::make_shared<GroupsSource>(index, true));  // With values
     }
     
     /**
@@ -127,7 +137,7 @@ private:
      */
     static void handleCreateGroup(AsyncWebServerRequest *request) {
         if (!request->hasParam("id")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Group ID is required";
             response->setLength();
@@ -137,7 +147,7 @@ private:
         
         uint8_t groupId = request->getParam("id")->value().toInt();
         uint8_t remoteAddress = groupId; // Default to same as local ID
-        uint8_t slaveCount = 0;
+        long slaveCount = 0;             // Not truncated, 256 must not become 0
         
         if (request->hasParam("remote")) {
             remoteAddress = request->getParam("remote")->value().toInt();
@@ -147,22 +157,34 @@ private:
             slaveCount = request->getParam("slave")->value().toInt();
         }
         
+        if (slaveCount < 0 || slaveCount > MODBUS_MAX_SLAVES) {
+            JsonResponse* response = new JsonResponse();
+            response->setCode(400);
+            response->getRoot()["error"] = "Slave limit reached";
+            response->setLength();
+            request->send(response);
+            return;
+        }
+        
         if (!ModbusService::createGroup(groupId, slaveCount, remoteAddress)) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
-            response->getRoot()["error"] = "Failed to create group (may already exist)";
+            response->getRoot()["error"] = "Failed to create group (may already exist, or group or slave limit reached)";
             response->setLength();
             request->send(response);
             return;
         }
         
-        auto* group = ModbusService::getGroup(groupId);
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         response->setCode(201);
         JsonObject obj = response->getRoot().as<JsonObject>();
         obj["message"] = "Group created successfully";
         auto dataObj = obj.createNestedObject("data");
-        group->toJson(dataObj, true);
+        {
+            ModbusService::ReadGuard config;
+            auto* group = config.getGroup(groupId);
+            if (group) group->toJson(dataObj, true);
+        }
         response->setLength();
         request->send(response);
     }
@@ -173,7 +195,7 @@ private:
      */
     static void handleUpdateGroup(AsyncWebServerRequest *request) {
         if (!request->hasParam("id") || !request->hasParam("slave")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Group ID and slave count are required";
             response->setLength();
@@ -182,13 +204,22 @@ private:
         }
         
         uint8_t groupId = request->getParam("id")->value().toInt();
-        uint8_t slaveCount = request->getParam("slave")->value().toInt();
+        long slaveCount = request->getParam("slave")->value().toInt();  // Not truncated, 256 must not become 0
+        
+        if (slaveCount < 0 || slaveCount > MODBUS_MAX_SLAVES) {
+            JsonResponse* response = new JsonResponse();
+            response->setCode(400);
+            response->getRoot()["error"] = "Slave limit reached";
+            response->setLength();
+            request->send(response);
+            return;
+        }
         
         // Update local ID if provided
         if (request->hasParam("newid")) {
             uint8_t newId = request->getParam("newid")->value().toInt();
             if (!ModbusService::updateGroupLocalId(groupId, newId)) {
-                AsyncJsonResponse* response = new AsyncJsonResponse();
+                JsonResponse* response = new JsonResponse();
                 response->setCode(400);
                 response->getRoot()["error"] = "Failed to update local ID (may already exist)";
                 response->setLength();
@@ -202,7 +233,7 @@ private:
         if (request->hasParam("remote")) {
             uint8_t remoteAddress = request->getParam("remote")->value().toInt();
             if (!ModbusService::updateGroupRemoteAddress(groupId, remoteAddress)) {
-                AsyncJsonResponse* response = new AsyncJsonResponse();
+                JsonResponse* response = new JsonResponse();
                 response->setCode(404);
                 response->getRoot()["error"] = "Group not found";
                 response->setLength();
@@ -212,7 +243,7 @@ private:
         }
         
         if (!ModbusService::updateGroup(groupId, slaveCount)) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(404);
             response->getRoot()["error"] = "Group not found";
             response->setLength();
@@ -220,7 +251,7 @@ private:
             return;
         }
         
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         response->getRoot()["message"] = "Group updated successfully";
         response->setLength();
         request->send(response);
@@ -232,7 +263,7 @@ private:
      */
     static void handleDeleteGroup(AsyncWebServerRequest *request) {
         if (!request->hasParam("id")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Group ID is required";
             response->setLength();
@@ -243,7 +274,7 @@ private:
         uint8_t groupId = request->getParam("id")->value().toInt();
         
         if (!ModbusService::deleteGroup(groupId)) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(404);
             response->getRoot()["error"] = "Group not found";
             response->setLength();
@@ -251,7 +282,7 @@ private:
             return;
         }
         
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         response->getRoot()["message"] = "Group deleted successfully";
         response->setLength();
         request->send(response);
@@ -261,12 +292,7 @@ private:
      * POST body handler
      */
     static void handlePostRegisterBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-        if (index == 0) {
-            postData = "";
-        }
-        for (size_t i = 0; i < len; i++) {
-            postData += (char)data[i];
-        }
+        RequestBody::collect(request, data, len, index, total);
     }
     
     /**
@@ -275,81 +301,78 @@ private:
      */
     static void handlePostRegister(AsyncWebServerRequest *request) {
         if (!request->hasParam("id")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Group ID is required";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
-        DynamicJsonDocument doc(256);
-        DeserializationError error = deserializeJson(doc, postData);
+        size_t length = 0;
+        char* body = RequestBody::require(request, length);
+        if (!body) return;
+        
+        // Mutable input: parsed in place where the ArduinoJson version supports zero-copy
+        JsonPool::Document doc;
+        DeserializationError error = deserializeJson(doc, body, length);
         
         if (error) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Invalid JSON";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
         JsonObject docObj = doc.as<JsonObject>();
         if (!docObj.containsKey("id") || !docObj.containsKey("name")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Register ID and name are required";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
         uint8_t groupId = request->getParam("id")->value().toInt();
-        Register reg(docObj["id"], docObj["name"].as<String>());
+        uint16_t regId = docObj["id"];
+        String name = docObj["name"].as<String>();
         
         bool success = false;
         if (request->hasParam("slave")) {
             uint8_t slaveId = request->getParam("slave")->value().toInt();
-            success = ModbusService::addSlaveRegister(groupId, slaveId, reg);
+            success = ModbusService::addSlaveRegister(groupId, slaveId, regId, name);
         } else {
-            success = ModbusService::addGroupRegister(groupId, reg);
+            success = ModbusService::addGroupRegister(groupId, regId, name);
         }
         
         if (!success) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
-            response->getRoot()["error"] = "Failed to add register (duplicate ID or invalid group/slave)";
+            response->getRoot()["error"] = "Failed to add register (duplicate ID, register limit reached, name storage full or invalid group/slave)";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         response->setCode(201);
         JsonObject obj = response->getRoot().as<JsonObject>();
         obj["message"] = "Register added successfully";
         auto regObj = obj.createNestedObject("register");
+        Register reg(regId, name);  // Interned by the change already
         reg.toJson(regObj);
         response->setLength();
         request->send(response);
-        postData = "";
     }
     
     /**
      * PATCH body handler
      */
     static void handlePatchRegisterBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-        if (index == 0) {
-            postData = "";
-        }
-        for (size_t i = 0; i < len; i++) {
-            postData += (char)data[i];
-        }
+        RequestBody::collect(request, data, len, index, total);
     }
     
     /**
@@ -358,36 +381,38 @@ private:
      */
     static void handlePatchRegister(AsyncWebServerRequest *request) {
         if (!request->hasParam("id")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Group ID is required";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
-        DynamicJsonDocument doc(256);
-        DeserializationError error = deserializeJson(doc, postData);
+        size_t length = 0;
+        char* body = RequestBody::require(request, length);
+        if (!body) return;
+        
+        // Mutable input: parsed in place where the ArduinoJson version supports zero-copy
+        JsonPool::Document doc;
+        DeserializationError error = deserializeJson(doc, body, length);
         
         if (error) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Invalid JSON";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
         JsonObject docObj = doc.as<JsonObject>();
         if (!docObj.containsKey("id") || !docObj.containsKey("name")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Register ID and name are required";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
@@ -405,16 +430,15 @@ private:
         }
         
         if (!success) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
-            response->getRoot()["error"] = "Failed to update register (not found or duplicate ID)";
+            response->getRoot()["error"] = "Failed to update register (not found, duplicate ID or name storage full)";
             response->setLength();
             request->send(response);
-            postData = "";
             return;
         }
         
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         JsonObject obj = response->getRoot().as<JsonObject>();
         obj["message"] = "Register updated successfully";
         auto regObj = obj.createNestedObject("register");
@@ -422,7 +446,93 @@ private:
         regObj["name"] = newName;
         response->setLength();
         request->send(response);
-        postData = "";
+    }
+    
+    /**
+     * POST /api/modbus/batch
+     * Body: {"operations":[{"op":"create_group",...},...]} (see ConfigOperation)
+     * All operations are validated against a copy of the configuration and applied together
+     */
+    static void handleBatch(AsyncWebServerRequest *request) {
+        size_t length = 0;
+        char* body = RequestBody::require(request, length, BATCH_BODY_MAX_BYTES);
+        if (!body) return;
+        
+        std::vector<ConfigOperation> operations;
+        {
+            // From the JSON pool; the document is released before the copy is made
+            JsonPool::Document doc;
+            DeserializationError error = deserializeJson(doc, body, length);
+            JsonArray array = doc["operations"].as<JsonArray>();
+            
+            if (error || array.isNull()) {
+                JsonResponse* response = new JsonResponse();
+                response->setCode(400);
+                response->getRoot()["error"] = "Invalid JSON, expected {\"operations\":[...]}";
+                response->setLength();
+                request->send(response);
+                return;
+            }
+            
+            operations.reserve(array.size());
+            for (JsonObject opObj : array) {
+                operations.push_back(ConfigOperation::fromJson(opObj));
+            }
+        }
+        
+        size_t failedIndex = 0;
+        const char* error = nullptr;
+        if (!ModbusService::applyBatch(operations, failedIndex, error)) {
+            JsonResponse* response = new JsonResponse();
+            bool busy = failedIndex == ModbusService::BATCH_BUSY;
+            response->setCode(busy ? 409 : 400);
+            JsonObject obj = response->getRoot().as<JsonObject>();
+            obj["error"] = error;
+            if (!busy) {
+                obj["index"] = failedIndex;
+            }
+            response->setLength();
+            request->send(response);
+            return;
+        }
+        
+        JsonResponse* response = new JsonResponse();
+        JsonObject obj = response->getRoot().as<JsonObject>();
+        obj["message"] = "Batch applied successfully";
+        obj["applied"] = operations.size();
+        response->setLength();
+        request->send(response);
+    }
+    
+    /**
+     * POST /api/modbus/import
+     * Body: the array returned by GET /api/modbus/groups, or {"groups":[...]}
+     * Storage is binary; this is the JSON way in (GET /api/modbus/groups is the way out)
+     * The body is parsed group by group while it arrives (see ConfigImport), so there is
+     * no size limit beyond CONFIG_STREAM_GROUP_MAX_BYTES per group (and the MODBUS_MAX_* limits)
+     */
+    static void handleImport(AsyncWebServerRequest *request) {
+        GroupList* groups = ConfigImport::take(request);
+        if (!groups) return;
+        
+        const char* error = nullptr;
+        bool replaced = ModbusService::replaceGroups(*groups, error);
+        ConfigImport::release();
+        if (!replaced) {
+            JsonResponse* response = new JsonResponse();
+            response->setCode(400);
+            response->getRoot()["error"] = error;
+            response->setLength();
+            request->send(response);
+            return;
+        }
+        
+        JsonResponse* response = new JsonResponse();
+        JsonObject obj = response->getRoot().as<JsonObject>();
+        obj["message"] = "Configuration imported successfully";
+        obj["groups"] = ModbusService::getGroupCount();
+        response->setLength();
+        request->send(response);
     }
     
     /**
@@ -431,7 +541,7 @@ private:
      */
     static void handleDeleteRegister(AsyncWebServerRequest *request) {
         if (!request->hasParam("id") || !request->hasParam("registerId")) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(400);
             response->getRoot()["error"] = "Group ID and Register ID are required";
             response->setLength();
@@ -451,7 +561,7 @@ private:
         }
         
         if (!success) {
-            AsyncJsonResponse* response = new AsyncJsonResponse();
+            JsonResponse* response = new JsonResponse();
             response->setCode(404);
             response->getRoot()["error"] = "Register not found";
             response->setLength();
@@ -459,14 +569,11 @@ private:
             return;
         }
         
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         response->getRoot()["message"] = "Register deleted successfully";
         response->setLength();
         request->send(response);
     }
 };
 
-// Static member initialization
-String ModbusController::postData;
-
 #endif // MODBUS_CONTROLLER_H
@@ -2,7 +2,7 @@
 #define STATUS_CONTROLLER_H
 
 #include <ESPAsyncWebServer.h>
-#include <AsyncJson.h>
+#include "../webserver/JsonResponse.h"
 #include <ArduinoJson.h>
 #include "../services/StatusService.h"
 
@@ -27,7 +27,7 @@ private:
      * Returns current system status and statistics
      */
     static void handleGetStatus(AsyncWebServerRequest *request) {
-        AsyncJsonResponse* response = new AsyncJsonResponse();
+        JsonResponse* response = new JsonResponse();
         
         const auto& status = StatusService::getStatus();
         JsonObject obj = response->getRoot().as<JsonObject>();
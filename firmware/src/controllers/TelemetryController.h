@@ -0,0 +1,45 @@
+#ifndef TELEMETRY_CONTROLLER_H
+#define TELEMETRY_CONTROLLER_H
+
+#include <ESPAsyncWebServer.h>
+#include "../webserver/JsonResponse.h"
+#include <ArduinoJson.h>
+#include "../services/TelemetryService.h"
+
+/**
+ * TelemetryController handles /api/telemetry endpoints
+ */
+class TelemetryController {
+public:
+    /**
+     * Register routes
+     */
+    static void registerRoutes(AsyncWebServer& server) {
+        // GET /api/telemetry - Heap, fragmentation, task stacks and allocation attribution
+        server.on("/api/telemetry", HTTP_GET, [](AsyncWebServerRequest *request) {
+            handleGetTelemetry(request);
+        });
+    }
+    
+private:
+    /**
+     * GET /api/telemetry[?samples=1]
+     * Returns current heap values, ring buffer minimum and trend, stack high-water marks
+     * and per-subsystem heap growth; samples=1 adds the raw ring buffer
+     */
+    static void handleGetTelemetry(AsyncWebServerRequest *request) {
+        bool withSamples = request->hasParam("samples") &&
+                           request->getParam("samples")->value() == "1";
+        
+        JsonResponse* response = new JsonResponse();
+        
+        const auto telemetry = TelemetryService::getTelemetry(withSamples);
+        JsonObject obj = response->getRoot().as<JsonObject>();
+        telemetry.toJson(obj);
+        
+        response->setLength();
+        request->send(response);
+    }
+};
+
+#endif // TELEMETRY_CONTROLLER_H
@@ -0,0 +1,101 @@
+#ifndef VALUES_CONTROLLER_H
+#define VALUES_CONTROLLER_H
+
+#include <ESPAsyncWebServer.h>
+#include <vector>
+#include "../services/ValueSyncService.h"
+#include "../services/RegisterMappingService.h"
+
+/**
+ * ValuesController handles /api/values: every register value in one compact binary response
+ *
+ * Little-endian layout:
+ *   u8  format (1)
+ *   u8  flags (bit 0: delta)
+ *   u16 slot count
+ *   u32 layout generation
+ *   u32 version
+ *   full:  u16 value per slot, in slot (COM1 address) order
+ *   delta: u16 entry count, then u16 slot + u16 value per changed slot
+ *
+ * A delta is only sent when the client's layout matches and it is smaller than a full dump.
+ */
+class ValuesController {
+public:
+    static constexpr uint8_t FORMAT = 1;
+    static constexpr uint8_t FLAG_DELTA = 0x01;
+    
+    /**
+     * Register routes
+     */
+    static void registerRoutes(AsyncWebServer& server) {
+        // GET /api/values[?since={version}&layout={generation}] - All values, or changes since a version
+        server.on("/api/values", HTTP_GET, [](AsyncWebServerRequest *request) {
+            handleGetValues(request);
+        });
+    }
+    
+private:
+    static void putU16(AsyncResponseStream* out, uint16_t v) {
+        uint8_t b[2] = { (uint8_t)(v & 0xFF), (uint8_t)(v >> 8) };
+        out->write(b, 2);
+    }
+    
+    static void putU32(AsyncResponseStream* out, uint32_t v) {
+        uint8_t b[4] = { (uint8_t)(v & 0xFF), (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+        out->write(b, 4);
+    }
+    
+    /**
+     * GET /api/values[?since={version}&layout={generation}]
+     */
+    static void handleGetValues(AsyncWebServerRequest *request) {
+        uint32_t since = request->hasParam("since") ? request->getParam("since")->value().toInt() : 0;
+        uint32_t layout = request->hasParam("layout") ? request->getParam("layout")->value().toInt() : 0;
+        
+        uint32_t currentLayout = ValueSyncService::getLayoutGeneration();
+        size_t slotCount = RegisterMappingService::getSlotCount();
+        
+        // Changed slots and the version they are consistent with
+        std::vector<uint16_t> changed;
+        uint32_t version = ValueSyncService::getVersion();
+        // A version from the future was seen before a reboot: the client gets everything
+        bool delta = since != 0 && since <= version && layout == currentLayout;
+        if (delta) {
+            version = ValueSyncService::forEachChangedSince(since, [&changed](uint16_t slot) {
+                changed.push_back(slot);
+            });
+            delta = 2 + changed.size() * 4 < slotCount * 2;
+        }
+        
+        size_t bodySize = 12 + (delta ? 2 + changed.size() * 4 : slotCount * 2);
+        AsyncResponseStream* response = request->beginResponseStream("application/octet-stream", bodySize);
+        response->addHeader("Cache-Control", "no-store");
+        
+        response->write(FORMAT);
+        response->write((uint8_t)(delta ? FLAG_DELTA : 0));
+        putU16(response, slotCount);
+        putU32(response, currentLayout);
+        putU32(response, version);
+        
+        if (delta) {
+            putU16(response, changed.size());
+            for (uint16_t slot : changed) {
+                uint16_t value = 0;
+                RegisterMappingService::readSlot(slot, value);
+                putU16(response, slot);
+                putU16(response, value);
+            }
+        } else {
+            for (size_t slot = 0; slot < slotCount; slot++) {
+                uint16_t value = 0;
+                RegisterMappingService::readSlot(slot, value);
+                putU16(response, value);
+            }
+        }
+        
+        request->send(response);
+    }
+};
+
+#endif // VALUES_CONTROLLER_H
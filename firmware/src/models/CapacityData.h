@@ -0,0 +1,87 @@
+#ifndef CAPACITY_DATA_H
+#define CAPACITY_DATA_H
+
+#include <ArduinoJson.h>
+
+/**
+ * CapacityData compares the configuration with the compile-time limits in config.h
+ * Per-group and per-slave limits report the largest group or template, since that
+ * is the one that runs out first
+ */
+class CapacityData {
+public:
+    uint32_t groups;                // Groups configured
+    uint32_t maxGroups;
+    uint32_t largestSlaveCount;     // Slaves in the largest group
+    uint32_t maxSlaves;
+    uint32_t slaves;                // Slaves over all groups
+    uint32_t maxTotalSlaves;
+    uint32_t slaveValues;           // Slave register values over all groups
+    uint32_t maxSlaveValues;
+    uint32_t largestGroupRegisters; // Group-level registers in the largest group
+    uint32_t maxGroupRegisters;
+    uint32_t largestTemplate;       // Registers in the largest slave template
+    uint32_t maxSlaveRegisters;
+    uint32_t templatesUsed;         // Template pool blocks in use (configuration and edits)
+    uint32_t templatesPeak;
+    uint32_t maxTemplates;
+    uint32_t templatesRejected;     // Edits refused because every template block was in use
+    uint32_t nameBytes;             // Name arena in use
+    uint32_t nameCapacity;
+    uint32_t namesRejected;         // New names refused because the arena was full (until reboot)
+    uint32_t registers;             // Register slots over all groups
+    uint32_t staticBytes;           // Memory reserved for the configuration pools and the register mapping
+    bool stagingInUse;              // A batch or import holds the staging copy
+    bool storageRejected;           // The stored configuration failed to load and is not saved over
+
+    CapacityData()
+        : groups(0), maxGroups(0), largestSlaveCount(0), maxSlaves(0), slaves(0), maxTotalSlaves(0),
+          slaveValues(0), maxSlaveValues(0), largestGroupRegisters(0), maxGroupRegisters(0),
+          largestTemplate(0), maxSlaveRegisters(0), templatesUsed(0), templatesPeak(0), maxTemplates(0),
+          templatesRejected(0), nameBytes(0), nameCapacity(0), namesRejected(0), registers(0), staticBytes(0),
+          stagingInUse(false), storageRejected(false) {}
+
+    // Serialize to JSON, every limit as {"used", "max", "free"}
+    void toJson(JsonObject& obj) const {
+        auto groupsObj = obj.createNestedObject("groups");
+        limitToJson(groupsObj, groups, maxGroups);
+
+        auto slavesObj = obj.createNestedObject("slaves_per_group");
+        limitToJson(slavesObj, largestSlaveCount, maxSlaves);
+
+        auto totalSlavesObj = obj.createNestedObject("slaves");
+        limitToJson(totalSlavesObj, slaves, maxTotalSlaves);
+
+        auto slaveValuesObj = obj.createNestedObject("slave_values");
+        limitToJson(slaveValuesObj, slaveValues, maxSlaveValues);
+
+        auto groupRegistersObj = obj.createNestedObject("group_registers");
+        limitToJson(groupRegistersObj, largestGroupRegisters, maxGroupRegisters);
+
+        auto slaveRegistersObj = obj.createNestedObject("slave_registers");
+        limitToJson(slaveRegistersObj, largestTemplate, maxSlaveRegisters);
+
+        auto templatesObj = obj.createNestedObject("templates");
+        limitToJson(templatesObj, templatesUsed, maxTemplates);
+        templatesObj["peak"] = templatesPeak;
+        templatesObj["rejected"] = templatesRejected;
+
+        auto namesObj = obj.createNestedObject("name_bytes");
+        limitToJson(namesObj, nameBytes, nameCapacity);
+        namesObj["rejected"] = namesRejected;
+
+        obj["registers"] = registers;
+        obj["static_bytes"] = staticBytes;
+        obj["staging_in_use"] = stagingInUse;
+        obj["storage_rejected"] = storageRejected;
+    }
+
+private:
+    static void limitToJson(JsonObject& obj, uint32_t used, uint32_t max) {
+        obj["used"] = used;
+        obj["max"] = max;
+        obj["free"] = used < max ? max - used : 0;
+    }
+};
+
+#endif // CAPACITY_DATA_H
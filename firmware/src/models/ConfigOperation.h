@@ -0,0 +1,297 @@
+#ifndef CONFIG_OPERATION_H
+#define CONFIG_OPERATION_H
+
+#include <ArduinoJson.h>
+#include <vector>
+#include "Group.h"
+#include "../services/NamePool.h"
+#include "../services/TemplatePool.h"
+
+/**
+ * ConfigOperation is one step of a configuration change
+ * (a batch request entry, and the record format of the configuration journal)
+ *
+ * Mirrors the single-item REST endpoints:
+ *   {"op":"create_group","id":1,"slaves":2,"remote":1}
+ *   {"op":"update_group","id":1,"new_id":3,"slaves":4,"remote":5}   (all but id optional)
+ *   {"op":"delete_group","id":1}
+ *   {"op":"add_register","group":1,"slave":2,"id":100,"name":"Temp"} (slave optional)
+ *   {"op":"update_register","group":1,"slave":2,"id":100,"new_id":101,"name":"Temp"}
+ *   {"op":"delete_register","group":1,"slave":2,"id":100}
+ */
+class ConfigOperation {
+public:
+    enum Type : uint8_t {
+        INVALID,
+        CREATE_GROUP,
+        UPDATE_GROUP,
+        DELETE_GROUP,
+        ADD_REGISTER,
+        UPDATE_REGISTER,
+        DELETE_REGISTER
+    };
+    
+    Type type;
+    uint8_t groupId;
+    uint8_t slaveId;        // 0 = group-level register
+    uint16_t id;            // Group ID or register ID, depending on the operation
+    uint16_t newId;
+    bool hasNewId;
+    int16_t slaveCount;     // -1 = unchanged
+    int16_t remote;         // -1 = unchanged / default to the group ID
+    String name;
+    
+    ConfigOperation() : type(INVALID), groupId(0), slaveId(0), id(0), newId(0), hasNewId(false),
+                        slaveCount(-1), remote(-1) {}
+    
+    ConfigOperation(Type type, uint8_t groupId, uint8_t slaveId = 0, uint16_t id = 0)
+        : type(type), groupId(groupId), slaveId(slaveId), id(id), newId(0), hasNewId(false),
+          slaveCount(-1), remote(-1) {}
+    
+    void setNewId(uint16_t value) {
+        newId = value;
+        hasNewId = true;
+    }
+    
+    // Serialize to JSON (inverse of fromJson)
+    void toJson(JsonObject& obj) const {
+        switch (type) {
+            case CREATE_GROUP:
+            case UPDATE_GROUP:
+            case DELETE_GROUP:
+                obj["op"] = type == CREATE_GROUP ? "create_group" : type == UPDATE_GROUP ? "update_group" : "delete_group";
+                obj["id"] = groupId;
+                if (hasNewId) obj["new_id"] = newId;
+                if (slaveCount >= 0) obj["slaves"] = slaveCount;
+                if (remote >= 0) obj["remote"] = remote;
+                break;
+            
+            case ADD_REGISTER:
+            case UPDATE_REGISTER:
+            case DELETE_REGISTER:
+                obj["op"] = type == ADD_REGISTER ? "add_register" : type == UPDATE_REGISTER ? "update_register" : "delete_register";
+                obj["group"] = groupId;
+                if (slaveId != 0) obj["slave"] = slaveId;
+                obj["id"] = id;
+                if (hasNewId) obj["new_id"] = newId;
+                if (type != DELETE_REGISTER) obj["name"] = name;
+                break;
+            
+            case INVALID:
+            default:
+                obj["op"] = "invalid";
+                break;
+        }
+    }
+    
+    // Deserialize from JSON, type stays INVALID for unknown operations, missing fields
+    // or values out of range (never truncated: 256 slaves must not become 0)
+    static ConfigOperation fromJson(const JsonObject& obj) {
+        ConfigOperation op;
+        String opName = obj["op"] | "";
+        
+        if (opName == "create_group" || opName == "update_group" || opName == "delete_group") {
+            long groupId = readField(obj, "id", 1, 255);
+            long slaveCount = readField(obj, "slaves", 0, MODBUS_MAX_SLAVES);
+            long remote = readField(obj, "remote", 0, 255);
+            long newId = readField(obj, "new_id", 1, 255);
+            if (groupId < 0 || slaveCount == OUT_OF_RANGE || remote == OUT_OF_RANGE ||
+                newId == OUT_OF_RANGE) {
+                return op;
+            }
+            
+            op.groupId = groupId;
+            op.id = op.groupId;
+            if (slaveCount != MISSING) op.slaveCount = slaveCount;
+            if (remote != MISSING) op.remote = remote;
+            if (newId != MISSING) op.setNewId(newId);
+            
+            if (opName == "create_group") op.type = CREATE_GROUP;
+            else if (opName == "update_group") op.type = UPDATE_GROUP;
+            else op.type = DELETE_GROUP;
+            return op;
+        }
+        
+        if (opName == "add_register" || opName == "update_register" || opName == "delete_register") {
+            long groupId = readField(obj, "group", 1, 255);
+            long slaveId = readField(obj, "slave", 0, 255);
+            long id = readField(obj, "id", 0, 65535);
+            long newId = readField(obj, "new_id", 0, 65535);
+            if (groupId < 0 || id < 0 || slaveId == OUT_OF_RANGE || newId == OUT_OF_RANGE) return op;
+            
+            op.groupId = groupId;
+            op.slaveId = slaveId == MISSING ? 0 : slaveId;
+            op.id = id;
+            if (newId != MISSING) op.setNewId(newId);
+            
+            if (opName != "delete_register") {
+                if (!obj.containsKey("name")) return op;
+                op.name = obj["name"].as<String>();
+            }
+            
+            if (opName == "add_register") op.type = ADD_REGISTER;
+            else if (opName == "update_register") op.type = UPDATE_REGISTER;
+            else op.type = DELETE_REGISTER;
+        }
+        
+        return op;
+    }
+    
+    /**
+     * Apply to a list of groups, returns false (with a reason) if the operation does not fit
+     * On failure the list may be partially modified, callers apply batches to a copy
+     */
+    bool apply(GroupList& groups, const char*& error) const {
+        // The pools refuse without a reason of their own: a template copy for a slave
+        // edit, or a new name (which would otherwise be stored and saved empty)
+        uint32_t templatesRejected = TemplatePool::getRejectedCount();
+        uint32_t namesRejected = NamePool::getRejectedCount();
+        bool ok = applyTo(groups, error);
+        if (!ok && TemplatePool::getRejectedCount() != templatesRejected) {
+            error = "Template limit reached";
+        }
+        if (ok && NamePool::getRejectedCount() != namesRejected) {
+            error = "Name storage full";
+            ok = false;
+        }
+        return ok;
+    }
+
+private:
+    static constexpr long MISSING = -1;
+    static constexpr long OUT_OF_RANGE = -2;
+    
+    // Integer field within min..max, MISSING if absent, OUT_OF_RANGE otherwise (also for non-integers)
+    static long readField(const JsonObject& obj, const char* key, long min, long max) {
+        if (!obj.containsKey(key)) return MISSING;
+        if (!obj[key].is<long>()) return OUT_OF_RANGE;
+        long value = obj[key].as<long>();
+        return value >= min && value <= max ? value : OUT_OF_RANGE;
+    }
+    
+    bool applyTo(GroupList& groups, const char*& error) const {
+        Group* group = findGroup(groups, groupId);
+        
+        switch (type) {
+            case CREATE_GROUP: {
+                if (group) {
+                    error = "Group already exists";
+                    return false;
+                }
+                if (groups.full()) {
+                    error = "Group limit reached";
+                    return false;
+                }
+                if (slaveCount > MODBUS_MAX_SLAVES) {
+                    error = "Slave limit reached";
+                    return false;
+                }
+                uint8_t remoteAddress = remote > 0 ? (uint8_t)remote : groupId;
+                groups.emplace_back(groupId, remoteAddress, NameRef("Outdoor Device " + String(groupId)));
+                if (slaveCount > 0 && !groups.setSlaveCount(groups.back(), slaveCount)) {
+                    groups.pop_back();
+                    error = "Slave limit reached";
+                    return false;
+                }
+                return true;
+            }
+            
+            case UPDATE_GROUP:
+                if (!group) {
+                    error = "Group not found";
+                    return false;
+                }
+                if (hasNewId && newId != groupId) {
+                    if (findGroup(groups, newId)) {
+                        error = "Group ID already exists";
+                        return false;
+                    }
+                    group->id = newId;
+                }
+                if (slaveCount >= 0 && !groups.setSlaveCount(*group, slaveCount)) {
+                    error = "Slave limit reached";
+                    return false;
+                }
+                if (remote >= 0) group->remoteAddress = remote;
+                return true;
+            
+            case DELETE_GROUP:
+                for (size_t i = 0; i < groups.size(); i++) {
+                    if (groups[i].id == groupId) {
+                        groups.erase(groups.begin() + i);
+                        return true;
+                    }
+                }
+                error = "Group not found";
+                return false;
+            
+            case ADD_REGISTER:
+            case UPDATE_REGISTER:
+            case DELETE_REGISTER:
+                return applyRegister(groups, group, error);
+            
+            case INVALID:
+            default:
+                error = "Invalid operation";
+                return false;
+        }
+    }
+    
+    static Group* findGroup(GroupList& groups, uint8_t groupId) {
+        for (auto& group : groups) {
+            if (group.id == groupId) {
+                return &group;
+            }
+        }
+        return nullptr;
+    }
+    
+    bool applyRegister(GroupList& groups, Group* group, const char*& error) const {
+        if (!group) {
+            error = "Group not found";
+            return false;
+        }
+        
+        Slave* slave = nullptr;
+        if (slaveId != 0) {
+            slave = group->getSlave(slaveId);
+            if (!slave) {
+                error = "Slave not found";
+                return false;
+            }
+        }
+        
+        bool ok = false;
+        switch (type) {
+            case ADD_REGISTER: {
+                bool full = slave ? slave->registerCount() >= MODBUS_MAX_SLAVE_REGISTERS ||
+                                        groups.valueCount() >= MODBUS_MAX_SLAVE_VALUES
+                                  : group->registers.full();
+                if (full) {
+                    error = "Register limit reached";
+                    return false;
+                }
+                ok = slave ? groups.addSlaveRegister(*slave, Register(id, name))
+                           : group->addRegister(Register(id, name));
+                error = "Register ID already exists";
+                break;
+            }
+            case UPDATE_REGISTER: {
+                uint16_t targetId = hasNewId ? newId : id;
+                ok = slave ? slave->updateRegister(id, name, targetId) : group->updateRegister(id, name, targetId);
+                error = "Register not found or duplicate ID";
+                break;
+            }
+            case DELETE_REGISTER:
+                ok = slave ? groups.deleteSlaveRegister(*slave, id) : group->deleteRegister(id);
+                error = "Register not found";
+                break;
+            default:
+                error = "Invalid operation";
+                break;
+        }
+        return ok;
+    }
+};
+
+#endif // CONFIG_OPERATION_H
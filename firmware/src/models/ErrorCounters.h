@@ -0,0 +1,70 @@
+#ifndef ERROR_COUNTERS_H
+#define ERROR_COUNTERS_H
+
+#include <ArduinoJson.h>
+#include <atomic>
+
+/**
+ * ErrorCounters counts Modbus errors by code in fixed memory
+ * Slots: 1-15 Modbus exception codes, 16-47 eModbus codes 0xE0-0xFF, 0 anything else
+ */
+class ErrorCounters {
+public:
+    static constexpr size_t SLOT_COUNT = 48;
+
+    ErrorCounters() {
+        reset();
+    }
+
+    ErrorCounters(const ErrorCounters&) = delete;
+    ErrorCounters& operator=(const ErrorCounters&) = delete;
+
+    void add(uint8_t code) {
+        counts[slotFor(code)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t get(size_t slot) const {
+        return slot < SLOT_COUNT ? counts[slot].load(std::memory_order_relaxed) : 0;
+    }
+
+    void reset() {
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Error code represented by a slot (0 for the catch-all slot)
+     */
+    static uint8_t codeForSlot(size_t slot) {
+        if (slot == 0 || slot >= SLOT_COUNT) return 0;
+        if (slot < 16) return (uint8_t)slot;
+        return (uint8_t)(0xE0 + slot - 16);
+    }
+
+    // Serialize non-zero counters as {"0xE0": n, ...}
+    void toJson(JsonObject& obj) const {
+        char key[8];
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            uint32_t n = get(i);
+            if (n == 0) continue;
+            if (i == 0) {
+                obj["other"] = n;
+            } else {
+                snprintf(key, sizeof(key), "0x%02X", codeForSlot(i));
+                obj[key] = n;
+            }
+        }
+    }
+
+private:
+    std::atomic<uint32_t> counts[SLOT_COUNT];
+
+    static size_t slotFor(uint8_t code) {
+        if (code > 0 && code < 16) return code;
+        if (code >= 0xE0) return 16 + (code - 0xE0);
+        return 0;
+    }
+};
+
+#endif // ERROR_COUNTERS_H
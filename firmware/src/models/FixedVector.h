@@ -0,0 +1,134 @@
+#ifndef FIXED_VECTOR_H
+#define FIXED_VECTOR_H
+
+#include <stddef.h>
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * FixedVector is a vector with inline storage for up to N elements
+ * - The capacity is part of the type: nothing is allocated, and elements only move
+ *   when an element is inserted or erased before them
+ * - push_back/emplace_back return false when full instead of growing
+ * - Otherwise it follows the std::vector interface the models use
+ */
+template <typename T, size_t N>
+class FixedVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    FixedVector() : _size(0) {}
+
+    FixedVector(const FixedVector& other) : _size(0) {
+        for (const auto& item : other) emplace_back(item);
+    }
+
+    FixedVector(FixedVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) : _size(0) {
+        for (auto& item : other) emplace_back(std::move(item));
+        other.clear();
+    }
+
+    ~FixedVector() { clear(); }
+
+    FixedVector& operator=(const FixedVector& other) {
+        if (this != &other) {
+            clear();
+            for (const auto& item : other) emplace_back(item);
+        }
+        return *this;
+    }
+
+    FixedVector& operator=(FixedVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            for (auto& item : other) emplace_back(std::move(item));
+            other.clear();
+        }
+        return *this;
+    }
+
+    static constexpr size_t capacity() { return N; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    bool full() const { return _size == N; }
+
+    T* data() { return reinterpret_cast<T*>(_storage); }
+    const T* data() const { return reinterpret_cast<const T*>(_storage); }
+
+    T& operator[](size_t index) { return data()[index]; }
+    const T& operator[](size_t index) const { return data()[index]; }
+    T& front() { return data()[0]; }
+    const T& front() const { return data()[0]; }
+    T& back() { return data()[_size - 1]; }
+    const T& back() const { return data()[_size - 1]; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + _size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + _size; }
+
+    template <typename... Args>
+    bool emplace_back(Args&&... args) {
+        if (_size == N) return false;
+        new (data() + _size) T(std::forward<Args>(args)...);
+        _size++;
+        return true;
+    }
+
+    bool push_back(const T& item) { return emplace_back(item); }
+    bool push_back(T&& item) { return emplace_back(std::move(item)); }
+
+    void pop_back() {
+        data()[--_size].~T();
+    }
+
+    // Erase one element, the following ones move down
+    iterator erase(iterator pos) {
+        for (iterator it = pos; it + 1 != end(); ++it) {
+            *it = std::move(*(it + 1));
+        }
+        pop_back();
+        return pos;
+    }
+
+    // Erase [first, last), the following elements move down
+    iterator erase(iterator first, iterator last) {
+        iterator out = first;
+        for (iterator it = last; it != end(); ++it, ++out) {
+            *out = std::move(*it);
+        }
+        while (end() != out) pop_back();
+        return first;
+    }
+
+    // Insert count copies of value before pos, false (unchanged) if they do not fit
+    bool insert(iterator pos, size_t count, const T& value) {
+        if (count > N - _size) return false;
+        size_t index = pos - begin();
+        for (size_t i = 0; i < count; i++) emplace_back(value);
+        std::rotate(begin() + index, end() - count, end());
+        return true;
+    }
+
+    // Replace the contents with count copies of value, false if count exceeds the capacity
+    bool assign(size_t count, const T& value) {
+        clear();
+        if (count > N) return false;
+        for (size_t i = 0; i < count; i++) emplace_back(value);
+        return true;
+    }
+
+    void clear() {
+        while (_size > 0) pop_back();
+    }
+
+private:
+    alignas(T) unsigned char _storage[N * sizeof(T)];
+    size_t _size;
+};
+
+#endif // FIXED_VECTOR_H
@@ -2,31 +2,42 @@
 #define GROUP_H
 
 #include <ArduinoJson.h>
-#include <vector>
+#include "NameRef.h"
+#include "../config.h"
+#include "../services/TemplatePool.h"
+#include "FixedVector.h"
 #include "Register.h"
+#include "RegisterTemplate.h"
 #include "Slave.h"
+#include "Span.h"
+
+class GroupList;
 
 /**
  * Group represents an outdoor device/unit
  * Contains group-level registers and a list of slaves (indoor devices)
+ * The registers are stored inline up to MODBUS_MAX_GROUP_REGISTERS, the slaves in the
+ * arena of the GroupList holding the group (which adds and removes them)
  */
 class Group {
 public:
     uint8_t id;                         // Group ID / Local Modbus address on COM1 (0-255)
     uint8_t remoteAddress;              // Remote Modbus address on COM2 (0-255)
-    String name;                        // Group name (e.g., "Outdoor Device 1")
-    std::vector<Register> registers;    // Group-level registers
-    std::vector<Slave> slaves;          // List of slaves (indoor devices)
+    NameRef name;                       // Group name (e.g., "Outdoor Device 1")
+    FixedVector<Register, MODBUS_MAX_GROUP_REGISTERS> registers;   // Group-level registers
+    Span<Slave> slaves;                 // List of slaves (indoor devices)
+    RegisterTemplatePtr slaveTemplate;  // Registers of new slaves while there are none (see GroupList::setSlaveCount)
+    uint32_t lastUpdateMs;              // millis() of the last value received from COM2 (runtime only, 0 = never)
     
-    Group() : id(0), remoteAddress(0), name("") {}
+    Group() : id(0), remoteAddress(0), name(""), lastUpdateMs(0) {}
     
-    explicit Group(uint8_t id) : id(id), remoteAddress(id) {
-        name = "Outdoor Device " + String(id);
+    explicit Group(uint8_t id) : id(id), remoteAddress(id), lastUpdateMs(0) {
+        name = NameRef("Outdoor Device " + String(id));
     }
     
-    Group(uint8_t id, const String& name) : id(id), remoteAddress(id), name(name) {}
+    Group(uint8_t id, const NameRef& name) : id(id), remoteAddress(id), name(name), lastUpdateMs(0) {}
     
-    Group(uint8_t id, uint8_t remote, const String& name) : id(id), remoteAddress(remote), name(name) {}
+    Group(uint8_t id, uint8_t remote, const NameRef& name) : id(id), remoteAddress(remote), name(name), lastUpdateMs(0) {}
     
     // Add a new group-level register
     bool addRegister(const Register& reg) {
@@ -36,8 +47,7 @@ public:
                 return false;  // Duplicate
             }
         }
-        registers.push_back(reg);
-        return true;
+        return registers.push_back(reg);  // False when full
     }
     
     // Get group-level register by ID
@@ -81,18 +91,6 @@ public:
         return false;
     }
     
-    // Add a new slave
-    bool addSlave(const Slave& slave) {
-        // Check for duplicate ID
-        for (const auto& s : slaves) {
-            if (s.id == slave.id) {
-                return false;  // Duplicate
-            }
-        }
-        slaves.push_back(slave);
-        return true;
-    }
-    
     // Get slave by ID
     Slave* getSlave(uint8_t slaveId) {
         for (auto& s : slaves) {
@@ -103,39 +101,27 @@ public:
         return nullptr;
     }
     
-    // Delete slave
-    bool deleteSlave(uint8_t slaveId) {
-        for (size_t i = 0; i < slaves.size(); i++) {
-            if (slaves[i].id == slaveId) {
-                slaves.erase(slaves.begin() + i);
-                return true;
-            }
-        }
-        return false;
+    // Template new slaves are instantiated from: the last slave's, or the one kept from before
+    RegisterTemplatePtr getSlaveTemplate() const {
+        return slaves.empty() ? slaveTemplate : slaves.back().registerTemplate;
     }
     
-    // Update number of slaves (add or remove)
-    void updateSlaveCount(uint8_t newCount) {
-        uint8_t currentCount = slaves.size();
-        
-        if (newCount > currentCount) {
-            // Add new slaves
-            for (uint8_t i = currentCount + 1; i <= newCount; i++) {
-                slaves.push_back(Slave(i));
-            }
-        } else if (newCount < currentCount) {
-            // Remove slaves
-            while (slaves.size() > newCount) {
-                slaves.pop_back();
-            }
-        }
-    }
+    /**
+     * Let slaves with identical registers share one template (over all groups)
+     * Call after loading or editing, edits give a slave its own copy of the template.
+     * Reassigns Slave::registerTemplate, so only for lists nobody else reads
+     * (loading at boot, or a staged copy before ModbusService publishes it).
+     */
+    static void shareTemplates(GroupList& groups);
+    
+    // Register definitions stored once per template rather than once per slave
+    static size_t countTemplates(const GroupList& groups);
     
     // Serialize to JSON
     void toJson(JsonObject& obj, bool withValues = true) const {
         obj["id"] = id;
         obj["remote_address"] = remoteAddress;
-        obj["name"] = name;
+        name.toJson(obj["name"]);
         
         auto regArray = obj.createNestedArray("registers");
         for (const auto& reg : registers) {
@@ -154,30 +140,12 @@ public:
         }
     }
     
-    // Deserialize from JSON
-    static Group fromJson(const JsonObject& obj) {
-        uint8_t localId = obj["id"] | 0;
-        uint8_t remoteAddr = obj["remote_address"] | localId; // Default to local ID if not specified
-        Group group(localId, remoteAddr, obj["name"].as<String>());
-        
-        // Load registers
-        if (obj.containsKey("registers")) {
-            auto regsArray = obj["registers"].as<JsonArray>();
-            for (const auto& regObj : regsArray) {
-                group.registers.push_back(Register::fromJson(regObj));
-            }
-        }
-        
-        // Load slaves
-        if (obj.containsKey("slaves")) {
-            auto slavesArray = obj["slaves"].as<JsonArray>();
-            for (const auto& slaveObj : slavesArray) {
-                group.slaves.push_back(Slave::fromJson(slaveObj));
-            }
-        }
-        
-        return group;
-    }
+    // Deserialize from JSON and append to groups
+    // Returns false (groups unchanged) if the group exceeds a MODBUS_MAX_* limit or a pool
+    static bool fromJson(const JsonObject& obj, GroupList& groups);
 };
 
+// GroupList needs the complete Group, and defines the static members above that take it
+#include "GroupList.h"
+
 #endif // GROUP_H
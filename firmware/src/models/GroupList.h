@@ -0,0 +1,314 @@
+#ifndef GROUP_LIST_H
+#define GROUP_LIST_H
+
+#include <utility>
+#include "../config.h"
+#include "../services/NamePool.h"
+#include "../services/TemplatePool.h"
+#include "FixedVector.h"
+#include "Group.h"
+#include "Slave.h"
+
+/**
+ * GroupList is the whole configuration, in fixed-capacity storage
+ * - At most MODBUS_MAX_GROUPS groups, and over all groups MODBUS_MAX_TOTAL_SLAVES slaves
+ *   holding MODBUS_MAX_SLAVE_VALUES register values: a single group can use the whole
+ *   slave address range while the memory stays that of the largest site
+ * - The slaves are stored group by group and their values slave by slave, in two arenas
+ *   Group::slaves and Slave::values point into. Adding or removing slaves or slave
+ *   registers goes through the list, which moves the ones behind and relinks the views.
+ * - Otherwise it follows the FixedVector interface for the groups
+ */
+class GroupList {
+public:
+    using value_type = Group;
+    using iterator = Group*;
+    using const_iterator = const Group*;
+
+    GroupList() {}
+
+    GroupList(const GroupList& other) { *this = other; }
+
+    GroupList& operator=(const GroupList& other) {
+        if (this != &other) {
+            groups = other.groups;
+            slaves = other.slaves;
+            values = other.values;
+            relink();
+        }
+        return *this;
+    }
+
+    static constexpr size_t capacity() { return MODBUS_MAX_GROUPS; }
+    size_t size() const { return groups.size(); }
+    bool empty() const { return groups.empty(); }
+    bool full() const { return groups.full(); }
+
+    Group& operator[](size_t index) { return groups[index]; }
+    const Group& operator[](size_t index) const { return groups[index]; }
+    Group& front() { return groups.front(); }
+    const Group& front() const { return groups.front(); }
+    Group& back() { return groups.back(); }
+    const Group& back() const { return groups.back(); }
+
+    iterator begin() { return groups.begin(); }
+    iterator end() { return groups.end(); }
+    const_iterator begin() const { return groups.begin(); }
+    const_iterator end() const { return groups.end(); }
+
+    // Append a group without slaves, false when full
+    template <typename... Args>
+    bool emplace_back(Args&&... args) {
+        if (!groups.emplace_back(std::forward<Args>(args)...)) return false;
+        relink();
+        return true;
+    }
+
+    void pop_back() { erase(end() - 1); }
+
+    // Erase a group with its slaves, the following groups move down
+    iterator erase(iterator pos) {
+        removeSlaves(*pos, 0);
+        groups.erase(pos);
+        relink();
+        return pos;
+    }
+
+    void clear() {
+        groups.clear();
+        slaves.clear();
+        values.clear();
+    }
+
+    // Slaves and slave register values over all groups
+    size_t slaveCount() const { return slaves.size(); }
+    size_t valueCount() const { return values.size(); }
+
+    /**
+     * Add or remove slaves at the end of a group
+     * New slaves are numbered on from the last one and share its template (or the one
+     * kept while the group had none), values start at 0
+     * Returns false (unchanged) past MODBUS_MAX_SLAVES, the arena limits or the template pool
+     */
+    bool setSlaveCount(Group& group, size_t count) {
+        size_t current = group.slaves.size();
+        if (count < current) {
+            // Keep the template for when slaves are added again
+            if (count == 0) group.slaveTemplate = group.slaves.back().registerTemplate;
+            removeSlaves(group, count);
+            relink();
+            return true;
+        }
+        if (count == current) return true;
+
+        RegisterTemplatePtr tmpl = group.getSlaveTemplate();
+        if (!tmpl) tmpl = TemplatePool::create();
+        if (!tmpl) return false;
+        size_t added = count - current;
+        size_t registers = tmpl->registers.size();
+        if (count > MODBUS_MAX_SLAVES || added > slaves.capacity() - slaves.size() ||
+            added * registers > values.capacity() - values.size()) {
+            return false;
+        }
+
+        size_t at = slaveIndex(group) + current;
+        size_t valueAt = valueIndex(at);
+        slaves.insert(slaves.begin() + at, added, Slave(0, tmpl));
+        values.insert(values.begin() + valueAt, added * registers, 0);
+        for (size_t i = 0; i < added; i++) {
+            slaves[at + i].id = current + 1 + i;
+            slaves[at + i].values.resize(registers);
+        }
+        group.slaves.resize(count);
+        group.slaveTemplate.reset();
+        relink();
+        return true;
+    }
+
+    // Append a slave to a group, false (unchanged) past a limit
+    bool appendSlave(Group& group, uint8_t id, const RegisterTemplatePtr& tmpl) {
+        size_t registers = tmpl->registers.size();
+        if (group.slaves.size() >= MODBUS_MAX_SLAVES || slaves.full() ||
+            registers > values.capacity() - values.size()) {
+            return false;
+        }
+
+        size_t at = slaveIndex(group) + group.slaves.size();
+        size_t valueAt = valueIndex(at);
+        slaves.insert(slaves.begin() + at, 1, Slave(id, tmpl));
+        values.insert(values.begin() + valueAt, registers, 0);
+        slaves[at].values.resize(registers);
+        group.slaves.resize(group.slaves.size() + 1);
+        relink();
+        return true;
+    }
+
+    // Add a register to a slave (its own template from then on)
+    // Returns false on a duplicate ID or past a limit (including the template pool)
+    bool addSlaveRegister(Slave& slave, const Register& reg) {
+        if (slave.indexOf(reg.id) >= 0) {
+            return false;  // Duplicate
+        }
+        if (slave.registerCount() >= MODBUS_MAX_SLAVE_REGISTERS || values.full()) {
+            return false;
+        }
+
+        RegisterTemplate* tmpl = slave.ownTemplate();
+        if (!tmpl) return false;
+
+        size_t at = slave.values.data() - values.data() + slave.values.size();
+        tmpl->registers.push_back(Register(reg.id, reg.name));
+        values.insert(values.begin() + at, 1, reg.value);
+        slave.values.resize(slave.values.size() + 1);
+        relink();
+        return true;
+    }
+
+    // Delete a register of a slave (its own template from then on)
+    // Returns false if it has no such register or the template pool is exhausted
+    bool deleteSlaveRegister(Slave& slave, uint16_t regId) {
+        int index = slave.indexOf(regId);
+        if (index < 0) return false;
+
+        RegisterTemplate* tmpl = slave.ownTemplate();
+        if (!tmpl) return false;
+
+        auto& registers = tmpl->registers;
+        registers.erase(registers.begin() + index);
+        values.erase(values.begin() + (slave.values.data() - values.data()) + index);
+        slave.values.resize(slave.values.size() - 1);
+        relink();
+        return true;
+    }
+
+private:
+    FixedVector<Group, MODBUS_MAX_GROUPS> groups;
+    FixedVector<Slave, MODBUS_MAX_TOTAL_SLAVES> slaves;         // Group by group
+    FixedVector<uint16_t, MODBUS_MAX_SLAVE_VALUES> values;      // Slave by slave
+
+    // Arena position of the first slave of a group
+    size_t slaveIndex(const Group& group) const {
+        return group.slaves.data() - slaves.data();
+    }
+
+    // Arena position of the first value of the slave at an arena position (or of the end)
+    size_t valueIndex(size_t slave) const {
+        return slave < slaves.size() ? slaves[slave].values.data() - values.data() : values.size();
+    }
+
+    // Drop the slaves of a group past keep, with their values (relink afterwards)
+    void removeSlaves(Group& group, size_t keep) {
+        size_t first = slaveIndex(group) + keep;
+        size_t last = slaveIndex(group) + group.slaves.size();
+        size_t valueFirst = valueIndex(first);
+        size_t valueLast = valueIndex(last);
+        slaves.erase(slaves.begin() + first, slaves.begin() + last);
+        values.erase(values.begin() + valueFirst, values.begin() + valueLast);
+        group.slaves.resize(keep);
+    }
+
+    // Point the views at the arenas again, from their sizes
+    void relink() {
+        Slave* slave = slaves.data();
+        uint16_t* value = values.data();
+        for (auto& group : groups) {
+            group.slaves.rebind(slave);
+            slave += group.slaves.size();
+            for (auto& member : group.slaves) {
+                member.values.rebind(value);
+                value += member.values.size();
+            }
+        }
+    }
+};
+
+inline void Group::shareTemplates(GroupList& groups) {
+    FixedVector<RegisterTemplatePtr, MODBUS_MAX_TEMPLATES> distinct;
+    auto share = [&distinct](RegisterTemplatePtr& tmpl) {
+        if (!tmpl) return;
+        for (const auto& known : distinct) {
+            if (known == tmpl) return;
+            if (known->sameRegisters(*tmpl)) {
+                tmpl = known;
+                return;
+            }
+        }
+        distinct.push_back(tmpl);
+    };
+
+    for (auto& group : groups) {
+        for (auto& slave : group.slaves) {
+            share(slave.registerTemplate);
+        }
+        share(group.slaveTemplate);
+    }
+}
+
+inline size_t Group::countTemplates(const GroupList& groups) {
+    FixedVector<const RegisterTemplate*, MODBUS_MAX_TEMPLATES> distinct;
+    for (const auto& group : groups) {
+        for (const auto& slave : group.slaves) {
+            const RegisterTemplate* tmpl = slave.registerTemplate.get();
+            bool known = false;
+            for (const auto* other : distinct) {
+                if (other == tmpl) {
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) distinct.push_back(tmpl);
+        }
+    }
+    return distinct.size();
+}
+
+inline bool Group::fromJson(const JsonObject& obj, GroupList& groups) {
+    uint32_t namesRejected = NamePool::getRejectedCount();
+    auto regsArray = obj["registers"].as<JsonArray>();
+    auto slavesArray = obj["slaves"].as<JsonArray>();
+    if (groups.full() || regsArray.size() > MODBUS_MAX_GROUP_REGISTERS || slavesArray.size() > MODBUS_MAX_SLAVES) {
+        return false;
+    }
+    for (const auto& slaveObj : slavesArray) {
+        if (!Slave::fitsJson(slaveObj)) return false;
+    }
+
+    uint8_t id = obj["id"] | 0;
+    uint8_t remoteAddress = obj["remote_address"] | id; // Default to local ID if not specified
+    groups.emplace_back(id, remoteAddress, NameRef(obj["name"] | ""));
+    Group& group = groups.back();
+
+    // Load registers
+    for (const auto& regObj : regsArray) {
+        group.registers.push_back(Register::fromJson(regObj));
+    }
+
+    // Load slaves, sharing templates within the group right away so an import
+    // never holds more than one unshared template
+    for (const auto& slaveObj : slavesArray) {
+        Slave slave;
+        if (!Slave::fromJson(slaveObj, slave)) {
+            groups.pop_back();  // Template pool exhausted
+            return false;
+        }
+        for (const auto& other : group.slaves) {
+            if (other.registerTemplate->sameRegisters(*slave.registerTemplate)) {
+                slave.registerTemplate = other.registerTemplate;
+                break;
+            }
+        }
+        if (!groups.appendSlave(group, slave.id, slave.registerTemplate)) {
+            groups.pop_back();  // Over the slave or value arena
+            return false;
+        }
+    }
+
+    // Names the arena could not store would be saved empty
+    if (NamePool::getRejectedCount() != namesRejected) {
+        groups.pop_back();
+        return false;
+    }
+    return true;
+}
+
+#endif // GROUP_LIST_H
@@ -0,0 +1,135 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <ArduinoJson.h>
+#include <atomic>
+
+/**
+ * HistogramSnapshot is a plain copy of a Histogram taken for reporting
+ * Percentiles are interpolated linearly inside the bucket that holds them
+ */
+class HistogramSnapshot {
+public:
+    // Upper bounds of the buckets (1-2-5 series), the last bucket holds everything above
+    static constexpr size_t BOUND_COUNT = 21;
+    static constexpr size_t BUCKET_COUNT = BOUND_COUNT + 1;
+    static constexpr uint32_t BOUNDS[BOUND_COUNT] = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500,
+        1000, 2000, 5000, 10000, 20000, 50000,
+        100000, 200000, 500000, 1000000, 2000000, 5000000
+    };
+
+    uint32_t buckets[BUCKET_COUNT];
+    uint32_t count;
+    uint32_t max;
+    uint64_t sum;
+
+    HistogramSnapshot() : count(0), max(0), sum(0) {
+        for (size_t i = 0; i < BUCKET_COUNT; i++) buckets[i] = 0;
+    }
+
+    /**
+     * Value below which the given percentage (0-100) of samples fall
+     */
+    uint32_t percentile(uint8_t pct) const {
+        if (count == 0) return 0;
+
+        uint32_t rank = (uint32_t)(((uint64_t)count * pct + 99) / 100);
+        if (rank == 0) rank = 1;
+
+        uint32_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            if (buckets[i] == 0) continue;
+            if (seen + buckets[i] >= rank) {
+                uint32_t lower = i == 0 ? 0 : BOUNDS[i - 1];
+                uint32_t upper = i < BOUND_COUNT ? BOUNDS[i] : max;
+                uint32_t value = lower + (uint32_t)((uint64_t)(upper - lower) * (rank - seen) / buckets[i]);
+                return value < max ? value : max;
+            }
+            seen += buckets[i];
+        }
+        return max;
+    }
+
+    // Serialize to JSON
+    void toJson(JsonObject& obj) const {
+        obj["count"] = count;
+        obj["p50"] = percentile(50);
+        obj["p95"] = percentile(95);
+        obj["p99"] = percentile(99);
+        obj["max"] = max;
+    }
+};
+
+/**
+ * Histogram counts samples into fixed 1-2-5 buckets (unit chosen by the caller)
+ * Fixed memory, recording is lock-free and safe from any task
+ */
+class Histogram {
+public:
+    Histogram() : count(0), max(0), sum(0) {
+        for (size_t i = 0; i < HistogramSnapshot::BUCKET_COUNT; i++) buckets[i] = 0;
+    }
+
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    /**
+     * Record one sample
+     */
+    void record(uint32_t value) {
+        buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint32_t current = max.load(std::memory_order_relaxed);
+        while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Copy the current state (individual counters are read without a global lock)
+     */
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot snap;
+        for (size_t i = 0; i < HistogramSnapshot::BUCKET_COUNT; i++) {
+            snap.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+        snap.count = count.load(std::memory_order_relaxed);
+        snap.max = max.load(std::memory_order_relaxed);
+        snap.sum = sum.load(std::memory_order_relaxed);
+        return snap;
+    }
+
+    void reset() {
+        for (size_t i = 0; i < HistogramSnapshot::BUCKET_COUNT; i++) {
+            buckets[i].store(0, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint32_t> buckets[HistogramSnapshot::BUCKET_COUNT];
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> max;
+    std::atomic<uint64_t> sum;
+
+    static size_t bucketFor(uint32_t value) {
+        // Binary search over the bucket bounds
+        size_t lo = 0;
+        size_t hi = HistogramSnapshot::BOUND_COUNT;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (value <= HistogramSnapshot::BOUNDS[mid]) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    }
+};
+
+#endif // HISTOGRAM_H
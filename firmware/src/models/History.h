@@ -0,0 +1,230 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+/**
+ * HistoryRollup aggregates the values seen during one minute, hour or day
+ * Sum and count are wide enough for a register polled every few milliseconds for a day
+ */
+class HistoryRollup {
+public:
+    uint32_t startS;    // Start of the period (seconds since boot)
+    uint64_t sum;
+    uint32_t count;
+    uint16_t min;
+    uint16_t max;
+
+    HistoryRollup() : startS(0), sum(0), count(0), min(0), max(0) {}
+
+    void add(uint16_t value) {
+        if (count == 0) {
+            min = value;
+            max = value;
+        } else {
+            if (value < min) min = value;
+            if (value > max) max = value;
+        }
+        sum += value;
+        count++;
+    }
+
+    float avg() const {
+        return count ? (float)sum / count : 0.0f;
+    }
+};
+
+/**
+ * HistoryBlock stores raw samples delta-encoded
+ * The first sample is kept in the header, each following sample is stored as
+ * varint(time delta ms) + varint(zigzag(value delta)); typically 2-3 bytes
+ */
+class HistoryBlock {
+public:
+    uint32_t seq;           // Block sequence number within its series
+    uint32_t startMs;       // Time of the first sample
+    uint32_t lastMs;        // Time of the last sample
+    uint16_t firstValue;
+    uint16_t lastValue;
+    uint16_t count;         // Samples in the block
+    uint16_t used;          // Bytes of data in use
+    uint8_t data[HISTORY_BLOCK_BYTES];
+
+    HistoryBlock() : seq(0), startMs(0), lastMs(0), firstValue(0), lastValue(0), count(0), used(0) {}
+
+    void start(uint32_t blockSeq, uint32_t timeMs, uint16_t value) {
+        seq = blockSeq;
+        startMs = lastMs = timeMs;
+        firstValue = lastValue = value;
+        count = 1;
+        used = 0;
+    }
+
+    /**
+     * Append a sample, returns false when the block is full
+     */
+    bool append(uint32_t timeMs, uint16_t value) {
+        uint8_t encoded[8];
+        size_t len = putVarint(encoded, timeMs - lastMs);
+        int32_t delta = (int32_t)value - (int32_t)lastValue;
+        len += putVarint(encoded + len, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+        if (used + len > HISTORY_BLOCK_BYTES) {
+            return false;
+        }
+        memcpy(data + used, encoded, len);
+        used += len;
+        lastMs = timeMs;
+        lastValue = value;
+        count++;
+        return true;
+    }
+
+    /**
+     * Decodes the samples of a block in order
+     */
+    class Cursor {
+    public:
+        explicit Cursor(const HistoryBlock& block)
+            : _block(&block), _index(0), _offset(0), _timeMs(block.startMs), _value(block.firstValue) {}
+
+        bool next(uint32_t& timeMs, uint16_t& value) {
+            if (_index >= _block->count) return false;
+            if (_index > 0) {
+                uint32_t dt, zigzag;
+                if (!getVarint(dt) || !getVarint(zigzag)) return false;
+                int32_t delta = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+                _timeMs += dt;
+                _value = (uint16_t)(_value + delta);
+            }
+            _index++;
+            timeMs = _timeMs;
+            value = _value;
+            return true;
+        }
+
+    private:
+        const HistoryBlock* _block;
+        uint16_t _index;
+        uint16_t _offset;
+        uint32_t _timeMs;
+        uint16_t _value;
+
+        bool getVarint(uint32_t& out) {
+            out = 0;
+            for (uint8_t shift = 0; shift < 35; shift += 7) {
+                if (_offset >= _block->used) return false;
+                uint8_t b = _block->data[_offset++];
+                out |= (uint32_t)(b & 0x7F) << shift;
+                if (!(b & 0x80)) return true;
+            }
+            return false;
+        }
+    };
+
+private:
+    static size_t putVarint(uint8_t* out, uint32_t v) {
+        size_t len = 0;
+        while (v >= 0x80) {
+            out[len++] = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        out[len++] = (uint8_t)v;
+        return len;
+    }
+};
+
+/**
+ * HistorySeries holds the fixed-size history of one register
+ */
+class HistorySeries {
+public:
+    bool active;
+    uint32_t token;                 // [group:8][slave:8][reg:16], as used for COM2 requests
+    uint32_t epoch;                 // Changes whenever the slot is (re)assigned
+
+    HistoryBlock blocks[HISTORY_RAW_BLOCKS];
+    uint32_t rawSeq;                // Sequence number of the block being filled
+
+    HistoryRollup minutes[HISTORY_MINUTE_SLOTS];
+    uint32_t minutesWritten;        // Completed minute rollups since tracking started
+    HistoryRollup currentMinute;
+
+    HistoryRollup hours[HISTORY_HOUR_SLOTS];
+    uint32_t hoursWritten;
+    HistoryRollup currentHour;
+
+    HistoryRollup days[HISTORY_DAY_SLOTS];
+    uint32_t daysWritten;
+    HistoryRollup currentDay;
+
+    HistorySeries()
+        : active(false), token(0), epoch(0), rawSeq(0), minutesWritten(0), hoursWritten(0), daysWritten(0) {}
+
+    void reset(uint32_t newToken) {
+        active = true;
+        token = newToken;
+        epoch++;
+        rawSeq = 0;
+        blocks[0].count = 0;
+        blocks[0].used = 0;
+        minutesWritten = 0;
+        hoursWritten = 0;
+        daysWritten = 0;
+        currentMinute = HistoryRollup();
+        currentHour = HistoryRollup();
+        currentDay = HistoryRollup();
+    }
+
+    void record(uint32_t timeMs, uint16_t value) {
+        uint32_t timeS = timeMs / 1000;
+        addRollup(currentMinute, minutes, HISTORY_MINUTE_SLOTS, minutesWritten, timeS, 60, value);
+        addRollup(currentHour, hours, HISTORY_HOUR_SLOTS, hoursWritten, timeS, 3600, value);
+        addRollup(currentDay, days, HISTORY_DAY_SLOTS, daysWritten, timeS, 86400, value);
+
+        HistoryBlock& block = blocks[rawSeq % HISTORY_RAW_BLOCKS];
+        if (block.count == 0) {
+            block.start(rawSeq, timeMs, value);
+            return;
+        }
+        // Only changes are stored, plus a heartbeat so gaps can be told from flat lines
+        if (value == block.lastValue && timeMs - block.lastMs < HISTORY_HEARTBEAT_MS) {
+            return;
+        }
+        if (!block.append(timeMs, value)) {
+            rawSeq++;
+            blocks[rawSeq % HISTORY_RAW_BLOCKS].start(rawSeq, timeMs, value);
+        }
+    }
+
+    // Oldest raw block sequence number still held
+    uint32_t oldestRawSeq() const {
+        return rawSeq >= HISTORY_RAW_BLOCKS ? rawSeq - (HISTORY_RAW_BLOCKS - 1) : 0;
+    }
+
+    // Raw samples held (change points and heartbeats)
+    uint32_t rawSampleCount() const {
+        uint32_t total = 0;
+        for (uint32_t seq = oldestRawSeq(); seq <= rawSeq; seq++) {
+            total += blocks[seq % HISTORY_RAW_BLOCKS].count;
+        }
+        return total;
+    }
+
+private:
+    static void addRollup(HistoryRollup& current, HistoryRollup* ring, size_t slots, uint32_t& written,
+                          uint32_t timeS, uint32_t periodS, uint16_t value) {
+        uint32_t periodStart = timeS - timeS % periodS;
+        if (current.count > 0 && current.startS != periodStart) {
+            ring[written % slots] = current;
+            written++;
+            current = HistoryRollup();
+        }
+        if (current.count == 0) {
+            current.startS = periodStart;
+        }
+        current.add(value);
+    }
+};
+
+#endif // HISTORY_H
@@ -12,10 +12,11 @@ public:
     uint8_t dataBits;       // Data bits (5, 6, 7, 8)
     uint8_t stopBits;       // Stop bits (1, 2)
     uint8_t parity;         // Parity (0=None, 1=Odd, 2=Even)
+    uint32_t frameGapUs;    // Inter-frame silent interval override in microseconds (0=auto)
     
     InterfaceConfig(uint32_t baud = 19200, uint8_t data = 8, 
-                    uint8_t stop = 1, uint8_t par = 0)
-        : baudrate(baud), dataBits(data), stopBits(stop), parity(par) {}
+                    uint8_t stop = 1, uint8_t par = 0, uint32_t frameGap = 0)
+        : baudrate(baud), dataBits(data), stopBits(stop), parity(par), frameGapUs(frameGap) {}
     
     // Serialize to JSON
     void toJson(JsonObject& obj, const String& prefix) const {
@@ -23,6 +24,27 @@ public:
         obj[prefix + "_data"] = dataBits;
         obj[prefix + "_stop"] = stopBits;
         obj[prefix + "_parity"] = parity;
+        obj[prefix + "_frame_gap"] = frameGapUs;
+    }
+    
+    // Bits on the wire per character: start + data + parity + stop
+    uint8_t bitsPerChar() const {
+        return 1 + dataBits + (parity != 0 ? 1 : 0) + stopBits;
+    }
+    
+    // Time to transmit one character in microseconds
+    uint32_t charTimeUs() const {
+        return (bitsPerChar() * 1000000UL + baudrate - 1) / baudrate;
+    }
+    
+    /**
+     * Silent interval between frames in microseconds
+     * Modbus RTU: 3.5 character times, fixed 1750 us above 19200 baud
+     */
+    uint32_t frameIntervalUs() const {
+        if (frameGapUs != 0) return frameGapUs;
+        if (baudrate > 19200) return 1750;
+        return (35UL * bitsPerChar() * 100000UL + baudrate - 1) / baudrate;
     }
     
     // Validate configuration
@@ -30,6 +52,7 @@ public:
         if (dataBits < 5 || dataBits > 8) return false;
         if (stopBits < 1 || stopBits > 2) return false;
         if (parity > 2) return false;
+        if (frameGapUs != 0 && (frameGapUs < 200 || frameGapUs > 50000)) return false;
         
         switch (baudrate) {
             case 9600:
@@ -51,14 +74,26 @@ class InterfacesData {
 public:
     InterfaceConfig uart1;
     InterfaceConfig uart2;
+    uint32_t uart2TimeoutMinMs;     // Floor of the adaptive COM2 response timeout
+    uint32_t uart2TimeoutMaxMs;     // Ceiling of the adaptive COM2 response timeout
     
     InterfacesData() 
-        : uart1(19200, 8, 1, 0), uart2(19200, 8, 1, 0) {}
+        : uart1(19200, 8, 1, 0), uart2(19200, 8, 1, 0),
+          uart2TimeoutMinMs(50), uart2TimeoutMaxMs(500) {}
     
     // Serialize to JSON
     void toJson(JsonObject& obj) const {
         uart1.toJson(obj, "uart1");
         uart2.toJson(obj, "uart2");
+        obj["uart2_timeout_min"] = uart2TimeoutMinMs;
+        obj["uart2_timeout_max"] = uart2TimeoutMaxMs;
+    }
+    
+    // Validate adaptive timeout bounds
+    bool isTimeoutValid() const {
+        if (uart2TimeoutMinMs < 10) return false;
+        if (uart2TimeoutMaxMs > 10000) return false;
+        return uart2TimeoutMinMs <= uart2TimeoutMaxMs;
     }
     
     // Deserialize from JSON
@@ -71,7 +106,8 @@ public:
                     obj["uart1_baud"],
                     obj["uart1_data"],
                     obj["uart1_stop"],
-                    obj["uart1_parity"]
+                    obj["uart1_parity"],
+                    obj["uart1_frame_gap"] | 0
                 );
             }
             
@@ -80,9 +116,13 @@ public:
                     obj["uart2_baud"],
                     obj["uart2_data"],
                     obj["uart2_stop"],
-                    obj["uart2_parity"]
+                    obj["uart2_parity"],
+                    obj["uart2_frame_gap"] | 0
                 );
             }
+            
+            data.uart2TimeoutMinMs = obj["uart2_timeout_min"] | data.uart2TimeoutMinMs;
+            data.uart2TimeoutMaxMs = obj["uart2_timeout_max"] | data.uart2TimeoutMaxMs;
         }
         
         return data;
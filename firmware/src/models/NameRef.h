@@ -0,0 +1,62 @@
+#ifndef NAME_REF_H
+#define NAME_REF_H
+
+#include <Arduino.h>
+#include "../services/NamePool.h"
+
+/**
+ * NameRef holds a group, template or register name as a segment and offset in the NamePool
+ *
+ * Names loaded from the configuration partition point straight into the
+ * memory-mapped flash. Names set at runtime (REST edits, imports) are interned
+ * in the RAM arena until the next checkpoint relinks them to flash. Either way
+ * a NameRef is four bytes and trivially copyable, models copy no strings.
+ *
+ * Segment and offset share one 32-bit word. Register templates are shared with the
+ * published configuration, so a checkpoint relinks names that are being read:
+ * relink() stores the word atomically and c_str() loads it once, and readers see
+ * either the old or the new location (both stay valid).
+ */
+class NameRef {
+public:
+    NameRef() : _ref(pack(NamePool::RAM_SEGMENT, NamePool::EMPTY)) {}
+    NameRef(const String& name) : _ref(pack(NamePool::RAM_SEGMENT, NamePool::intern(name.c_str(), name.length()))) {}
+    NameRef(const char* name) : _ref(pack(NamePool::RAM_SEGMENT, NamePool::intern(name))) {}
+
+    /**
+     * Reference a name in a mapped flash segment (see NamePool::mapSegment)
+     */
+    static NameRef mapped(uint8_t segment, uint16_t offset) {
+        NameRef ref;
+        ref._ref = pack(segment, offset);
+        return ref;
+    }
+
+    /**
+     * Point at the same name elsewhere while other tasks may read this one
+     */
+    void relink(const NameRef& other) { __atomic_store_n(&_ref, other._ref, __ATOMIC_RELEASE); }
+
+    const char* c_str() const {
+        uint32_t ref = __atomic_load_n(&_ref, __ATOMIC_ACQUIRE);
+        return NamePool::resolve(ref >> 16, ref & 0xFFFF);
+    }
+    size_t length() const { return strlen(c_str()); }
+    bool isMapped() const { return (__atomic_load_n(&_ref, __ATOMIC_ACQUIRE) >> 16) != NamePool::RAM_SEGMENT; }
+    String toString() const { return String(c_str()); }
+
+    /**
+     * Store in a JSON value, linked in place (pool names never move)
+     */
+    template <typename TVariant>
+    void toJson(TVariant dst) const {
+        dst.set(c_str());
+    }
+
+private:
+    uint32_t _ref;      // Segment in the upper half, offset in the lower
+
+    static uint32_t pack(uint8_t segment, uint16_t offset) { return (uint32_t)segment << 16 | offset; }
+};
+
+#endif // NAME_REF_H
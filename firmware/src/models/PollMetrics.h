@@ -0,0 +1,66 @@
+#ifndef POLL_METRICS_H
+#define POLL_METRICS_H
+
+#include <ArduinoJson.h>
+#include <vector>
+#include "Histogram.h"
+
+/**
+ * GroupCycleMetrics holds the polling time distribution of one group
+ */
+class GroupCycleMetrics {
+public:
+    uint8_t groupId;                // Group ID
+    HistogramSnapshot durationMs;   // Time spent polling the group per cycle
+
+    GroupCycleMetrics() : groupId(0) {}
+
+    // Serialize to JSON
+    void toJson(JsonObject& obj) const {
+        obj["id"] = groupId;
+        auto durationObj = obj.createNestedObject("duration_ms");
+        durationMs.toJson(durationObj);
+    }
+};
+
+/**
+ * PollMetrics is a snapshot of the COM2 polling cycle statistics
+ */
+class PollMetrics {
+public:
+    uint32_t cycles;                    // Completed full cycles
+    uint32_t lastCycleMs;               // Duration of the last full cycle
+    uint32_t lastCycleRequests;         // Requests sent in the last full cycle
+    uint32_t lastCycleBytes;            // Bytes on the bus in the last full cycle
+    HistogramSnapshot cycleMs;          // Full cycle duration distribution
+    HistogramSnapshot requestsPerCycle; // Requests per cycle distribution
+    HistogramSnapshot bytesPerCycle;    // Bytes per cycle distribution
+    std::vector<GroupCycleMetrics> groups;
+
+    PollMetrics() : cycles(0), lastCycleMs(0), lastCycleRequests(0), lastCycleBytes(0) {}
+
+    // Serialize to JSON
+    void toJson(JsonObject& obj, bool withGroups = true) const {
+        obj["cycles"] = cycles;
+        obj["last_cycle_ms"] = lastCycleMs;
+        obj["last_cycle_requests"] = lastCycleRequests;
+        obj["last_cycle_bytes"] = lastCycleBytes;
+
+        auto cycleObj = obj.createNestedObject("cycle_ms");
+        cycleMs.toJson(cycleObj);
+        auto requestsObj = obj.createNestedObject("requests_per_cycle");
+        requestsPerCycle.toJson(requestsObj);
+        auto bytesObj = obj.createNestedObject("bytes_per_cycle");
+        bytesPerCycle.toJson(bytesObj);
+
+        if (withGroups) {
+            auto groupsArray = obj.createNestedArray("groups");
+            for (const auto& group : groups) {
+                auto groupObj = groupsArray.createNestedObject();
+                group.toJson(groupObj);
+            }
+        }
+    }
+};
+
+#endif // POLL_METRICS_H
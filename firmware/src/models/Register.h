@@ -2,6 +2,8 @@
 #define REGISTER_H
 
 #include <ArduinoJson.h>
+#include <type_traits>
+#include "NameRef.h"
 
 /**
  * Register represents a single Modbus register
@@ -10,35 +12,41 @@
 class Register {
 public:
     uint16_t id;        // Register address (0-65535)
-    String name;        // Register name (user-defined)
+    NameRef name;       // Register name (user-defined)
     uint16_t value;     // Current register value (read from Modbus)
+    uint16_t slot;      // Position in COM1 address order over all groups (runtime only)
     
-    Register() : id(0), name(""), value(0) {}
+    static constexpr uint16_t NO_SLOT = 0xFFFF;
     
-    Register(uint16_t id, const String& name, uint16_t value = 0) 
-        : id(id), name(name), value(value) {}
+    Register() : id(0), name(""), value(0), slot(NO_SLOT) {}
+    
+    Register(uint16_t id, const NameRef& name, uint16_t value = 0) 
+        : id(id), name(name), value(value), slot(NO_SLOT) {}
     
     // Serialize to JSON
     void toJson(JsonObject& obj) const {
         obj["id"] = id;
-        obj["name"] = name;
+        name.toJson(obj["name"]);
         obj["value"] = value;
     }
     
     // Serialize to JSON (without value)
     void toJsonWithoutValue(JsonObject& obj) const {
         obj["id"] = id;
-        obj["name"] = name;
+        name.toJson(obj["name"]);
     }
     
     // Deserialize from JSON (value is initialized to 0, will be updated from Modbus)
     static Register fromJson(const JsonObject& obj) {
         Register reg;
         reg.id = obj["id"] | 0;
-        reg.name = obj["name"].as<String>();
+        reg.name = obj["name"] | "";
         reg.value = 0;  // Always start at 0, will be updated from Modbus polling
         return reg;
     }
 };
 
+// Registers are copied around in vectors and snapshots, keep them plain data
+static_assert(std::is_trivially_copyable<Register>::value, "Register must stay trivially copyable");
+
 #endif // REGISTER_H
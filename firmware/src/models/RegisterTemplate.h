@@ -0,0 +1,52 @@
+#ifndef REGISTER_TEMPLATE_H
+#define REGISTER_TEMPLATE_H
+
+#include <memory>
+#include <string.h>
+#include "../config.h"
+#include "FixedVector.h"
+#include "NameRef.h"
+#include "Register.h"
+
+/**
+ * RegisterTemplate is the register set of an indoor device model
+ * Slaves of the same model share one template (IDs and names) and only store their values.
+ * Templates are never modified while shared: editing a slave's registers gives it its own
+ * copy, and Group::shareTemplates merges identical templates again.
+ * Templates are created by TemplatePool, which keeps them in static blocks.
+ */
+class RegisterTemplate {
+public:
+    NameRef name;                       // Template name (e.g., "Indoor unit")
+    FixedVector<Register, MODBUS_MAX_SLAVE_REGISTERS> registers;   // Register definitions (value and slot are unused)
+    
+    RegisterTemplate() : name("Indoor unit") {}
+    
+    explicit RegisterTemplate(const NameRef& name) : name(name) {}
+    
+    // Index of a register ID, -1 if not part of the template
+    int indexOf(uint16_t regId) const {
+        for (size_t i = 0; i < registers.size(); i++) {
+            if (registers[i].id == regId) {
+                return (int)i;
+            }
+        }
+        return -1;
+    }
+    
+    // Same register IDs and names in the same order
+    bool sameRegisters(const RegisterTemplate& other) const {
+        if (registers.size() != other.registers.size()) return false;
+        for (size_t i = 0; i < registers.size(); i++) {
+            if (registers[i].id != other.registers[i].id ||
+                strcmp(registers[i].name.c_str(), other.registers[i].name.c_str()) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+using RegisterTemplatePtr = std::shared_ptr<RegisterTemplate>;
+
+#endif // REGISTER_TEMPLATE_H
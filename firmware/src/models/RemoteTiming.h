@@ -0,0 +1,107 @@
+#ifndef REMOTE_TIMING_H
+#define REMOTE_TIMING_H
+
+#include <ArduinoJson.h>
+
+/**
+ * RemoteTiming tracks round-trip times to one remote Modbus address on COM2
+ * and derives its response timeout the way TCP derives its RTO (RFC 6298):
+ *   SRTT   = 7/8 SRTT + 1/8 RTT
+ *   RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - RTT|
+ *   RTO    = SRTT + 4 * RTTVAR, clamped to [floor, ceiling]
+ * A timeout doubles the RTO until the next valid sample (Karn's algorithm).
+ */
+class RemoteTiming {
+public:
+    uint8_t remoteAddress;      // Remote Modbus address on COM2
+    uint32_t srttUs;            // Smoothed round-trip time (microseconds)
+    uint32_t rttvarUs;          // Round-trip time variance (microseconds)
+    uint32_t maxRttUs;          // Largest round-trip time seen (microseconds)
+    uint32_t samples;           // Number of round-trip samples
+    uint32_t timeouts;          // Requests that timed out
+    uint32_t lateResponses;     // Responses slower than the RTO computed for them
+    uint32_t turnaroundUs;      // Smoothed device turnaround: RTT minus time on the wire
+    uint32_t minTurnaroundUs;   // Fastest device turnaround seen
+    uint8_t backoff;            // Timeout backoff exponent (0 = none)
+
+    explicit RemoteTiming(uint8_t address = 0)
+        : remoteAddress(address), srttUs(0), rttvarUs(0), maxRttUs(0),
+          samples(0), timeouts(0), lateResponses(0),
+          turnaroundUs(0), minTurnaroundUs(0), backoff(0) {}
+
+    /**
+     * Feed a measured round-trip time
+     */
+    void addSample(uint32_t rttUs) {
+        if (samples == 0) {
+            srttUs = rttUs;
+            rttvarUs = rttUs / 2;
+        } else {
+            uint32_t delta = rttUs > srttUs ? rttUs - srttUs : srttUs - rttUs;
+            rttvarUs = (3 * rttvarUs + delta) / 4;
+            srttUs = (7 * srttUs + rttUs) / 8;
+        }
+        if (rttUs > maxRttUs) {
+            maxRttUs = rttUs;
+        }
+        samples++;
+        backoff = 0;
+    }
+
+    /**
+     * Feed a device turnaround time (processing time between request and response frames)
+     * Call after addSample for the same response
+     */
+    void addTurnaround(uint32_t us) {
+        if (samples <= 1) {
+            turnaroundUs = us;
+            minTurnaroundUs = us;
+            return;
+        }
+        turnaroundUs = (7 * turnaroundUs + us) / 8;
+        if (us < minTurnaroundUs) {
+            minTurnaroundUs = us;
+        }
+    }
+
+    /**
+     * Record a timeout and back off
+     */
+    void addTimeout() {
+        timeouts++;
+        if (backoff < 4) {
+            backoff++;
+        }
+    }
+
+    /**
+     * Response timeout in milliseconds, clamped to [floorMs, ceilingMs]
+     * Without samples the ceiling is used
+     */
+    uint32_t rtoMs(uint32_t floorMs, uint32_t ceilingMs) const {
+        if (samples == 0) {
+            return ceilingMs;
+        }
+        uint32_t rto = (srttUs + 4 * rttvarUs + 999) / 1000;
+        rto <<= backoff;
+        if (rto < floorMs) rto = floorMs;
+        if (rto > ceilingMs) rto = ceilingMs;
+        return rto;
+    }
+
+    // Serialize to JSON
+    void toJson(JsonObject& obj, uint32_t floorMs, uint32_t ceilingMs) const {
+        obj["remote_address"] = remoteAddress;
+        obj["srtt_us"] = srttUs;
+        obj["rttvar_us"] = rttvarUs;
+        obj["max_rtt_us"] = maxRttUs;
+        obj["rto_ms"] = rtoMs(floorMs, ceilingMs);
+        obj["samples"] = samples;
+        obj["timeouts"] = timeouts;
+        obj["late_responses"] = lateResponses;
+        obj["turnaround_us"] = turnaroundUs;
+        obj["min_turnaround_us"] = minTurnaroundUs;
+    }
+};
+
+#endif // REMOTE_TIMING_H
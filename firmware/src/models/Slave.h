@@ -2,103 +2,121 @@
 #define SLAVE_H
 
 #include <ArduinoJson.h>
-#include <vector>
+#include "../config.h"
+#include "../services/TemplatePool.h"
+#include "Span.h"
 #include "Register.h"
+#include "RegisterTemplate.h"
 
 /**
  * Slave represents an indoor device
- * Contains slave-level registers
+ * Its registers are defined by a template shared with the other slaves of the same model,
+ * the slave itself only holds one value per template register
+ * The values live in the arena of the GroupList holding the slave, which is also what
+ * adds and removes them (GroupList::addSlaveRegister, deleteSlaveRegister)
  */
 class Slave {
 public:
-    uint8_t id;                         // Slave ID (1-255)
-    std::vector<Register> registers;    // List of slave-level registers
+    uint8_t id;                             // Slave ID (1-255)
+    RegisterTemplatePtr registerTemplate;   // Register IDs and names (shared, never null in a GroupList)
+    Span<uint16_t> values;                  // Current value per template register (read from Modbus)
+    uint16_t firstSlot;                     // Slot of the first register, the others follow (runtime only)
     
-    Slave() : id(0) {}
+    Slave() : id(0), firstSlot(Register::NO_SLOT) {}
     
-    explicit Slave(uint8_t id) : id(id) {}
+    Slave(uint8_t id, const RegisterTemplatePtr& tmpl) : id(id), registerTemplate(tmpl), firstSlot(Register::NO_SLOT) {}
     
-    // Add a new register
-    bool addRegister(const Register& reg) {
-        // Check for duplicate ID
-        for (const auto& r : registers) {
-            if (r.id == reg.id) {
-                return false;  // Duplicate
-            }
-        }
-        registers.push_back(reg);
-        return true;
+    size_t registerCount() const {
+        return registerTemplate->registers.size();
     }
     
-    // Get register by ID
-    Register* getRegister(uint16_t regId) {
-        for (auto& r : registers) {
-            if (r.id == regId) {
-                return &r;
-            }
-        }
-        return nullptr;
+    // Register definition (ID and name) by position
+    const Register& getDefinition(size_t index) const {
+        return registerTemplate->registers[index];
+    }
+    
+    // Position of a register ID, -1 if the slave does not have it
+    int indexOf(uint16_t regId) const {
+        return registerTemplate->indexOf(regId);
+    }
+    
+    // Slot (COM1 address order over all groups) of the register at a position
+    uint16_t slotOf(size_t index) const {
+        return firstSlot == Register::NO_SLOT ? Register::NO_SLOT : firstSlot + index;
     }
     
     // Update register
     bool updateRegister(uint16_t regId, const String& newName, uint16_t newId) {
-        // Find current register
-        auto* reg = getRegister(regId);
-        if (!reg) return false;
-        
+        int index = indexOf(regId);
+        if (index < 0) return false;
+    
         // Check if new ID already exists
-        if (newId != regId) {
-            for (const auto& r : registers) {
-                if (r.id == newId) {
-                    return false;  // Duplicate
-                }
-            }
+        if (newId != regId && indexOf(newId) >= 0) {
+            return false;  // Duplicate
         }
+    
+        RegisterTemplate* tmpl = ownTemplate();
+        if (!tmpl) return false;  // Template pool exhausted
         
-        reg->id = newId;
-        reg->name = newName;
+        Register& reg = tmpl->registers[index];
+        reg.id = newId;
+        reg.name = newName;
         return true;
     }
     
-    // Delete register
-    bool deleteRegister(uint16_t regId) {
-        for (size_t i = 0; i < registers.size(); i++) {
-            if (registers[i].id == regId) {
-                registers.erase(registers.begin() + i);
-                return true;
-            }
-        }
-        return false;
-    }
-    
     // Serialize to JSON
     void toJson(JsonObject& obj, bool withValues = true) const {
         obj["id"] = id;
-        
+        registerTemplate->name.toJson(obj["template"]);
+    
         auto regArray = obj.createNestedArray("registers");
-        for (const auto& reg : registers) {
+        for (size_t i = 0; i < registerCount(); i++) {
             auto regObj = regArray.createNestedObject();
+            getDefinition(i).toJsonWithoutValue(regObj);
             if (withValues) {
-                reg.toJson(regObj);
-            } else {
-                reg.toJsonWithoutValue(regObj);
+                regObj["value"] = values[i];
             }
         }
     }
     
-    // Deserialize from JSON
-    static Slave fromJson(const JsonObject& obj) {
-        Slave slave(obj["id"] | 0);
+    // Deserialize the ID and a template of its own from JSON (see Group::shareTemplates),
+    // the values come with GroupList::appendSlave
+    // Returns false (slave unchanged) if the slave exceeds MODBUS_MAX_SLAVE_REGISTERS
+    // or the template pool is exhausted
+    static bool fromJson(const JsonObject& obj, Slave& slave) {
+        if (!fitsJson(obj)) return false;
         
-        if (obj.containsKey("registers")) {
-            auto regsArray = obj["registers"].as<JsonArray>();
-            for (const auto& regObj : regsArray) {
-                slave.registers.push_back(Register::fromJson(regObj));
-            }
+        auto tmpl = TemplatePool::create();
+        if (!tmpl) return false;
+        if (obj.containsKey("template")) {
+            tmpl->name = obj["template"] | "";
         }
-        
-        return slave;
+    
+        for (const auto& regObj : obj["registers"].as<JsonArray>()) {
+            tmpl->registers.push_back(Register::fromJson(regObj));
+        }
+    
+        slave.id = obj["id"] | 0;
+        slave.registerTemplate = tmpl;
+        return true;
+    }
+    
+    // True if the JSON slave fits the capacity limits
+    static bool fitsJson(const JsonObject& obj) {
+        return obj["registers"].as<JsonArray>().size() <= MODBUS_MAX_SLAVE_REGISTERS;
     }
+    
+    // Copy the template before modifying it if it is shared, other slaves keep theirs
+    // Null (template unchanged) if the template pool is exhausted
+    RegisterTemplate* ownTemplate() {
+        if (registerTemplate.use_count() > 1) {
+            RegisterTemplatePtr copy = TemplatePool::create(*registerTemplate);
+            if (!copy) return nullptr;
+            registerTemplate = copy;
+        }
+        return registerTemplate.get();
+    }
+
 };
 
 #endif // SLAVE_H
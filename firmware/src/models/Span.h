@@ -0,0 +1,51 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <stddef.h>
+
+/**
+ * Span is a view of consecutive elements stored elsewhere
+ * - Group::slaves and Slave::values are spans into the arenas of their GroupList,
+ *   which alone moves them (see GroupList::relink)
+ * - Constness carries over to the elements: a const span only reads them
+ * - Otherwise it follows the std::vector interface the models use for reading
+ */
+template <typename T>
+class Span {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    Span() : _data(nullptr), _size(0) {}
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+
+    T& operator[](size_t index) { return _data[index]; }
+    const T& operator[](size_t index) const { return _data[index]; }
+    T& front() { return _data[0]; }
+    const T& front() const { return _data[0]; }
+    T& back() { return _data[_size - 1]; }
+    const T& back() const { return _data[_size - 1]; }
+
+    iterator begin() { return _data; }
+    iterator end() { return _data + _size; }
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+
+    // Point at other storage, keeping the size
+    void rebind(T* data) { _data = data; }
+
+    // Change the size only, the owner rebinds afterwards
+    void resize(size_t size) { _size = size; }
+
+private:
+    T* _data;
+    size_t _size;
+};
+
+#endif // SPAN_H
@@ -2,6 +2,9 @@
 #define STATUS_DATA_H
 
 #include <ArduinoJson.h>
+#include <vector>
+#include "RemoteTiming.h"
+#include "PollMetrics.h"
 
 /**
  * StatusData represents current system status and statistics
@@ -9,10 +12,23 @@
 class StatusData {
 public:
     uint32_t uptime;            // System uptime in seconds
-    uint32_t uart1_sent;        // UART1 bytes sent
-    uint32_t uart1_received;    // UART1 bytes received
-    uint32_t uart2_sent;        // UART2 bytes sent
-    uint32_t uart2_received;    // UART2 bytes received
+    uint32_t uart1_sent;        // UART1 frames sent
+    uint32_t uart1_received;    // UART1 frames received
+    uint32_t uart2_sent;        // UART2 frames sent
+    uint32_t uart2_received;    // UART2 frames received
+    uint32_t uart2_duplicates_avoided; // UART2 reads merged into an in-flight request
+    uint32_t uart2_timeouts;    // UART2 requests that timed out
+    uint32_t uart2_late_responses; // UART2 responses slower than their adaptive timeout
+    uint32_t uart2_timeout_ms;  // Response timeout currently applied on UART2
+    uint32_t uart2_timeout_min; // Adaptive timeout floor
+    uint32_t uart2_timeout_max; // Adaptive timeout ceiling
+    std::vector<RemoteTiming> com2_remotes; // Per remote address round-trip statistics
+    PollMetrics poll;           // Polling cycle statistics (without per-group detail)
+    HistogramSnapshot com1_fc03_service_us; // COM1 FC03 handler service time
+    HistogramSnapshot com1_fc06_service_us; // COM1 FC06 handler service time
+    HistogramSnapshot com2_fc03_rtt_us;     // COM2 FC03 round-trip time
+    HistogramSnapshot com2_fc06_rtt_us;     // COM2 FC06 round-trip time
+    HistogramSnapshot com2_queue_wait_us;   // COM2 eModbus queue wait time
     String eth_status;          // Ethernet status (connected/disconnected)
     String eth_ip;              // Ethernet IP address
     size_t ongoing_requests;    // Number of ongoing Modbus requests
@@ -20,7 +36,9 @@ public:
     
     StatusData() 
         : uptime(0), uart1_sent(0), uart1_received(0), 
-          uart2_sent(0), uart2_received(0),
+          uart2_sent(0), uart2_received(0), uart2_duplicates_avoided(0),
+          uart2_timeouts(0), uart2_late_responses(0), uart2_timeout_ms(0),
+          uart2_timeout_min(0), uart2_timeout_max(0),
           eth_status("unknown"), eth_ip("0.0.0.0"),
           ongoing_requests(0), poll_delay_ms(0) {}
     
@@ -31,10 +49,35 @@ public:
         obj["uart1_recived"] = uart1_received;  // Note: API uses "recived"
         obj["uart2_sent"] = uart2_sent;
         obj["uart2_recived"] = uart2_received;
+        obj["uart2_duplicates_avoided"] = uart2_duplicates_avoided;
+        obj["uart2_timeouts"] = uart2_timeouts;
+        obj["uart2_late_responses"] = uart2_late_responses;
+        obj["uart2_timeout_ms"] = uart2_timeout_ms;
         obj["eth_status"] = eth_status;
         obj["eth_ip"] = eth_ip;
         obj["ongoing_requests"] = ongoing_requests;
         obj["poll_delay_ms"] = poll_delay_ms;
+        
+        auto latencyObj = obj.createNestedObject("latency");
+        auto fc03ServiceObj = latencyObj.createNestedObject("com1_fc03_service_us");
+        com1_fc03_service_us.toJson(fc03ServiceObj);
+        auto fc06ServiceObj = latencyObj.createNestedObject("com1_fc06_service_us");
+        com1_fc06_service_us.toJson(fc06ServiceObj);
+        auto fc03RttObj = latencyObj.createNestedObject("com2_fc03_rtt_us");
+        com2_fc03_rtt_us.toJson(fc03RttObj);
+        auto fc06RttObj = latencyObj.createNestedObject("com2_fc06_rtt_us");
+        com2_fc06_rtt_us.toJson(fc06RttObj);
+        auto queueWaitObj = latencyObj.createNestedObject("com2_queue_wait_us");
+        com2_queue_wait_us.toJson(queueWaitObj);
+        
+        auto pollObj = obj.createNestedObject("poll");
+        poll.toJson(pollObj, false);
+        
+        auto remotesArray = obj.createNestedArray("com2_remotes");
+        for (const auto& remote : com2_remotes) {
+            auto remoteObj = remotesArray.createNestedObject();
+            remote.toJson(remoteObj, uart2_timeout_min, uart2_timeout_max);
+        }
     }
 };
 
@@ -0,0 +1,167 @@
+#ifndef TELEMETRY_DATA_H
+#define TELEMETRY_DATA_H
+
+#include <ArduinoJson.h>
+#include <vector>
+
+/**
+ * TelemetrySample is one periodic heap measurement
+ */
+class TelemetrySample {
+public:
+    uint32_t timestampMs;       // millis() when sampled
+    uint32_t freeHeap;          // Free heap (bytes)
+    uint32_t largestBlock;      // Largest allocatable block (bytes)
+    uint32_t minFreeHeap;       // Lowest free heap since boot (bytes)
+
+    TelemetrySample() : timestampMs(0), freeHeap(0), largestBlock(0), minFreeHeap(0) {}
+
+    // Share of free heap not usable as one block (0-100)
+    uint8_t fragmentationPct() const {
+        if (freeHeap == 0) return 0;
+        return 100 - (uint8_t)((uint64_t)largestBlock * 100 / freeHeap);
+    }
+
+    // Serialize to JSON
+    void toJson(JsonObject& obj) const {
+        obj["t"] = timestampMs;
+        obj["free_heap"] = freeHeap;
+        obj["largest_block"] = largestBlock;
+        obj["min_free_heap"] = minFreeHeap;
+        obj["fragmentation_pct"] = fragmentationPct();
+    }
+};
+
+/**
+ * TaskStackInfo is the stack high-water mark of one watched task
+ */
+class TaskStackInfo {
+public:
+    String name;
+    uint32_t stackFreeMin;      // Lowest unused stack seen (bytes)
+
+    TaskStackInfo() : stackFreeMin(0) {}
+
+    // Serialize to JSON
+    void toJson(JsonObject& obj) const {
+        obj["name"] = name;
+        obj["stack_free_min"] = stackFreeMin;
+    }
+};
+
+/**
+ * SubsystemAllocations attributes heap growth to a subsystem
+ * Deltas are free-heap differences around instrumented calls, so allocations
+ * made concurrently by other tasks can be counted too
+ */
+class SubsystemAllocations {
+public:
+    String name;
+    uint32_t calls;             // Instrumented calls
+    int32_t netBytes;           // Heap retained over all calls (negative = released)
+    int32_t lastBytes;          // Heap retained by the last call
+    uint32_t maxBytes;          // Largest growth of a single call
+
+    SubsystemAllocations() : calls(0), netBytes(0), lastBytes(0), maxBytes(0) {}
+
+    // Serialize to JSON
+    void toJson(JsonObject& obj) const {
+        obj["name"] = name;
+        obj["calls"] = calls;
+        obj["net_bytes"] = netBytes;
+        obj["last_bytes"] = lastBytes;
+        obj["max_bytes"] = maxBytes;
+    }
+};
+
+/**
+ * TelemetryData is the report served by /api/telemetry
+ */
+class TelemetryData {
+public:
+    uint32_t intervalMs;            // Sampling period
+    uint32_t heapSize;              // Total heap (bytes)
+    uint32_t sampleCount;           // Samples in the ring buffer
+    TelemetrySample current;        // Measured now
+    uint32_t windowMinFreeHeap;     // Lowest free heap in the ring buffer
+    uint32_t windowMinLargestBlock; // Smallest largest-block in the ring buffer
+    uint8_t windowMaxFragmentationPct;
+    int32_t freeHeapTrend;          // Free heap change per minute over the ring buffer (bytes)
+    uint32_t nameBytes;             // Name arena in use (bytes)
+    uint32_t nameCapacity;          // Name arena limit (bytes)
+    uint32_t nameCount;             // Distinct names in the arena
+    uint32_t namesReused;           // Names interned again instead of stored twice
+    uint32_t jsonArenaBytes;        // JSON pool arena (bytes)
+    bool jsonArenaPsram;            // Arena in PSRAM rather than internal RAM
+    uint32_t jsonUsedBytes;         // Arena blocks held by documents now
+    uint32_t jsonPeakBytes;         // High-water mark of the above
+    uint32_t jsonDocuments;         // Documents alive now
+    uint32_t jsonPeakDocuments;
+    uint32_t jsonMaxDocuments;
+    uint32_t jsonFallbacks;         // Allocations the arena could not serve (went to the heap)
+    uint32_t jsonRejected;          // API requests answered 503 because every document was taken
+    std::vector<TelemetrySample> samples;   // Oldest first, only when requested
+    std::vector<TaskStackInfo> tasks;
+    std::vector<SubsystemAllocations> subsystems;
+
+    TelemetryData()
+        : intervalMs(0), heapSize(0), sampleCount(0), windowMinFreeHeap(0), windowMinLargestBlock(0),
+          windowMaxFragmentationPct(0), freeHeapTrend(0), nameBytes(0), nameCapacity(0), nameCount(0),
+          namesReused(0), jsonArenaBytes(0), jsonArenaPsram(false), jsonUsedBytes(0), jsonPeakBytes(0),
+          jsonDocuments(0), jsonPeakDocuments(0), jsonMaxDocuments(0), jsonFallbacks(0), jsonRejected(0) {}
+
+    // Serialize to JSON
+    void toJson(JsonObject& obj) const {
+        obj["interval_ms"] = intervalMs;
+        obj["heap_size"] = heapSize;
+
+        auto currentObj = obj.createNestedObject("current");
+        current.toJson(currentObj);
+
+        auto windowObj = obj.createNestedObject("window");
+        windowObj["samples"] = sampleCount;
+        windowObj["min_free_heap"] = windowMinFreeHeap;
+        windowObj["min_largest_block"] = windowMinLargestBlock;
+        windowObj["max_fragmentation_pct"] = windowMaxFragmentationPct;
+        windowObj["free_heap_trend_per_min"] = freeHeapTrend;
+
+        auto namesObj = obj.createNestedObject("names");
+        namesObj["bytes"] = nameBytes;
+        namesObj["capacity"] = nameCapacity;
+        namesObj["count"] = nameCount;
+        namesObj["reused"] = namesReused;
+
+        auto jsonObj = obj.createNestedObject("json_pool");
+        jsonObj["arena_bytes"] = jsonArenaBytes;
+        jsonObj["psram"] = jsonArenaPsram;
+        jsonObj["used_bytes"] = jsonUsedBytes;
+        jsonObj["peak_bytes"] = jsonPeakBytes;
+        jsonObj["documents"] = jsonDocuments;
+        jsonObj["peak_documents"] = jsonPeakDocuments;
+        jsonObj["max_documents"] = jsonMaxDocuments;
+        jsonObj["fallbacks"] = jsonFallbacks;
+        jsonObj["rejected"] = jsonRejected;
+
+        if (!samples.empty()) {
+            auto samplesArray = obj.createNestedArray("samples");
+            for (const auto& sample : samples) {
+                auto sampleObj = samplesArray.createNestedObject();
+                sample.toJson(sampleObj);
+            }
+        }
+
+        auto tasksArray = obj.createNestedArray("tasks");
+        for (const auto& task : tasks) {
+            auto taskObj = tasksArray.createNestedObject();
+            task.toJson(taskObj);
+        }
+
+        auto subsystemsArray = obj.createNestedArray("subsystems");
+        for (const auto& subsystem : subsystems) {
+            auto subsystemObj = subsystemsArray.createNestedObject();
+            subsystem.toJson(subsystemObj);
+        }
+    }
+};
+
+#endif // TELEMETRY_DATA_H
@@ -0,0 +1,413 @@
+#include "ConfigCodec.h"
+#include "NamePool.h"
+#include "TemplatePool.h"
+#include <string.h>
+
+namespace {
+
+void put8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+void put16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(value & 0xFF);
+    out.push_back(value >> 8);
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t value) {
+    put16(out, value & 0xFFFF);
+    put16(out, value >> 16);
+}
+
+uint16_t get16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+uint32_t get32(const uint8_t* p) {
+    return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+// Append a name to the blob, returns false once offsets no longer fit 16 bits
+bool putName(std::vector<uint8_t>& names, const NameRef& name, uint16_t& offset) {
+    if (names.size() + name.length() + 1 > 0xFFFF) return false;
+    offset = names.size();
+    names.insert(names.end(), name.c_str(), name.c_str() + name.length());
+    names.push_back('\0');
+    return true;
+}
+
+// Names in a mapped flash segment are referenced in place, anything else is interned
+NameRef name(const char* names, uint16_t offset, uint8_t segment) {
+    return segment == NamePool::RAM_SEGMENT ? NameRef(names + offset) : NameRef::mapped(segment, offset);
+}
+
+// Distinct slave templates in storage order (first use, including kept templates of empty groups)
+FixedVector<RegisterTemplate*, MODBUS_MAX_TEMPLATES> collectTemplates(const GroupList& groups) {
+    FixedVector<RegisterTemplate*, MODBUS_MAX_TEMPLATES> templates;
+    auto add = [&templates](RegisterTemplate* tmpl) {
+        for (auto* known : templates) {
+            if (known == tmpl) return;
+        }
+        templates.push_back(tmpl);
+    };
+    for (const auto& group : groups) {
+        for (const auto& slave : group.slaves) {
+            add(slave.registerTemplate.get());
+        }
+        if (group.slaves.empty() && group.slaveTemplate) {
+            add(group.slaveTemplate.get());
+        }
+    }
+    return templates;
+}
+
+// Decoding ran out of template blocks or name space after the list was cleared, it stays empty
+bool poolExhausted(GroupList& groups, const char* pool) {
+    Serial.printf("[ConfigCodec] %s pool exhausted\n", pool);
+    groups.clear();
+    return false;
+}
+
+uint16_t templateIndex(const FixedVector<RegisterTemplate*, MODBUS_MAX_TEMPLATES>& templates,
+                       const RegisterTemplate* tmpl) {
+    for (size_t i = 0; i < templates.size(); i++) {
+        if (templates[i] == tmpl) return i;
+    }
+    return ConfigCodec::NO_TEMPLATE;
+}
+
+// Table positions of a version 1 or 2 configuration, from its header
+struct Layout {
+    uint16_t version;
+    size_t headerSize;
+    size_t groupSize;
+    uint32_t seq;
+    size_t templateCount;
+    size_t groupCount;
+    size_t slaveCount;
+    size_t registerCount;
+    size_t namesSize;
+    size_t size;            // Header and body
+    uint32_t crc;
+};
+
+bool readLayout(const uint8_t* data, size_t maxSize, Layout& layout) {
+    if (maxSize < 28 || get32(data) != ConfigCodec::MAGIC) return false;
+
+    layout.version = get16(data + 4);
+    layout.headerSize = get16(data + 6);
+    if (layout.version == 1 && layout.headerSize == 28) {
+        layout.groupSize = 8;
+        layout.templateCount = 0;
+    } else if (layout.version == 2 && layout.headerSize == ConfigCodec::HEADER_SIZE) {
+        if (maxSize < ConfigCodec::HEADER_SIZE) return false;
+        layout.groupSize = ConfigCodec::GROUP_SIZE;
+        layout.templateCount = get16(data + 24);
+    } else {
+        return false;
+    }
+
+    layout.seq = get32(data + 8);
+    layout.groupCount = get16(data + 12);
+    layout.slaveCount = get16(data + 14);
+    layout.registerCount = get32(data + 16);
+    layout.namesSize = get32(data + 20);
+    layout.crc = get32(data + layout.headerSize - 4);
+
+    // Bound the 32-bit counts by the buffer first so the sum below cannot overflow
+    if (layout.registerCount > maxSize / ConfigCodec::REGISTER_SIZE || layout.namesSize > maxSize) return false;
+    layout.size = layout.headerSize + layout.templateCount * ConfigCodec::TEMPLATE_SIZE +
+                  layout.groupCount * layout.groupSize + layout.slaveCount * ConfigCodec::SLAVE_SIZE +
+                  layout.registerCount * ConfigCodec::REGISTER_SIZE + layout.namesSize;
+    return layout.size <= maxSize;
+}
+
+bool checksumMatches(const uint8_t* data, const Layout& layout) {
+    uint32_t crc = ConfigCodec::crc32(data + layout.headerSize, layout.size - layout.headerSize);
+    return ConfigCodec::crc32(data, layout.headerSize - 4, crc) == layout.crc;
+}
+
+}  // namespace
+
+uint32_t ConfigCodec::crc32(const uint8_t* data, size_t size, uint32_t previous) {
+    uint32_t crc = ~previous;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+bool ConfigCodec::encode(const GroupList& groups, uint32_t seq, std::vector<uint8_t>& out) {
+    auto templates = collectTemplates(groups);
+
+    size_t slaveCount = 0;
+    size_t registerCount = 0;
+    for (const auto* tmpl : templates) {
+        registerCount += tmpl->registers.size();
+    }
+    for (const auto& group : groups) {
+        slaveCount += group.slaves.size();
+        registerCount += group.registers.size();
+    }
+
+    std::vector<uint8_t> names;
+    std::vector<uint8_t> body;
+    body.reserve(templates.size() * TEMPLATE_SIZE + groups.size() * GROUP_SIZE + slaveCount * SLAVE_SIZE +
+                 registerCount * REGISTER_SIZE);
+
+    // Tables in order: templates, groups, slaves, registers
+    for (const auto* tmpl : templates) {
+        uint16_t nameOffset;
+        if (!putName(names, tmpl->name, nameOffset)) return false;
+        put16(body, tmpl->registers.size());
+        put16(body, nameOffset);
+    }
+    for (const auto& group : groups) {
+        uint16_t nameOffset;
+        if (!putName(names, group.name, nameOffset)) return false;
+        put8(body, group.id);
+        put8(body, group.remoteAddress);
+        put8(body, group.slaves.size());
+        put8(body, 0);
+        put16(body, group.registers.size());
+        put16(body, nameOffset);
+        put16(body, group.slaves.empty() && group.slaveTemplate
+                        ? templateIndex(templates, group.slaveTemplate.get()) : NO_TEMPLATE);
+    }
+    for (const auto& group : groups) {
+        for (const auto& slave : group.slaves) {
+            uint16_t index = templateIndex(templates, slave.registerTemplate.get());
+            if (index == NO_TEMPLATE) return false;     // More than MODBUS_MAX_TEMPLATES templates
+            put8(body, slave.id);
+            put8(body, 0);
+            put16(body, index);
+        }
+    }
+    for (const auto* tmpl : templates) {
+        for (const auto& reg : tmpl->registers) {
+            uint16_t nameOffset;
+            if (!putName(names, reg.name, nameOffset)) return false;
+            put16(body, reg.id);
+            put16(body, nameOffset);
+        }
+    }
+    for (const auto& group : groups) {
+        for (const auto& reg : group.registers) {
+            uint16_t nameOffset;
+            if (!putName(names, reg.name, nameOffset)) return false;
+            put16(body, reg.id);
+            put16(body, nameOffset);
+        }
+    }
+    body.insert(body.end(), names.begin(), names.end());
+
+    out.clear();
+    out.reserve(HEADER_SIZE + body.size());
+    put32(out, MAGIC);
+    put16(out, VERSION);
+    put16(out, HEADER_SIZE);
+    put32(out, seq);
+    put16(out, groups.size());
+    put16(out, slaveCount);
+    put32(out, registerCount);
+    put32(out, names.size());
+    put16(out, templates.size());
+    put16(out, 0);
+    out.insert(out.end(), body.begin(), body.end());
+
+    uint32_t crc = crc32(out.data(), HEADER_SIZE - 4, crc32(body.data(), body.size()));
+    out.insert(out.begin() + HEADER_SIZE - 4, {(uint8_t)crc, (uint8_t)(crc >> 8), (uint8_t)(crc >> 16), (uint8_t)(crc >> 24)});
+    return true;
+}
+
+size_t ConfigCodec::check(const uint8_t* data, size_t maxSize, uint32_t& seq) {
+    Layout layout;
+    if (!readLayout(data, maxSize, layout) || !checksumMatches(data, layout)) return 0;
+
+    seq = layout.seq;
+    return layout.size;
+}
+
+void ConfigCodec::linkNames(const uint8_t* data, GroupList& groups, uint8_t segment) {
+    auto templates = collectTemplates(groups);
+    size_t groupCount = get16(data + 12);
+    size_t slaveCount = get16(data + 14);
+    size_t registerCount = get32(data + 16);
+    const uint8_t* templateRec = data + HEADER_SIZE;
+    const uint8_t* groupRec = templateRec + templates.size() * TEMPLATE_SIZE;
+    const uint8_t* regRec = groupRec + groupCount * GROUP_SIZE + slaveCount * SLAVE_SIZE;
+    NamePool::mapSegment(segment, (const char*)(regRec + registerCount * REGISTER_SIZE));
+
+    // Same order as encode()
+    for (auto* tmpl : templates) {
+        tmpl->name.relink(NameRef::mapped(segment, get16(templateRec + 2)));
+        templateRec += TEMPLATE_SIZE;
+    }
+    for (auto& group : groups) {
+        group.name.relink(NameRef::mapped(segment, get16(groupRec + 6)));
+        groupRec += GROUP_SIZE;
+    }
+    for (auto* tmpl : templates) {
+        for (auto& reg : tmpl->registers) {
+            reg.name.relink(NameRef::mapped(segment, get16(regRec + 2)));
+            regRec += REGISTER_SIZE;
+        }
+    }
+    for (auto& group : groups) {
+        for (auto& reg : group.registers) {
+            reg.name.relink(NameRef::mapped(segment, get16(regRec + 2)));
+            regRec += REGISTER_SIZE;
+        }
+    }
+}
+
+bool ConfigCodec::decode(const uint8_t* data, size_t size, GroupList& groups, uint32_t& seq,
+                         uint8_t segment) {
+    if (size < 28 || get32(data) != MAGIC) {
+        Serial.println("[ConfigCodec] Not a configuration file");
+        return false;
+    }
+
+    Layout layout;
+    if (!readLayout(data, size, layout) || layout.size != size) {
+        Serial.printf("[ConfigCodec] Unsupported version %u or size mismatch\n", get16(data + 4));
+        return false;
+    }
+    if (!checksumMatches(data, layout)) {
+        Serial.println("[ConfigCodec] Checksum mismatch");
+        return false;
+    }
+
+    const uint8_t* templateTable = data + layout.headerSize;
+    const uint8_t* groupTable = templateTable + layout.templateCount * TEMPLATE_SIZE;
+    const uint8_t* slaveTable = groupTable + layout.groupCount * layout.groupSize;
+    const uint8_t* registerTable = slaveTable + layout.slaveCount * SLAVE_SIZE;
+    const char* names = (const char*)(registerTable + layout.registerCount * REGISTER_SIZE);
+    size_t namesSize = layout.namesSize;
+    bool v1 = layout.version == 1;
+
+    if (namesSize > 0 && names[namesSize - 1] != '\0') {
+        Serial.println("[ConfigCodec] Unterminated name blob");
+        return false;
+    }
+
+    // Check the tables add up and fit the MODBUS_MAX_* limits before building anything
+    if (layout.groupCount > MODBUS_MAX_GROUPS || layout.templateCount > MODBUS_MAX_TEMPLATES ||
+        layout.slaveCount > MODBUS_MAX_TOTAL_SLAVES) {
+        Serial.println("[ConfigCodec] Configuration exceeds the capacity limits");
+        return false;
+    }
+    size_t slavesSeen = 0;
+    size_t registersSeen = 0;
+    size_t valuesSeen = 0;
+    for (size_t t = 0; t < layout.templateCount; t++) {
+        const uint8_t* rec = templateTable + t * TEMPLATE_SIZE;
+        if (get16(rec + 2) >= namesSize || get16(rec) > MODBUS_MAX_SLAVE_REGISTERS) return false;
+        registersSeen += get16(rec);
+    }
+    for (size_t g = 0; g < layout.groupCount; g++) {
+        const uint8_t* rec = groupTable + g * layout.groupSize;
+        if (get16(rec + 6) >= namesSize) return false;
+        if (!v1 && get16(rec + 8) != NO_TEMPLATE && get16(rec + 8) >= layout.templateCount) return false;
+        if (rec[2] > MODBUS_MAX_SLAVES || get16(rec + 4) > MODBUS_MAX_GROUP_REGISTERS) {
+            Serial.println("[ConfigCodec] Group exceeds the capacity limits");
+            return false;
+        }
+        registersSeen += get16(rec + 4);
+        for (size_t s = 0; s < rec[2]; s++) {
+            if (slavesSeen >= layout.slaveCount) return false;
+            uint16_t value = get16(slaveTable + slavesSeen * SLAVE_SIZE + 2);
+            if (v1) {
+                if (value > MODBUS_MAX_SLAVE_REGISTERS) return false;
+                registersSeen += value;         // Register count
+                valuesSeen += value;
+            } else if (value >= layout.templateCount) {
+                return false;                   // Template index
+            } else {
+                valuesSeen += get16(templateTable + value * TEMPLATE_SIZE);
+            }
+            slavesSeen++;
+        }
+    }
+    if (slavesSeen != layout.slaveCount || registersSeen != layout.registerCount) {
+        Serial.println("[ConfigCodec] Table counts do not match");
+        return false;
+    }
+    if (valuesSeen > MODBUS_MAX_SLAVE_VALUES) {
+        Serial.println("[ConfigCodec] Slave registers exceed the capacity limits");
+        return false;
+    }
+    for (size_t r = 0; r < layout.registerCount; r++) {
+        if (get16(registerTable + r * REGISTER_SIZE + 2) >= namesSize) return false;
+    }
+
+    // Everything fits, build in place
+    uint32_t namesRejected = NamePool::getRejectedCount();
+    NamePool::mapSegment(segment, names);
+    const uint8_t* regRec = registerTable;
+    FixedVector<RegisterTemplatePtr, MODBUS_MAX_TEMPLATES> templates;
+    for (size_t t = 0; t < layout.templateCount; t++) {
+        const uint8_t* rec = templateTable + t * TEMPLATE_SIZE;
+        RegisterTemplatePtr tmpl = TemplatePool::create(name(names, get16(rec + 2), segment));
+        if (!tmpl) return poolExhausted(groups, "Template");
+        templates.push_back(tmpl);
+        auto& registers = templates.back()->registers;
+
+        size_t count = get16(rec);
+        for (size_t r = 0; r < count; r++, regRec += REGISTER_SIZE) {
+            registers.emplace_back(get16(regRec), name(names, get16(regRec + 2), segment));
+        }
+    }
+
+    groups.clear();
+    const uint8_t* slaveRec = slaveTable;
+
+    for (size_t g = 0; g < layout.groupCount; g++) {
+        const uint8_t* rec = groupTable + g * layout.groupSize;
+        groups.emplace_back(rec[0], rec[1], name(names, get16(rec + 6), segment));
+        Group& group = groups.back();
+
+        size_t groupRegisters = get16(rec + 4);
+        for (size_t r = 0; r < groupRegisters; r++, regRec += REGISTER_SIZE) {
+            group.registers.emplace_back(get16(regRec), name(names, get16(regRec + 2), segment));
+        }
+        if (!v1 && get16(rec + 8) != NO_TEMPLATE) {
+            group.slaveTemplate = templates[get16(rec + 8)];
+        }
+
+        for (size_t s = 0; s < rec[2]; s++, slaveRec += SLAVE_SIZE) {
+            if (!v1) {
+                groups.appendSlave(group, slaveRec[0], templates[get16(slaveRec + 2)]);
+                continue;
+            }
+
+            // Version 1: every slave lists its own registers, merged with an identical
+            // slave right away so the pool only holds one unshared template
+            auto tmpl = TemplatePool::create();
+            if (!tmpl) return poolExhausted(groups, "Template");
+            size_t slaveRegisters = get16(slaveRec + 2);
+            for (size_t r = 0; r < slaveRegisters; r++, regRec += REGISTER_SIZE) {
+                tmpl->registers.emplace_back(get16(regRec), name(names, get16(regRec + 2), segment));
+            }
+            for (const auto& other : group.slaves) {
+                if (other.registerTemplate->sameRegisters(*tmpl)) {
+                    tmpl = other.registerTemplate;
+                    break;
+                }
+            }
+            groups.appendSlave(group, slaveRec[0], tmpl);
+        }
+
+        // Version 2 stores templates once, version 1 slaves are merged over the groups as well
+        if (v1) {
+            Group::shareTemplates(groups);
+        }
+    }
+    if (NamePool::getRejectedCount() != namesRejected) return poolExhausted(groups, "Name");
+
+    seq = layout.seq;
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef CONFIG_CODEC_H
+#define CONFIG_CODEC_H
+
+#include <Arduino.h>
+#include <vector>
+#include "../models/Group.h"
+#include "NamePool.h"
+
+/**
+ * ConfigCodec converts the Modbus configuration to and from its binary storage format
+ *
+ * Little-endian, version 2:
+ *   Header    magic "HVCF", u16 version, u16 header size, u32 seq,
+ *             u16 groups, u16 slaves, u32 registers, u32 name blob size, u16 templates, u16 reserved,
+ *             u32 CRC-32 of the body followed by the header fields before it
+ *   Templates u16 register count, u16 name offset
+ *   Groups    u8 id, u8 remote address, u8 slave count, u8 reserved, u16 register count, u16 name offset,
+ *             u16 template for new slaves (only stored without slaves, 0xFFFF = none)
+ *   Slaves    u8 id, u8 reserved, u16 template index   (all slaves of group 0, then group 1, ...)
+ *   Registers u16 id, u16 name offset                  (each template's, then each group's)
+ *   Names     null-terminated strings, referenced by offset
+ *
+ * Version 1 (still read) has no templates: a 28-byte header without the template count,
+ * 8-byte group records, a register count instead of the template index per slave, and
+ * the registers of every slave after those of its group.
+ *
+ * Every count and offset is checked against the buffer before anything is allocated,
+ * so a truncated or corrupted file is rejected as a whole.
+ */
+class ConfigCodec {
+public:
+    static constexpr uint32_t MAGIC = 0x46435648;   // "HVCF"
+    static constexpr uint16_t VERSION = 2;
+    static constexpr size_t HEADER_SIZE = 32;
+    static constexpr size_t TEMPLATE_SIZE = 4;
+    static constexpr size_t GROUP_SIZE = 10;
+    static constexpr size_t SLAVE_SIZE = 4;
+    static constexpr size_t REGISTER_SIZE = 4;
+    static constexpr uint16_t NO_TEMPLATE = 0xFFFF;
+    
+    /**
+     * Serialize groups (without values), returns false if the names exceed 64 KiB
+     * or the slaves use more than MODBUS_MAX_TEMPLATES distinct templates
+     * Templates shared by slaves are stored once
+     */
+    static bool encode(const GroupList& groups, uint32_t seq, std::vector<uint8_t>& out);
+    
+    /**
+     * Validate and deserialize, groups is only modified on success (or left empty if
+     * the template or name pool runs out, which the table checks cannot foresee)
+     * segment: a NamePool flash segment if data stays valid (mapped flash), names then point
+     * into it instead of being interned in RAM
+     */
+    static bool decode(const uint8_t* data, size_t size, GroupList& groups, uint32_t& seq,
+                       uint8_t segment = NamePool::RAM_SEGMENT);
+    
+    /**
+     * Check header and checksum of an encoded configuration at the start of a region
+     * of up to maxSize bytes. Returns its size (0 if there is no valid configuration)
+     */
+    static size_t check(const uint8_t* data, size_t maxSize, uint32_t& seq);
+    
+    /**
+     * Point the names of groups at the name blob of data (mapped as a NamePool flash
+     * segment), which must have been encoded from exactly these groups
+     * Groups are relinked on a copy nobody else reads (see ModbusService::flush); the register
+     * templates are shared with the published list, their names switch atomically (NameRef::relink)
+     */
+    static void linkNames(const uint8_t* data, GroupList& groups, uint8_t segment);
+    
+    /**
+     * CRC-32 (IEEE), previous continues a checksum over several buffers
+     */
+    static uint32_t crc32(const uint8_t* data, size_t size, uint32_t previous = 0);
+};
+
+#endif // CONFIG_CODEC_H
@@ -0,0 +1,168 @@
+#include "ConfigPartition.h"
+#include "ConfigCodec.h"
+#include "../config.h"
+
+#ifdef ARDUINO
+#include <esp_partition.h>
+#include <esp_idf_version.h>
+#else
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Static member initialization
+const uint8_t* ConfigPartition::base = nullptr;
+size_t ConfigPartition::slotSize = 0;
+int ConfigPartition::currentSlot = -1;
+
+static constexpr size_t SECTOR_SIZE = 4096;
+
+#ifdef ARDUINO
+
+static const esp_partition_t* partition = nullptr;
+
+bool ConfigPartition::platformMap(size_t& partitionSize) {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                         (esp_partition_subtype_t)CONFIG_PARTITION_SUBTYPE,
+                                         CONFIG_PARTITION_LABEL);
+    if (!partition) return false;
+
+    const void* mapped = nullptr;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &handle);
+#else
+    spi_flash_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &mapped, &handle);
+#endif
+    if (err != ESP_OK) {
+        Serial.printf("[ConfigPartition] mmap failed: %d\n", (int)err);
+        return false;
+    }
+
+    // Mapped for the lifetime of the firmware, the handle is never released
+    base = (const uint8_t*)mapped;
+    partitionSize = partition->size;
+    return true;
+}
+
+bool ConfigPartition::platformErase(size_t offset, size_t length) {
+    return esp_partition_erase_range(partition, offset, length) == ESP_OK;
+}
+
+bool ConfigPartition::platformWrite(size_t offset, const uint8_t* data, size_t length) {
+    return esp_partition_write(partition, offset, data, length) == ESP_OK;
+}
+
+#else
+
+static int hostFd = -1;
+
+bool ConfigPartition::platformMap(size_t& partitionSize) {
+    const char* path = getenv("HVAC_CONFIG_PARTITION");
+    if (!path) path = CONFIG_PARTITION_HOST_FILE;
+
+    hostFd = open(path, O_RDWR | O_CREAT, 0644);
+    if (hostFd < 0) return false;
+
+    // A new file starts out erased, like fresh flash
+    off_t existing = lseek(hostFd, 0, SEEK_END);
+    if (existing < (off_t)CONFIG_PARTITION_HOST_SIZE) {
+        uint8_t erased[SECTOR_SIZE];
+        memset(erased, 0xFF, sizeof(erased));
+        for (off_t pos = existing; pos < (off_t)CONFIG_PARTITION_HOST_SIZE; pos += SECTOR_SIZE) {
+            if (pwrite(hostFd, erased, SECTOR_SIZE, pos) != (ssize_t)SECTOR_SIZE) return false;
+        }
+    }
+
+    void* mapped = mmap(nullptr, CONFIG_PARTITION_HOST_SIZE, PROT_READ, MAP_SHARED, hostFd, 0);
+    if (mapped == MAP_FAILED) return false;
+
+    base = (const uint8_t*)mapped;
+    partitionSize = CONFIG_PARTITION_HOST_SIZE;
+    return true;
+}
+
+bool ConfigPartition::platformErase(size_t offset, size_t length) {
+    uint8_t erased[SECTOR_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    for (size_t pos = 0; pos < length; pos += SECTOR_SIZE) {
+        if (pwrite(hostFd, erased, SECTOR_SIZE, offset + pos) != (ssize_t)SECTOR_SIZE) return false;
+    }
+    return true;
+}
+
+bool ConfigPartition::platformWrite(size_t offset, const uint8_t* data, size_t length) {
+    return pwrite(hostFd, data, length, offset) == (ssize_t)length;
+}
+
+#endif
+
+bool ConfigPartition::begin() {
+    if (base) return true;
+
+    size_t partitionSize = 0;
+    if (!platformMap(partitionSize)) {
+        Serial.println("[ConfigPartition] No configuration partition, using SPIFFS");
+        base = nullptr;
+        return false;
+    }
+
+    slotSize = (partitionSize / 2) & ~(SECTOR_SIZE - 1);
+
+    size_t size;
+    uint32_t seq;
+    current(size, seq);
+    Serial.printf("[ConfigPartition] Mapped %u bytes, 2 slots of %u bytes, current slot %d\n",
+                  (unsigned)partitionSize, (unsigned)slotSize, currentSlot);
+    return true;
+}
+
+const uint8_t* ConfigPartition::current(size_t& size, uint32_t& seq) {
+    if (!base) return nullptr;
+
+    uint32_t seqs[2];
+    size_t sizes[2];
+    for (int slot = 0; slot < 2; slot++) {
+        sizes[slot] = ConfigCodec::check(base + slot * slotSize, slotSize, seqs[slot]);
+    }
+
+    if (sizes[0] && sizes[1]) {
+        currentSlot = seqs[1] > seqs[0] ? 1 : 0;
+    } else if (sizes[0] || sizes[1]) {
+        currentSlot = sizes[0] ? 0 : 1;
+    } else {
+        currentSlot = -1;
+        return nullptr;
+    }
+
+    size = sizes[currentSlot];
+    seq = seqs[currentSlot];
+    return base + currentSlot * slotSize;
+}
+
+const uint8_t* ConfigPartition::write(const uint8_t* data, size_t size) {
+    if (!base || size > slotSize) return nullptr;
+
+    int target = currentSlot == 0 ? 1 : 0;
+    size_t offset = target * slotSize;
+    size_t eraseLength = (size + SECTOR_SIZE - 1) & ~(SECTOR_SIZE - 1);
+
+    if (!platformErase(offset, eraseLength) || !platformWrite(offset, data, size)) {
+        Serial.println("[ConfigPartition] Error: Could not write checkpoint");
+        return nullptr;
+    }
+
+    // Verify through the mapping, this is also what the names will be linked to
+    uint32_t seq;
+    if (ConfigCodec::check(base + offset, slotSize, seq) != size) {
+        Serial.println("[ConfigPartition] Error: Checkpoint did not verify");
+        return nullptr;
+    }
+
+    currentSlot = target;
+    return base + offset;
+}
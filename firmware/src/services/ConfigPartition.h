@@ -0,0 +1,61 @@
+#ifndef CONFIG_PARTITION_H
+#define CONFIG_PARTITION_H
+
+#include <Arduino.h>
+
+/**
+ * ConfigPartition stores the binary configuration checkpoint in the "hvaccfg" data partition
+ *
+ * The partition is split into two slots that are written alternately, the slot
+ * with the valid checkpoint with the highest sequence number is current. The
+ * whole partition is memory-mapped once, so the current checkpoint (and the
+ * names in it) can be read in place from flash cache.
+ *
+ * A new checkpoint always goes to the other slot, so the current one stays
+ * valid (and mapped) while it is written. Names linked into a slot stay valid
+ * until that slot is erased, two checkpoints later.
+ *
+ * On a host build the partition is emulated with a memory-mapped file
+ * (CONFIG_PARTITION_HOST_FILE, or $HVAC_CONFIG_PARTITION).
+ */
+class ConfigPartition {
+public:
+    /**
+     * Find and map the partition, false if the partition table has none
+     */
+    static bool begin();
+    
+    static bool isAvailable() { return base != nullptr; }
+    
+    /**
+     * Slot of the current checkpoint (0 or 1), -1 if none
+     */
+    static int getCurrentSlot() { return currentSlot; }
+    
+    /**
+     * The current checkpoint (read-only, mapped), nullptr if no slot holds a valid one
+     */
+    static const uint8_t* current(size_t& size, uint32_t& seq);
+    
+    /**
+     * Erase the other slot and write data into it, returns a pointer to the written
+     * (mapped) copy, or nullptr on failure
+     */
+    static const uint8_t* write(const uint8_t* data, size_t size);
+    
+    /**
+     * Largest checkpoint a slot can hold
+     */
+    static size_t getSlotSize() { return slotSize; }
+    
+private:
+    static const uint8_t* base;     // Mapped partition
+    static size_t slotSize;
+    static int currentSlot;         // -1 = none
+    
+    static bool platformMap(size_t& partitionSize);
+    static bool platformErase(size_t offset, size_t length);
+    static bool platformWrite(size_t offset, const uint8_t* data, size_t length);
+};
+
+#endif // CONFIG_PARTITION_H
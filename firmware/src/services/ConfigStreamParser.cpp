@@ -0,0 +1,207 @@
+#include "ConfigStreamParser.h"
+#include "JsonPool.h"
+
+ConfigStreamParser::ConfigStreamParser(GroupList& groups, size_t maxGroupBytes)
+    : state(START), topLevelArray(false), inString(false), escaped(false), depth(0),
+      maxGroupBytes(maxGroupBytes), peakGroupBytes(0), seq(0), groups(groups), error(nullptr) {
+    groups.clear();
+}
+
+bool ConfigStreamParser::feed(const char* data, size_t length) {
+    for (size_t i = 0; i < length && state != FAILED; i++) {
+        step(data[i]);
+    }
+    return state != FAILED;
+}
+
+bool ConfigStreamParser::finish() {
+    if (state == SCALAR) {
+        endScalar();
+        state = AFTER_VALUE;
+    }
+    if (state == FAILED) return false;
+    if (state != DONE) return fail("Unexpected end of configuration");
+    return true;
+}
+
+bool ConfigStreamParser::step(char c) {
+    switch (state) {
+        case START:
+            if (isWhitespace(c)) return true;
+            if (c == '{') {
+                state = OBJECT_KEY;
+                return true;
+            }
+            if (c == '[') {
+                topLevelArray = true;
+                state = GROUPS;
+                return true;
+            }
+            return fail("Expected an object or an array of groups");
+
+        case OBJECT_KEY:
+            if (isWhitespace(c) || c == ',') return true;
+            if (c == '}') {
+                state = DONE;
+                return true;
+            }
+            if (c == '"') {
+                key = "";
+                escaped = false;
+                state = KEY;
+                return true;
+            }
+            return fail("Expected a key");
+
+        case KEY:
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                state = COLON;
+                return true;
+            }
+            key += c;
+            return true;
+
+        case COLON:
+            if (isWhitespace(c)) return true;
+            if (c != ':') return fail("Expected ':'");
+            state = VALUE;
+            return true;
+
+        case VALUE:
+            if (isWhitespace(c)) return true;
+            if (key == "groups") {
+                if (c != '[') return fail("Expected an array of groups");
+                state = GROUPS;
+                return true;
+            }
+            if (c == '{' || c == '[' || c == '"') {
+                inString = c == '"';
+                escaped = false;
+                depth = inString ? 0 : 1;
+                state = SKIP;
+                return true;
+            }
+            scalar = "";
+            scalar += c;
+            state = SCALAR;
+            return true;
+
+        case SCALAR:
+            if (isWhitespace(c) || c == ',' || c == '}') {
+                endScalar();
+                state = AFTER_VALUE;
+                return step(c);
+            }
+            if (scalar.length() >= 32) return fail("Invalid value");
+            scalar += c;
+            return true;
+
+        case SKIP:
+            if (!trackNesting(c)) return false;
+            if (!inString && depth == 0) state = AFTER_VALUE;
+            return true;
+
+        case GROUPS:
+            if (isWhitespace(c) || c == ',') return true;
+            if (c == ']') {
+                state = topLevelArray ? DONE : AFTER_VALUE;
+                return true;
+            }
+            if (c != '{') return fail("Expected a group object");
+            groupText.clear();
+            groupText.push_back(c);
+            inString = false;
+            escaped = false;
+            depth = 1;
+            state = GROUP;
+            return true;
+
+        case GROUP:
+            if (groupText.size() >= maxGroupBytes) return fail("Group too large");
+            groupText.push_back(c);
+            if (!trackNesting(c)) return false;
+            if (depth == 0) {
+                if (groupText.size() > peakGroupBytes) peakGroupBytes = groupText.size();
+                if (!parseGroup()) return false;
+                state = GROUPS;
+            }
+            return true;
+
+        case AFTER_VALUE:
+            if (isWhitespace(c)) return true;
+            if (c == ',') {
+                state = OBJECT_KEY;
+                return true;
+            }
+            if (c == '}') {
+                state = DONE;
+                return true;
+            }
+            return fail("Expected ',' or '}'");
+
+        case DONE:
+            if (isWhitespace(c)) return true;
+            return fail("Unexpected data after the configuration");
+
+        case FAILED:
+        default:
+            return false;
+    }
+}
+
+bool ConfigStreamParser::trackNesting(char c) {
+    if (inString) {
+        if (escaped) {
+            escaped = false;
+        } else if (c == '\\') {
+            escaped = true;
+        } else if (c == '"') {
+            inString = false;
+        }
+        return true;
+    }
+
+    if (c == '"') {
+        inString = true;
+    } else if (c == '{' || c == '[') {
+        if (depth == UINT16_MAX) return fail("Nesting too deep");
+        depth++;
+    } else if (c == '}' || c == ']') {
+        if (depth == 0) return fail("Unbalanced brackets");
+        depth--;
+    }
+    return true;
+}
+
+bool ConfigStreamParser::parseGroup() {
+    // From the JSON pool, released before the next group is read
+    JsonPool::Document doc;
+    DeserializationError jsonError = deserializeJson(doc, groupText.data(), groupText.size());
+    if (jsonError || !doc.is<JsonObject>()) return fail("Invalid group");
+
+    if (groups.full()) return fail("Too many groups");
+    if (!Group::fromJson(doc.as<JsonObject>(), groups)) return fail("Group exceeds the capacity limits");
+
+    // Merge templates as they arrive, the template pool only has to hold distinct ones
+    Group::shareTemplates(groups);
+    return true;
+}
+
+void ConfigStreamParser::endScalar() {
+    if (key == "seq") {
+        seq = strtoul(scalar.c_str(), nullptr, 10);
+    }
+}
+
+bool ConfigStreamParser::fail(const char* message) {
+    if (state != FAILED) {
+        Serial.printf("[ConfigStreamParser] %s\n", message);
+        error = message;
+        state = FAILED;
+    }
+    return false;
+}
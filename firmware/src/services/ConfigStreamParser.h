@@ -0,0 +1,84 @@
+#ifndef CONFIG_STREAM_PARSER_H
+#define CONFIG_STREAM_PARSER_H
+
+#include <Arduino.h>
+#include <vector>
+#include "../config.h"
+#include "../models/Group.h"
+
+/**
+ * ConfigStreamParser reads a JSON configuration group by group as it arrives
+ *
+ * Accepts {"seq":N,"groups":[...]} (other keys are skipped) or a bare array of groups.
+ * Only the text of the group currently being read is buffered and parsed into a
+ * JsonDocument, so memory use is bounded by the largest single group
+ * (CONFIG_STREAM_GROUP_MAX_BYTES) instead of the size of the whole configuration.
+ *
+ * Groups are built straight into the list given to the constructor (cleared first),
+ * which is left partially filled if the input turns out invalid.
+ *
+ * Usage: feed() the input in chunks of any size, then finish().
+ */
+class ConfigStreamParser {
+public:
+    explicit ConfigStreamParser(GroupList& groups, size_t maxGroupBytes = CONFIG_STREAM_GROUP_MAX_BYTES);
+
+    /**
+     * Consume the next chunk of input, returns false once the input is invalid
+     */
+    bool feed(const char* data, size_t length);
+
+    /**
+     * Signal the end of input, returns false if the document is incomplete or invalid
+     */
+    bool finish();
+
+    GroupList& getGroups() { return groups; }
+    uint32_t getSeq() const { return seq; }
+    const char* getError() const { return error; }
+
+    // Largest group text buffered so far (bytes)
+    size_t getPeakGroupBytes() const { return peakGroupBytes; }
+
+private:
+    enum State : uint8_t {
+        START,
+        OBJECT_KEY,     // Expecting a key or the end of the top-level object
+        KEY,            // Inside a key string
+        COLON,
+        VALUE,          // Expecting a top-level value
+        SCALAR,         // Inside a number, literal or other scalar
+        SKIP,           // Inside a value that is not used
+        GROUPS,         // Inside the groups array, expecting a group or its end
+        GROUP,          // Inside a group object
+        AFTER_VALUE,    // Expecting ',' or the end of the top-level object
+        DONE,
+        FAILED
+    };
+
+    State state;
+    bool topLevelArray;
+    bool inString;
+    bool escaped;
+    uint16_t depth;
+    String key;
+    String scalar;
+    std::vector<char> groupText;
+    size_t maxGroupBytes;
+    size_t peakGroupBytes;
+    uint32_t seq;
+    GroupList& groups;
+    const char* error;
+
+    bool step(char c);
+    bool trackNesting(char c);
+    bool parseGroup();
+    void endScalar();
+    bool fail(const char* message);
+
+    static bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+};
+
+#endif // CONFIG_STREAM_PARSER_H
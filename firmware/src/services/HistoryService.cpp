@@ -0,0 +1,60 @@
+#include "HistoryService.h"
+#include "PreferencesService.h"
+
+// Static member initialization
+HistorySeries HistoryService::series[HISTORY_MAX_SERIES];
+std::atomic<size_t> HistoryService::activeCount(0);
+std::mutex HistoryService::seriesLock;
+
+void HistoryService::init() {
+    std::vector<uint32_t> tokens;
+    if (!PreferencesService::loadHistorySeries(tokens)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(seriesLock);
+    size_t count = 0;
+    for (uint32_t token : tokens) {
+        if (count >= HISTORY_MAX_SERIES) break;
+        series[count++].reset(token);
+    }
+    activeCount = count;
+    Serial.printf("[History] Tracking %d registers\n", count);
+}
+
+bool HistoryService::track(uint32_t token) {
+    {
+        std::lock_guard<std::mutex> lock(seriesLock);
+        HistorySeries* freeSlot = nullptr;
+        for (auto& s : series) {
+            if (s.active && s.token == token) return true;
+            if (!s.active && !freeSlot) freeSlot = &s;
+        }
+        if (!freeSlot) return false;
+
+        freeSlot->reset(token);
+        activeCount++;
+    }
+    persist();
+    return true;
+}
+
+bool HistoryService::untrack(uint32_t token) {
+    {
+        std::lock_guard<std::mutex> lock(seriesLock);
+        HistorySeries* found = nullptr;
+        for (auto& s : series) {
+            if (s.active && s.token == token) found = &s;
+        }
+        if (!found) return false;
+
+        found->active = false;
+        activeCount--;
+    }
+    persist();
+    return true;
+}
+
+void HistoryService::persist() {
+    PreferencesService::saveHistorySeries(getTrackedTokens());
+}
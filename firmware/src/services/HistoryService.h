@@ -0,0 +1,104 @@
+#ifndef HISTORY_SERVICE_H
+#define HISTORY_SERVICE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "../config.h"
+#include "../models/History.h"
+
+/**
+ * HistoryService keeps an on-device time series for selected registers
+ * - Raw change points in delta-encoded blocks, plus 1-minute, 1-hour and 1-day min/max/avg rollups
+ * - Storage is a fixed table of HISTORY_MAX_SERIES series, nothing is allocated while recording
+ * - Registers are identified by the COM2 token [group:8][slave:8][reg:16]; slave 0 = group register
+ * - Times are seconds since boot
+ */
+class HistoryService {
+public:
+    static uint32_t makeToken(uint8_t groupId, uint8_t slaveId, uint16_t regId) {
+        return ((uint32_t)groupId << 24) | ((uint32_t)slaveId << 16) | regId;
+    }
+
+    /**
+     * Load the tracked register selection from persistent storage
+     */
+    static void init();
+
+    /**
+     * Start tracking a register, returns false when all series are in use
+     * Tracking an already tracked register succeeds without resetting it
+     */
+    static bool track(uint32_t token);
+
+    /**
+     * Stop tracking a register and free its series
+     */
+    static bool untrack(uint32_t token);
+
+    /**
+     * Record a value received from COM2 (called from the eModbus worker)
+     */
+    static void record(uint32_t token, uint16_t value) {
+        if (activeCount.load(std::memory_order_relaxed) == 0) return;
+
+        uint32_t now = millis();
+        std::lock_guard<std::mutex> lock(seriesLock);
+        for (auto& s : series) {
+            if (s.active && s.token == token) {
+                s.record(now, value);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Slot index of a tracked register, -1 if not tracked
+     */
+    static int findSeries(uint32_t token, uint32_t& epoch) {
+        std::lock_guard<std::mutex> lock(seriesLock);
+        for (size_t i = 0; i < HISTORY_MAX_SERIES; i++) {
+            if (series[i].active && series[i].token == token) {
+                epoch = series[i].epoch;
+                return (int)i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Run fn with the series under the lock, returns false if the slot was
+     * reassigned since epoch was obtained (keep fn short, it blocks recording)
+     */
+    template <typename F>
+    static bool readSeries(size_t slot, uint32_t epoch, F fn) {
+        if (slot >= HISTORY_MAX_SERIES) return false;
+        std::lock_guard<std::mutex> lock(seriesLock);
+        const HistorySeries& s = series[slot];
+        if (!s.active || s.epoch != epoch) return false;
+        fn(s);
+        return true;
+    }
+
+    /**
+     * Tokens of all tracked registers
+     */
+    static std::vector<uint32_t> getTrackedTokens() {
+        std::vector<uint32_t> tokens;
+        std::lock_guard<std::mutex> lock(seriesLock);
+        for (const auto& s : series) {
+            if (s.active) tokens.push_back(s.token);
+        }
+        return tokens;
+    }
+
+private:
+    static HistorySeries series[HISTORY_MAX_SERIES];
+    static std::atomic<size_t> activeCount;
+    static std::mutex seriesLock;
+
+    static void persist();
+};
+
+#endif // HISTORY_SERVICE_H
@@ -62,6 +62,10 @@ public:
             Serial.println("[InterfacesService] Invalid UART2 configuration");
             return false;
         }
+        if (!newConfig.isTimeoutValid()) {
+            Serial.println("[InterfacesService] Invalid UART2 timeout bounds");
+            return false;
+        }
         
         config = newConfig;
         
@@ -108,7 +112,7 @@ public:
      * Validate configuration
      */
     static bool isValid() {
-        return config.uart1.isValid() && config.uart2.isValid();
+        return config.uart1.isValid() && config.uart2.isValid() && config.isTimeoutValid();
     }
 };
 
@@ -0,0 +1,211 @@
+#include "JsonPool.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Static member initialization
+JsonPool::PoolAllocator JsonPool::instance;
+uint8_t* JsonPool::arena = nullptr;
+size_t JsonPool::arenaBytes = 0;
+uint8_t JsonPool::topOrder = 0;
+bool JsonPool::psram = false;
+JsonPool::Block* JsonPool::freeLists[MAX_ORDERS] = {};
+size_t JsonPool::usedBytes = 0;
+size_t JsonPool::peakBytes = 0;
+size_t JsonPool::documentCount = 0;
+size_t JsonPool::peakDocuments = 0;
+uint32_t JsonPool::fallbackCount = 0;
+uint32_t JsonPool::rejectedCount = 0;
+std::mutex JsonPool::lock;
+
+static_assert((JSON_POOL_BYTES & (JSON_POOL_BYTES - 1)) == 0, "JSON_POOL_BYTES must be a power of two");
+static_assert((JSON_POOL_PSRAM_BYTES & (JSON_POOL_PSRAM_BYTES - 1)) == 0,
+              "JSON_POOL_PSRAM_BYTES must be a power of two");
+
+void JsonPool::init() {
+    std::lock_guard<std::mutex> guard(lock);
+    if (arena) return;
+
+    size_t bytes = JSON_POOL_BYTES;
+    if (psramFound()) {
+        arena = (uint8_t*)heap_caps_malloc(JSON_POOL_PSRAM_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (arena) {
+            bytes = JSON_POOL_PSRAM_BYTES;
+            psram = true;
+        }
+    }
+    if (!arena) {
+        arena = (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (!arena) {
+        Serial.printf("[JsonPool] Could not reserve %u bytes, documents use the heap\n", (unsigned)bytes);
+        return;
+    }
+
+    arenaBytes = bytes;
+    topOrder = 0;
+    while (blockSize(topOrder) < arenaBytes && topOrder + 1 < MAX_ORDERS) topOrder++;
+    arenaBytes = blockSize(topOrder);
+    pushFree(reinterpret_cast<Block*>(arena), topOrder);
+
+    Serial.printf("[JsonPool] %u byte arena in %s, %u documents\n", (unsigned)arenaBytes,
+                  psram ? "PSRAM" : "internal RAM", (unsigned)JSON_POOL_MAX_DOCUMENTS);
+}
+
+ArduinoJson::Allocator* JsonPool::allocator() {
+    return &instance;
+}
+
+bool JsonPool::isBusy() {
+    std::lock_guard<std::mutex> guard(lock);
+    return documentCount >= JSON_POOL_MAX_DOCUMENTS;
+}
+
+void JsonPool::countRejected() {
+    std::lock_guard<std::mutex> guard(lock);
+    rejectedCount++;
+}
+
+size_t JsonPool::getUsedBytes() {
+    std::lock_guard<std::mutex> guard(lock);
+    return usedBytes;
+}
+
+size_t JsonPool::getPeakBytes() {
+    std::lock_guard<std::mutex> guard(lock);
+    return peakBytes;
+}
+
+size_t JsonPool::getDocumentCount() {
+    std::lock_guard<std::mutex> guard(lock);
+    return documentCount;
+}
+
+size_t JsonPool::getPeakDocuments() {
+    std::lock_guard<std::mutex> guard(lock);
+    return peakDocuments;
+}
+
+uint32_t JsonPool::getFallbackCount() {
+    std::lock_guard<std::mutex> guard(lock);
+    return fallbackCount;
+}
+
+uint32_t JsonPool::getRejectedCount() {
+    std::lock_guard<std::mutex> guard(lock);
+    return rejectedCount;
+}
+
+void JsonPool::open() {
+    std::lock_guard<std::mutex> guard(lock);
+    documentCount++;
+    if (documentCount > peakDocuments) peakDocuments = documentCount;
+}
+
+void JsonPool::close() {
+    std::lock_guard<std::mutex> guard(lock);
+    documentCount--;
+}
+
+void* JsonPool::PoolAllocator::allocate(size_t size) {
+    void* pointer = take(size);
+    return pointer ? pointer : fallback(size);
+}
+
+void JsonPool::PoolAllocator::deallocate(void* pointer) {
+    if (contains(pointer)) {
+        release(pointer);
+    } else {
+        free(pointer);
+    }
+}
+
+void* JsonPool::PoolAllocator::reallocate(void* pointer, size_t newSize) {
+    if (!pointer) return allocate(newSize);
+    if (!contains(pointer)) return realloc(pointer, newSize);
+
+    // Shrinking, or growing within the block, keeps the block
+    Block* block = reinterpret_cast<Block*>(static_cast<uint8_t*>(pointer) - HEADER);
+    size_t available = blockSize(block->order) - HEADER;
+    if (newSize <= available) return pointer;
+
+    void* moved = allocate(newSize);
+    if (!moved) return nullptr;
+    memcpy(moved, pointer, available);
+    release(pointer);
+    return moved;
+}
+
+void* JsonPool::take(size_t size) {
+    if (!arena || size > arenaBytes - HEADER) return nullptr;
+
+    uint8_t order = 0;
+    while (blockSize(order) < size + HEADER) order++;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    // Smallest free block that fits, split down to the size asked for
+    uint8_t found = order;
+    while (found <= topOrder && !freeLists[found]) found++;
+    if (found > topOrder) return nullptr;
+
+    Block* block = freeLists[found];
+    unlinkFree(block);
+    while (found > order) {
+        found--;
+        pushFree(reinterpret_cast<Block*>(reinterpret_cast<uint8_t*>(block) + blockSize(found)), found);
+    }
+    block->order = order;
+    block->free = 0;
+
+    usedBytes += blockSize(order);
+    if (usedBytes > peakBytes) peakBytes = usedBytes;
+    return reinterpret_cast<uint8_t*>(block) + HEADER;
+}
+
+void JsonPool::release(void* pointer) {
+    std::lock_guard<std::mutex> guard(lock);
+    Block* block = reinterpret_cast<Block*>(static_cast<uint8_t*>(pointer) - HEADER);
+    uint8_t order = block->order;
+    usedBytes -= blockSize(order);
+
+    // Merge with the buddy while it is free and whole
+    while (order < topOrder) {
+        size_t offset = reinterpret_cast<uint8_t*>(block) - arena;
+        Block* buddy = reinterpret_cast<Block*>(arena + (offset ^ blockSize(order)));
+        if (!buddy->free || buddy->order != order) break;
+        unlinkFree(buddy);
+        if (buddy < block) block = buddy;
+        order++;
+    }
+    pushFree(block, order);
+}
+
+void* JsonPool::fallback(size_t size) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (arena && fallbackCount++ == 0) {
+            Serial.printf("[JsonPool] Arena exhausted (%u bytes asked), falling back to the heap\n",
+                          (unsigned)size);
+        }
+    }
+    return malloc(size);
+}
+
+void JsonPool::pushFree(Block* block, uint8_t order) {
+    block->order = order;
+    block->free = 1;
+    block->prev = nullptr;
+    block->next = freeLists[order];
+    if (block->next) block->next->prev = block;
+    freeLists[order] = block;
+}
+
+void JsonPool::unlinkFree(Block* block) {
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        freeLists[block->order] = block->next;
+    }
+    if (block->next) block->next->prev = block->prev;
+    block->free = 0;
+}
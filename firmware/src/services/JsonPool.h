@@ -0,0 +1,119 @@
+#ifndef JSON_POOL_H
+#define JSON_POOL_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <mutex>
+#include "../config.h"
+
+/**
+ * JsonPool backs the JSON documents (request bodies, responses, configuration files)
+ * with one arena reserved at boot instead of fresh heap allocations per request
+ * - The arena is JSON_POOL_PSRAM_BYTES of PSRAM when the board has it, otherwise
+ *   JSON_POOL_BYTES of internal RAM
+ * - Blocks are handed out by a buddy allocator: a released document coalesces back
+ *   into whole blocks, so the arena does not fragment however requests interleave
+ * - At most JSON_POOL_MAX_DOCUMENTS documents are expected at once: LocalWebServer
+ *   answers API requests with 503 while they are all taken. Internal documents
+ *   (configuration load and save) are never refused.
+ * - An allocation the arena cannot serve goes to the heap; those fallbacks are counted
+ *   and reported by /api/telemetry together with the high-water marks
+ */
+class JsonPool {
+public:
+    /**
+     * A JSON document allocated from the pool, counted while it exists
+     */
+    class Document : public JsonDocument {
+    public:
+        Document() : JsonDocument(JsonPool::allocator()) { JsonPool::open(); }
+        ~Document() { JsonPool::close(); }
+
+        Document(const Document&) = delete;
+        Document& operator=(const Document&) = delete;
+    };
+
+    /**
+     * Reserve the arena, must run before the first document is created
+     * (documents created before that, or without an arena, use the heap)
+     */
+    static void init();
+
+    /**
+     * The ArduinoJson allocator serving the arena
+     */
+    static ArduinoJson::Allocator* allocator();
+
+    /**
+     * True while every document slot is taken, new API requests should be refused
+     */
+    static bool isBusy();
+
+    /**
+     * Count a request refused because the pool was busy
+     */
+    static void countRejected();
+
+    // Statistics for telemetry
+    static size_t getArenaBytes() { return arenaBytes; }
+    static bool inPsram() { return psram; }
+    static size_t getUsedBytes();
+    static size_t getPeakBytes();
+    static size_t getDocumentCount();
+    static size_t getPeakDocuments();
+    static size_t getMaxDocuments() { return JSON_POOL_MAX_DOCUMENTS; }
+    static uint32_t getFallbackCount();
+    static uint32_t getRejectedCount();
+
+private:
+    static constexpr size_t MIN_BLOCK = 32;         // Smallest block, header included
+    static constexpr size_t HEADER = 8;             // Keeps the payload 8-byte aligned
+    static constexpr uint8_t MAX_ORDERS = 16;       // Up to MIN_BLOCK << 15 (1 MiB)
+
+    /**
+     * Start of every block; free blocks are linked into the list of their order
+     */
+    struct Block {
+        uint8_t order;
+        uint8_t free;
+        Block* next;
+        Block* prev;
+    };
+
+    class PoolAllocator : public ArduinoJson::Allocator {
+    public:
+        void* allocate(size_t size) override;
+        void deallocate(void* pointer) override;
+        void* reallocate(void* pointer, size_t newSize) override;
+    };
+
+    static PoolAllocator instance;
+    static uint8_t* arena;
+    static size_t arenaBytes;
+    static uint8_t topOrder;                        // Order of the whole arena
+    static bool psram;
+    static Block* freeLists[MAX_ORDERS];
+    static size_t usedBytes;
+    static size_t peakBytes;
+    static size_t documentCount;
+    static size_t peakDocuments;
+    static uint32_t fallbackCount;
+    static uint32_t rejectedCount;
+    static std::mutex lock;
+
+    static void open();
+    static void close();
+
+    static bool contains(const void* pointer) {
+        return arena && pointer >= arena + HEADER && pointer < arena + arenaBytes;
+    }
+    static size_t blockSize(uint8_t order) { return MIN_BLOCK << order; }
+
+    static void* take(size_t size);
+    static void release(void* pointer);
+    static void* fallback(size_t size);
+    static void pushFree(Block* block, uint8_t order);
+    static void unlinkFree(Block* block);
+};
+
+#endif // JSON_POOL_H
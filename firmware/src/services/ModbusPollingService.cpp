@@ -11,4 +11,17 @@ bool ModbusPollingService::isPollingGroupRegisters = true;
 size_t ModbusPollingService::currentSlaveIndex = 0;
 bool ModbusPollingService::initialized = false;
 unsigned long ModbusPollingService::lastRequestTime = 0;
-size_t ModbusPollingService::ongoingRequests = 0;
+std::atomic<size_t> ModbusPollingService::ongoingRequests(0);
+unsigned long ModbusPollingService::cycleStartTime = 0;
+unsigned long ModbusPollingService::groupStartTime = 0;
+std::atomic<uint32_t> ModbusPollingService::cycleRequests(0);
+std::atomic<uint32_t> ModbusPollingService::cycleBytes(0);
+uint32_t ModbusPollingService::cycleCount = 0;
+uint32_t ModbusPollingService::lastCycleMs = 0;
+uint32_t ModbusPollingService::lastCycleRequests = 0;
+uint32_t ModbusPollingService::lastCycleBytes = 0;
+Histogram ModbusPollingService::cycleHistogram;
+Histogram ModbusPollingService::requestsHistogram;
+Histogram ModbusPollingService::bytesHistogram;
+std::map<uint8_t, Histogram> ModbusPollingService::groupHistograms;
+std::mutex ModbusPollingService::groupHistogramsLock;
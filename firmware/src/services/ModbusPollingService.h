@@ -2,7 +2,12 @@
 #define MODBUS_POLLING_SERVICE_H
 
 #include <Arduino.h>
+#include <atomic>
+#include <map>
+#include <mutex>
 #include "../comport/Comport2.h"
+#include "../models/Histogram.h"
+#include "../models/PollMetrics.h"
 #include "ModbusService.h"
 #include "StatusService.h"
 
@@ -25,7 +30,22 @@ private:
     
     static bool initialized;
     static unsigned long lastRequestTime;     // Time when last request was sent
-    static size_t ongoingRequests;            // Number of requests sent but not yet responded
+    static std::atomic<size_t> ongoingRequests; // Number of requests sent but not yet responded
+    
+    // Cycle statistics
+    static unsigned long cycleStartTime;      // Time when the current full cycle started
+    static unsigned long groupStartTime;      // Time when the current group started
+    static std::atomic<uint32_t> cycleRequests; // Requests put on the bus in the current cycle
+    static std::atomic<uint32_t> cycleBytes;  // Bytes on the bus in the current cycle
+    static uint32_t cycleCount;
+    static uint32_t lastCycleMs;
+    static uint32_t lastCycleRequests;
+    static uint32_t lastCycleBytes;
+    static Histogram cycleHistogram;          // Full cycle duration (ms)
+    static Histogram requestsHistogram;       // Requests per cycle
+    static Histogram bytesHistogram;          // Bytes per cycle
+    static std::map<uint8_t, Histogram> groupHistograms; // Per group duration (ms)
+    static std::mutex groupHistogramsLock;
     
 public:
     /**
@@ -45,15 +65,20 @@ public:
         initialized = true;
         lastRequestTime = 0;
         ongoingRequests = 0;
+        cycleStartTime = millis();
+        groupStartTime = cycleStartTime;
         
         Serial.println("ModbusPollingService initialized");
         Serial.printf("Delay range: %d-%d ms\n", minPollDelayMs, maxPollDelayMs);
     }
     
     /**
-     * Called when a request is sent - increments ongoing counter
+     * Called by Comport2 when a request is queued - increments ongoing counter
+     * Reads merged into an in-flight request are not counted
      */
-    static void onRequestSent() {
+    static void onRequestSent(size_t bytes = 0) {
+        cycleRequests.fetch_add(1, std::memory_order_relaxed);
+        cycleBytes.fetch_add(bytes, std::memory_order_relaxed);
         ongoingRequests++;
         adjustPollDelay();
     }
@@ -61,9 +86,14 @@ public:
     /**
      * Called when a response is received - decrements ongoing counter
      */
-    static void onResponseReceived() {
-        if (ongoingRequests > 0) {
-            ongoingRequests--;
+    static void onResponseReceived(size_t bytes = 0) {
+        cycleBytes.fetch_add(bytes, std::memory_order_relaxed);
+        
+        // Called from the eModbus worker task, decrement without going below zero
+        size_t current = ongoingRequests.load();
+        while (current > 0 && !ongoingRequests.compare_exchange_weak(current, current - 1)) {
+        }
+        if (current > 0) {
             adjustPollDelay();
         }
     }
@@ -75,6 +105,13 @@ public:
         return ongoingRequests;
     }
     
+    /**
+     * Get the COM2 port used for polling (nullptr before init)
+     */
+    static Comport2* getComport() {
+        return comport;
+    }
+    
     /**
      * Get current poll delay
      */
@@ -82,6 +119,32 @@ public:
         return pollDelayMs;
     }
     
+    /**
+     * Snapshot of the cycle statistics
+     */
+    static PollMetrics getMetrics(bool withGroups = true) {
+        PollMetrics metrics;
+        metrics.cycles = cycleCount;
+        metrics.lastCycleMs = lastCycleMs;
+        metrics.lastCycleRequests = lastCycleRequests;
+        metrics.lastCycleBytes = lastCycleBytes;
+        metrics.cycleMs = cycleHistogram.snapshot();
+        metrics.requestsPerCycle = requestsHistogram.snapshot();
+        metrics.bytesPerCycle = bytesHistogram.snapshot();
+        
+        if (withGroups) {
+            std::lock_guard<std::mutex> lock(groupHistogramsLock);
+            metrics.groups.reserve(groupHistograms.size());
+            for (const auto& entry : groupHistograms) {
+                GroupCycleMetrics group;
+                group.groupId = entry.first;
+                group.durationMs = entry.second.snapshot();
+                metrics.groups.push_back(group);
+            }
+        }
+        return metrics;
+    }
+    
     /**
      * Main polling loop - call this frequently from main loop()
      */
@@ -95,8 +158,9 @@ public:
             return;  // Not time for next request yet
         }
         
-        // Get all groups from ModbusService
-        const auto& groups = ModbusService::getGroups();
+        // Get all groups from ModbusService, pinned for this step (indexes are kept between steps)
+        ModbusService::ReadGuard config;
+        const auto& groups = config.groups();
         
         if (groups.empty()) {
             // No groups configured
@@ -111,7 +175,7 @@ private:
     /**
      * Send next single request
      */
-    static void sendNextRequest(const std::vector<Group>& groups, unsigned long currentTime) {
+    static void sendNextRequest(const GroupList& groups, unsigned long currentTime) {
         bool requestSent = false;
         
         // Try to send one request
@@ -122,7 +186,7 @@ private:
                 currentRegisterIndex = 0;
                 currentSlaveIndex = 0;
                 isPollingGroupRegisters = true;
-                Serial.println("[Poll] Completed full cycle, restarting from beginning");
+                completeCycle(groups, currentTime);
                 return;
             }
             
@@ -148,7 +212,6 @@ private:
                     if (success) {
                         lastRequestTime = currentTime;
                         requestSent = true;
-                        onRequestSent();
                     }
                     
                     currentRegisterIndex++;
@@ -164,8 +227,8 @@ private:
                 if (currentSlaveIndex < group.slaves.size()) {
                     const Slave& slave = group.slaves[currentSlaveIndex];
                     
-                    if (currentRegisterIndex < slave.registers.size()) {
-                        const Register& reg = slave.registers[currentRegisterIndex];
+                    if (currentRegisterIndex < slave.registerCount()) {
+                        const Register& reg = slave.getDefinition(currentRegisterIndex);
                         
                         // Create token: encode group ID, slave ID, and register ID
                         uint32_t token = makeToken(group.id, slave.id, reg.id);
@@ -182,7 +245,6 @@ private:
                         if (success) {
                             lastRequestTime = currentTime;
                             requestSent = true;
-                            onRequestSent();
                         }
                         
                         currentRegisterIndex++;
@@ -193,6 +255,7 @@ private:
                     }
                 } else {
                     // Done with all slaves, move to next group
+                    completeGroup(group.id, currentTime);
                     currentGroupIndex++;
                     currentRegisterIndex = 0;
                     currentSlaveIndex = 0;
@@ -202,25 +265,73 @@ private:
         }
     }
     
+    /**
+     * Record the duration of a group that has been fully polled
+     */
+    static void completeGroup(uint8_t groupId, unsigned long currentTime) {
+        uint32_t elapsed = currentTime - groupStartTime;
+        groupStartTime = currentTime;
+        
+        std::lock_guard<std::mutex> lock(groupHistogramsLock);
+        groupHistograms[groupId].record(elapsed);
+    }
+    
+    /**
+     * Record the statistics of a full cycle and start the next one
+     */
+    static void completeCycle(const GroupList& groups, unsigned long currentTime) {
+        lastCycleMs = currentTime - cycleStartTime;
+        lastCycleRequests = cycleRequests.exchange(0, std::memory_order_relaxed);
+        lastCycleBytes = cycleBytes.exchange(0, std::memory_order_relaxed);
+        cycleCount++;
+        
+        cycleHistogram.record(lastCycleMs);
+        requestsHistogram.record(lastCycleRequests);
+        bytesHistogram.record(lastCycleBytes);
+        
+        cycleStartTime = currentTime;
+        groupStartTime = currentTime;
+        
+        // Drop statistics of groups that no longer exist
+        {
+            std::lock_guard<std::mutex> lock(groupHistogramsLock);
+            for (auto it = groupHistograms.begin(); it != groupHistograms.end();) {
+                bool exists = false;
+                for (const auto& group : groups) {
+                    if (group.id == it->first) {
+                        exists = true;
+                        break;
+                    }
+                }
+                it = exists ? std::next(it) : groupHistograms.erase(it);
+            }
+        }
+        
+        Serial.printf("[Poll] Completed full cycle in %u ms (%u requests, %u bytes), restarting from beginning\n",
+                      lastCycleMs, lastCycleRequests, lastCycleBytes);
+    }
+    
     /**
      * Adjust poll delay based on ongoing requests
      * More pending requests = slower polling
      * Fewer pending requests = faster polling
      */
     static void adjustPollDelay() {
+        size_t pending = ongoingRequests.load();
+        
         // Adaptive algorithm:
         // 0-5 pending: min delay (fast)
         // 6-10 pending: gradually increase
         // 11-20 pending: medium delay
         // 21+ pending: max delay (slow down)
         
-        if (ongoingRequests <= 5) {
+        if (pending <= 5) {
             pollDelayMs = minPollDelayMs;
-        } else if (ongoingRequests <= 10) {
+        } else if (pending <= 10) {
             // Linear increase from min to middle
             uint32_t range = maxPollDelayMs - minPollDelayMs;
-            pollDelayMs = minPollDelayMs + (range * (ongoingRequests - 5) / 10);
-        } else if (ongoingRequests <= 20) {
+            pollDelayMs = minPollDelayMs + (range * (pending - 5) / 10);
+        } else if (pending <= 20) {
             // Middle range
             pollDelayMs = (minPollDelayMs + maxPollDelayMs) / 2;
         } else {
@@ -230,9 +341,9 @@ private:
         
         // Debug output on significant changes
         static size_t lastLoggedRequests = 0;
-        if (ongoingRequests / 5 != lastLoggedRequests / 5) {  // Log every 5 request threshold
-            Serial.printf("[Poll] Ongoing: %d, Delay: %d ms\n", ongoingRequests, pollDelayMs);
-            lastLoggedRequests = ongoingRequests;
+        if (pending / 5 != lastLoggedRequests / 5) {  // Log every 5 request threshold
+            Serial.printf("[Poll] Ongoing: %u, Delay: %u ms\n", (unsigned)pending, pollDelayMs);
+            lastLoggedRequests = pending;
         }
     }
     
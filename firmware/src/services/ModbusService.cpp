@@ -1,5 +1,69 @@
 #include "ModbusService.h"
+#include "NamePool.h"
+#include "RegisterMappingService.h"
+#include "TemplatePool.h"
+#include "ValueSyncService.h"
 
 // Static member initialization
-std::vector<Group> ModbusService::groups;
+GroupList ModbusService::lists[2];
+std::atomic<uint8_t> ModbusService::active(0);
+std::atomic<uint32_t> ModbusService::readers[2] = {};
+std::atomic<bool> ModbusService::stagingInUse(false);
 bool ModbusService::initialized = false;
+uint32_t ModbusService::generation = 0;
+bool ModbusService::dirty = false;
+uint32_t ModbusService::firstChangeMs = 0;
+uint32_t ModbusService::lastChangeMs = 0;
+std::mutex ModbusService::lock;
+std::vector<ConfigOperation> ModbusService::pendingOps;
+uint32_t ModbusService::journalSeq = 0;
+bool ModbusService::checkpointRequired = false;
+bool ModbusService::storageRejected = false;
+
+void ModbusService::publish(GroupList& staged) {
+    // Slaves edited to the same registers share a template again. Only the staged copy
+    // is touched: the published list keeps its templates while the poller reads them.
+    Group::shareTemplates(staged);
+    RegisterMappingService::buildMapping(staged);
+    active = &staged == &lists[0] ? 0 : 1;
+}
+
+CapacityData ModbusService::getCapacity() {
+    CapacityData data;
+    data.maxGroups = MODBUS_MAX_GROUPS;
+    data.maxSlaves = MODBUS_MAX_SLAVES;
+    data.maxTotalSlaves = MODBUS_MAX_TOTAL_SLAVES;
+    data.maxSlaveValues = MODBUS_MAX_SLAVE_VALUES;
+    data.maxGroupRegisters = MODBUS_MAX_GROUP_REGISTERS;
+    data.maxSlaveRegisters = MODBUS_MAX_SLAVE_REGISTERS;
+
+    {
+        ReadGuard config;
+        const GroupList& groups = config.groups();
+        data.groups = groups.size();
+        data.slaves = groups.slaveCount();
+        data.slaveValues = groups.valueCount();
+        for (const auto& group : groups) {
+            if (group.slaves.size() > data.largestSlaveCount) data.largestSlaveCount = group.slaves.size();
+            if (group.registers.size() > data.largestGroupRegisters) data.largestGroupRegisters = group.registers.size();
+            data.registers += group.registers.size();
+            for (const auto& slave : group.slaves) {
+                if (slave.registerCount() > data.largestTemplate) data.largestTemplate = slave.registerCount();
+                data.registers += slave.registerCount();
+            }
+        }
+    }
+
+    data.templatesUsed = TemplatePool::getUsed();
+    data.templatesPeak = TemplatePool::getPeak();
+    data.maxTemplates = TemplatePool::getCapacity();
+    data.templatesRejected = TemplatePool::getRejectedCount();
+    data.nameBytes = NamePool::getUsedBytes();
+    data.nameCapacity = NamePool::getCapacity();
+    data.namesRejected = NamePool::getRejectedCount();
+    data.staticBytes = sizeof(lists) + TemplatePool::getStaticBytes() + RegisterMappingService::getStaticBytes() +
+                       ValueSyncService::getStaticBytes();
+    data.stagingInUse = stagingInUse;
+    data.storageRejected = storageRejected;
+    return data;
+}
@@ -1,88 +1,130 @@
 #ifndef MODBUS_SERVICE_H
 #define MODBUS_SERVICE_H
 
+#include <atomic>
+#include <mutex>
 #include <vector>
+#include "../config.h"
+#include "../models/CapacityData.h"
 #include "../models/Group.h"
+#include "../models/ConfigOperation.h"
 #include "PreferencesService.h"
+#include "ValueSyncService.h"
+#include "WarmStartService.h"
 
 /**
  * ModbusService manages all modbus groups and their data
  * - CRUD operations for groups
  * - Register management at group and slave level
- * - Persistence through PreferencesService
+ * - Persistence through PreferencesService, written behind: changes are collected
+ *   as operations and update() appends them to the journal once edits have settled
+ * - The configuration lives in two static GroupLists, sized by the MODBUS_MAX_* limits
+ *   in config.h. One is published and only read (the poller, COM1, COM2 and the web
+ *   server read it through a ReadGuard). Every change is applied to a copy in the other
+ *   one, which is then published by flipping an index; the old list is reused only once
+ *   the last guard pinning it is gone.
  */
 class ModbusService {
 private:
-    static std::vector<Group> groups;
+    static GroupList lists[2];                  // The published configuration and the staging copy
+    static std::atomic<uint8_t> active;         // Index of the published list
+    static std::atomic<uint32_t> readers[2];    // ReadGuards pinning each list
+    static std::atomic<bool> stagingInUse;
     static bool initialized;
+    static uint32_t generation;     // Bumped on every configuration change
+    static bool dirty;              // Changes not yet written to storage
+    static uint32_t firstChangeMs;  // millis() of the oldest unsaved change
+    static uint32_t lastChangeMs;   // millis() of the newest unsaved change
+    static std::mutex lock;         // Serializes configuration changes with the background save
+    static std::vector<ConfigOperation> pendingOps;  // Changes for the next journal record
+    static uint32_t journalSeq;     // Sequence number of the last stored journal record / checkpoint
+    static bool checkpointRequired; // Change cannot be expressed as operations (import)
+    static bool storageRejected;    // The stored configuration failed to load, nothing is written over it
+    
+    /**
+     * Pin the published list, returns its index
+     * The index is read again after the pin is counted: if a publish came in between,
+     * the pin is dropped and taken on the new list, so a list is never pinned after
+     * acquireStaging() has seen it unpinned.
+     */
+    static uint8_t pin() {
+        for (;;) {
+            uint8_t index = active.load();
+            readers[index]++;
+            if (active.load() == index) return index;
+            readers[index]--;
+        }
+    }
     
 public:
+    /**
+     * ReadGuard pins the published configuration while it is read, from any task
+     * Keep it for one step (a poll request, a COM1 request, a response chunk) and
+     * never across a configuration change of the same task, which would wait for it.
+     * Register values are written through a guard as well, into the published list.
+     */
+    class ReadGuard {
+    public:
+        ReadGuard() : index(ModbusService::pin()) {}
+        ~ReadGuard() { ModbusService::readers[index]--; }
+        
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        
+        const GroupList& groups() const { return ModbusService::lists[index]; }
+        
+        Group* getGroup(uint8_t groupId) const {
+            return ModbusService::findGroup(ModbusService::lists[index], groupId);
+        }
+        
+    private:
+        uint8_t index;
+    };
+    
     /**
      * Initialize ModbusService - load groups from persistent storage
      */
     static bool init() {
         if (initialized) return true;
         
-        if (!PreferencesService::loadGroups(groups)) {
-            Serial.println("[ModbusService] Warning: Could not load groups from storage");
+        generation = esp_random();
+        
+        GroupList& groups = lists[active];
+        if (!PreferencesService::loadGroups(groups, journalSeq)) {
+            // Corrupt, or over the MODBUS_MAX_* limits of this build: keep it for a firmware
+            // that can read it rather than saving the empty configuration over it
+            Serial.println("[ModbusService] Error: Could not load groups from storage, "
+                           "changes are not saved until a configuration is imported");
             groups.clear();
+            storageRejected = true;
         }
         
+        Group::shareTemplates(groups);
+        Serial.printf("[ModbusService] %u slaves share %u register templates\n",
+                      (unsigned)groups.slaveCount(), (unsigned)Group::countTemplates(groups));
+        
         initialized = true;
         return true;
     }
     
     /**
-     * Get all groups (const reference)
+     * The published configuration, for boot (before other tasks read it)
+     * Everything else reads through a ReadGuard
      */
-    static const std::vector<Group>& getGroups() {
-        return groups;
-    }
-    
-    /**
-     * Get all groups (non-const for internal services like mapping)
-     */
-    static std::vector<Group>& getGroupsMutable() {
-        return groups;
-    }
-    
-    /**
-     * Get specific group by ID
-     */
-    static Group* getGroup(uint8_t groupId) {
-        for (auto& group : groups) {
-            if (group.id == groupId) {
-                return &group;
-            }
-        }
-        return nullptr;
+    static GroupList& getGroupsMutable() {
+        return lists[active];
     }
     
     /**
      * Create a new group
      */
     static bool createGroup(uint8_t groupId, uint8_t slaveCount = 0, uint8_t remoteAddress = 0) {
-        // Check if group already exists
-        if (getGroup(groupId)) {
-            Serial.println("[ModbusService] Group already exists");
-            return false;
-        }
-        
-        // If remoteAddress is 0, default to groupId
-        if (remoteAddress == 0) {
-            remoteAddress = groupId;
-        }
-        
-        Group newGroup(groupId, remoteAddress, "Outdoor Device " + String(groupId));
-        newGroup.updateSlaveCount(slaveCount);
-        groups.push_back(newGroup);
+        ConfigOperation op(ConfigOperation::CREATE_GROUP, groupId);
+        op.slaveCount = slaveCount;
+        op.remote = remoteAddress;  // 0 defaults to the group ID
+        if (!commit(op)) return false;
         
-        if (!save()) {
-            groups.pop_back();  // Rollback
-            return false;
-        }
-        
-        Serial.printf("[ModbusService] Created group %d (remote: %d)\n", groupId, remoteAddress);
+        Serial.printf("[ModbusService] Created group %d (remote: %d)\n", groupId, remoteAddress ? remoteAddress : groupId);
         return true;
     }
     
@@ -95,24 +137,9 @@ public:
             return true;
         }
         
-        // Check if new ID already exists
-        if (getGroup(newGroupId)) {
-            Serial.printf("[ModbusService] Group ID %d already exists\n", newGroupId);
-            return false;
-        }
-        
-        auto* group = getGroup(oldGroupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
-            return false;
-        }
-        
-        group->id = newGroupId;
-        
-        if (!save()) {
-            group->id = oldGroupId; // Rollback
-            return false;
-        }
+        ConfigOperation op(ConfigOperation::UPDATE_GROUP, oldGroupId);
+        op.setNewId(newGroupId);
+        if (!commit(op)) return false;
         
         Serial.printf("[ModbusService] Updated group local ID from %d to %d\n", oldGroupId, newGroupId);
         return true;
@@ -122,17 +149,9 @@ public:
      * Update group remote address
      */
     static bool updateGroupRemoteAddress(uint8_t groupId, uint8_t remoteAddress) {
-        auto* group = getGroup(groupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
-            return false;
-        }
-        
-        group->remoteAddress = remoteAddress;
-        
-        if (!save()) {
-            return false;
-        }
+        ConfigOperation op(ConfigOperation::UPDATE_GROUP, groupId);
+        op.remote = remoteAddress;
+        if (!commit(op)) return false;
         
         Serial.printf("[ModbusService] Updated group %d remote address to %d\n", groupId, remoteAddress);
         return true;
@@ -142,18 +161,9 @@ public:
      * Update group (number of slaves)
      */
     static bool updateGroup(uint8_t groupId, uint8_t newSlaveCount) {
-        auto* group = getGroup(groupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
-            return false;
-        }
-        
-        group->updateSlaveCount(newSlaveCount);
-        
-        if (!save()) {
-            // Could restore old state here if needed
-            return false;
-        }
+        ConfigOperation op(ConfigOperation::UPDATE_GROUP, groupId);
+        op.slaveCount = newSlaveCount;
+        if (!commit(op)) return false;
         
         Serial.print("[ModbusService] Updated group ");
         Serial.println(groupId);
@@ -164,41 +174,20 @@ public:
      * Delete a group
      */
     static bool deleteGroup(uint8_t groupId) {
-        for (size_t i = 0; i < groups.size(); i++) {
-            if (groups[i].id == groupId) {
-                groups.erase(groups.begin() + i);
-                
-                if (!save()) {
-                    // Could restore here if needed
-                    return false;
-                }
-                
-                Serial.print("[ModbusService] Deleted group ");
-                Serial.println(groupId);
-                return true;
-            }
-        }
+        if (!commit(ConfigOperation(ConfigOperation::DELETE_GROUP, groupId))) return false;
         
-        Serial.println("[ModbusService] Group not found");
-        return false;
+        Serial.print("[ModbusService] Deleted group ");
+        Serial.println(groupId);
+        return true;
     }
     
     /**
      * Add register to group
      */
-    static bool addGroupRegister(uint8_t groupId, const Register& reg) {
-        auto* group = getGroup(groupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
-            return false;
-        }
-        
-        if (!group->addRegister(reg)) {
-            Serial.println("[ModbusService] Register ID already exists");
-            return false;
-        }
-        
-        return save();
+    static bool addGroupRegister(uint8_t groupId, uint16_t regId, const String& name) {
+        ConfigOperation op(ConfigOperation::ADD_REGISTER, groupId, 0, regId);
+        op.name = name;
+        return commit(op);
     }
     
     /**
@@ -206,60 +195,26 @@ public:
      */
     static bool updateGroupRegister(uint8_t groupId, uint16_t regId, 
                                    const String& newName, uint16_t newId) {
-        auto* group = getGroup(groupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
-            return false;
-        }
-        
-        if (!group->updateRegister(regId, newName, newId)) {
-            Serial.println("[ModbusService] Register not found or duplicate ID");
-            return false;
-        }
-        
-        return save();
+        ConfigOperation op(ConfigOperation::UPDATE_REGISTER, groupId, 0, regId);
+        op.name = newName;
+        op.setNewId(newId);
+        return commit(op);
     }
     
     /**
      * Delete group register
      */
     static bool deleteGroupRegister(uint8_t groupId, uint16_t regId) {
-        auto* group = getGroup(groupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
-            return false;
-        }
-        
-        if (!group->deleteRegister(regId)) {
-            Serial.println("[ModbusService] Register not found");
-            return false;
-        }
-        
-        return save();
+        return commit(ConfigOperation(ConfigOperation::DELETE_REGISTER, groupId, 0, regId));
     }
     
     /**
      * Add register to slave
      */
-    static bool addSlaveRegister(uint8_t groupId, uint8_t slaveId, const Register& reg) {
-        auto* group = getGroup(groupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
-            return false;
-        }
-        
-        auto* slave = group->getSlave(slaveId);
-        if (!slave) {
-            Serial.println("[ModbusService] Slave not found");
-            return false;
-        }
-        
-        if (!slave->addRegister(reg)) {
-            Serial.println("[ModbusService] Register ID already exists in slave");
-            return false;
-        }
-        
-        return save();
+    static bool addSlaveRegister(uint8_t groupId, uint8_t slaveId, uint16_t regId, const String& name) {
+        ConfigOperation op(ConfigOperation::ADD_REGISTER, groupId, slaveId, regId);
+        op.name = name;
+        return commit(op);
     }
     
     /**
@@ -267,60 +222,129 @@ public:
      */
     static bool updateSlaveRegister(uint8_t groupId, uint8_t slaveId, 
                                    uint16_t regId, const String& newName, uint16_t newId) {
-        auto* group = getGroup(groupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
-            return false;
-        }
-        
-        auto* slave = group->getSlave(slaveId);
-        if (!slave) {
-            Serial.println("[ModbusService] Slave not found");
-            return false;
-        }
-        
-        if (!slave->updateRegister(regId, newName, newId)) {
-            Serial.println("[ModbusService] Register not found or duplicate ID");
-            return false;
-        }
-        
-        return save();
+        ConfigOperation op(ConfigOperation::UPDATE_REGISTER, groupId, slaveId, regId);
+        op.name = newName;
+        op.setNewId(newId);
+        return commit(op);
     }
     
     /**
      * Delete slave register
      */
     static bool deleteSlaveRegister(uint8_t groupId, uint8_t slaveId, uint16_t regId) {
-        auto* group = getGroup(groupId);
-        if (!group) {
-            Serial.println("[ModbusService] Group not found");
+        return commit(ConfigOperation(ConfigOperation::DELETE_REGISTER, groupId, slaveId, regId));
+    }
+    
+    static constexpr size_t BATCH_BUSY = SIZE_MAX;  // applyBatch() failedIndex while an import runs
+    
+    /**
+     * Apply a list of operations as one transaction
+     * Operations run in order on a copy of the configuration; only if all succeed is
+     * the copy published and saved once. On failure nothing changes and failedIndex
+     * and error describe the first operation that did not apply (BATCH_BUSY: the
+     * staging copy is taken by an import).
+     */
+    static bool applyBatch(const std::vector<ConfigOperation>& operations, size_t& failedIndex, const char*& error) {
+        GroupList* updated = acquireStaging();
+        if (!updated) {
+            failedIndex = BATCH_BUSY;
+            error = "Another configuration change is in progress";
             return false;
         }
         
-        auto* slave = group->getSlave(slaveId);
-        if (!slave) {
-            Serial.println("[ModbusService] Slave not found");
-            return false;
+        bool applied = applyBatchTo(*updated, operations, failedIndex, error);
+        releaseStaging();
+        return applied;
+    }
+    
+    /**
+     * Borrow the staging list (emptied), nullptr while it is in use
+     * A change holds it for one call, an import from its first body chunk until it is answered.
+     * Waits up to CONFIG_STAGING_WAIT_MS for readers still pinning it from before the last publish.
+     */
+    static GroupList* acquireStaging() {
+        bool expected = false;
+        if (!stagingInUse.compare_exchange_strong(expected, true)) return nullptr;
+        
+        uint8_t index = 1 - active.load();
+        uint32_t startMs = millis();
+        while (readers[index] != 0) {
+            if (millis() - startMs >= CONFIG_STAGING_WAIT_MS) {
+                Serial.println("[ModbusService] Previous configuration still in use, change refused");
+                stagingInUse = false;
+                return nullptr;
+            }
+            delay(1);
         }
         
-        if (!slave->deleteRegister(regId)) {
-            Serial.println("[ModbusService] Register not found");
-            return false;
+        lists[index].clear();
+        return &lists[index];
+    }
+    
+    /**
+     * Return the staging list
+     * Whichever list is not published now (the staging list, or the one replaced by
+     * publishing it) is emptied if nobody reads it anymore, else by reclaim() later.
+     */
+    static void releaseStaging() {
+        uint8_t index = 1 - active.load();
+        if (readers[index] == 0) {
+            lists[index].clear();
+        }
+        stagingInUse = false;
+    }
+    
+    /**
+     * Replace the whole configuration (JSON import) with the staging list
+     * Rejects duplicate group IDs and duplicate register IDs within a group or slave
+     */
+    static bool replaceGroups(GroupList& newGroups, const char*& error) {
+        for (size_t i = 0; i < newGroups.size(); i++) {
+            for (size_t j = i + 1; j < newGroups.size(); j++) {
+                if (newGroups[i].id == newGroups[j].id) {
+                    error = "Duplicate group ID";
+                    return false;
+                }
+            }
+            if (hasDuplicateIds(newGroups[i].registers)) {
+                error = "Duplicate register ID in group";
+                return false;
+            }
+            for (const auto& slave : newGroups[i].slaves) {
+                if (hasDuplicateIds(slave.registerTemplate->registers)) {
+                    error = "Duplicate register ID in slave";
+                    return false;
+                }
+            }
         }
         
-        return save();
+        std::lock_guard<std::mutex> guard(lock);
+        publish(newGroups);
+        pendingOps.clear();
+        checkpointRequired = true;
+        storageRejected = false;
+        save();
+        
+        Serial.printf("[ModbusService] Imported %u groups\n", (unsigned)newGroups.size());
+        return true;
     }
     
     /**
      * Update register value (called when modbus reads new values)
      */
     static bool updateRegisterValue(uint8_t groupId, uint16_t regId, uint16_t value) {
-        auto* group = getGroup(groupId);
+        ReadGuard config;
+        auto* group = config.getGroup(groupId);
         if (!group) return false;
         
         auto* reg = group->getRegister(regId);
         if (reg) {
-            reg->value = value;
+            if (reg->value != value) {
+                reg->value = value;
+                ValueSyncService::markChanged(reg->slot);
+            }
+            WarmStartService::markFresh(reg->slot);
+            group->lastUpdateMs = millis();
             return true;
         }
         
@@ -332,15 +356,22 @@ public:
      */
     static bool updateSlaveRegisterValue(uint8_t groupId, uint8_t slaveId, 
                                         uint16_t regId, uint16_t value) {
-        auto* group = getGroup(groupId);
+        ReadGuard config;
+        auto* group = config.getGroup(groupId);
         if (!group) return false;
         
         auto* slave = group->getSlave(slaveId);
         if (!slave) return false;
         
-        auto* reg = slave->getRegister(regId);
-        if (reg) {
-            reg->value = value;
+        int index = slave->indexOf(regId);
+        if (index >= 0) {
+            uint16_t slot = slave->slotOf(index);
+            if (slave->values[index] != value) {
+                slave->values[index] = value;
+                ValueSyncService::markChanged(slot);
+            }
+            WarmStartService::markFresh(slot);
+            group->lastUpdateMs = millis();
             return true;
         }
         
@@ -348,17 +379,210 @@ public:
     }
     
     /**
-     * Save all groups to persistent storage
+     * Record a configuration change, the write to storage happens later in update()
+     * Callers hold the lock
+     */
+    static void save(const ConfigOperation& op) {
+        pendingOps.push_back(op);
+        save();
+    }
+    
+    /**
+     * Mark the configuration changed (operations already queued in pendingOps)
+     */
+    static void save() {
+        generation++;
+        lastChangeMs = millis();
+        if (!dirty) {
+            firstChangeMs = lastChangeMs;
+            dirty = true;
+        }
+    }
+    
+    /**
+     * Write pending changes once no edit arrived for CONFIG_SAVE_DELAY_MS,
+     * or CONFIG_SAVE_MAX_DELAY_MS after the first one (call from loop)
+     */
+    static void update() {
+        reclaim();
+        if (!dirty) return;
+        
+        uint32_t now = millis();
+        if (now - lastChangeMs < CONFIG_SAVE_DELAY_MS && now - firstChangeMs < CONFIG_SAVE_MAX_DELAY_MS) {
+            return;
+        }
+        flush();
+    }
+    
+    /**
+     * Write pending changes now (before a restart)
+     * On failure the changes stay pending and the next update() retries after the delay
+     */
+    static bool flush() {
+        std::unique_lock<std::mutex> guard(lock);
+        if (!dirty) return true;
+        
+        // Changes stay in memory until an import replaces the configuration that failed to load
+        if (storageRejected) {
+            firstChangeMs = lastChangeMs = millis();
+            return false;
+        }
+        
+        bool saved = false;
+        if (!checkpointRequired && !pendingOps.empty() &&
+            PreferencesService::getJournalSize() < CONFIG_JOURNAL_MAX_BYTES) {
+            saved = PreferencesService::appendJournal(journalSeq + 1, pendingOps);
+        }
+        
+        // Journal full or not writable: compact everything into a new checkpoint
+        if (!saved) {
+            // Writing it relinks the names into the checkpoint, so it is written from a
+            // copy that is then published (the templates stay shared, their names are
+            // relinked atomically). Like edits, take the staging list before the lock.
+            guard.unlock();
+            GroupList* staged = acquireStaging();
+            guard.lock();
+            
+            if (staged && dirty) {
+                *staged = lists[active];
+                saved = PreferencesService::saveGroups(*staged, journalSeq + 1);
+                if (saved) publish(*staged);
+            }
+            if (staged) releaseStaging();
+            if (!dirty) return true;  // Another flush saved meanwhile
+        }
+        
+        if (!saved) {
+            Serial.println("[ModbusService] Error: Could not save configuration, will retry");
+            firstChangeMs = lastChangeMs = millis();
+            return false;
+        }
+        
+        journalSeq++;
+        pendingOps.clear();
+        checkpointRequired = false;
+        dirty = false;
+        return true;
+    }
+    
+    /**
+     * True while changes are waiting to be written
      */
-    static bool save() {
-        return PreferencesService::saveGroups(groups);
+    static bool hasPendingChanges() {
+        return dirty;
+    }
+    
+    /**
+     * Configuration generation, changes whenever the configuration is saved
+     * Starts from a random value at boot so generations never repeat across restarts
+     */
+    static uint32_t getGeneration() {
+        return generation;
     }
     
     /**
      * Get count of groups
      */
     static size_t getGroupCount() {
-        return groups.size();
+        ReadGuard config;
+        return config.groups().size();
+    }
+    
+    /**
+     * Configuration size against the MODBUS_MAX_* limits and pool use
+     */
+    static CapacityData getCapacity();
+    
+    /**
+     * Empty the list replaced by the last publish once nobody reads it anymore (call from loop)
+     * Releases the register templates only it still holds
+     */
+    static void reclaim() {
+        uint8_t index = 1 - active.load();
+        if (lists[index].empty() || readers[index] != 0) return;
+        
+        bool expected = false;
+        if (!stagingInUse.compare_exchange_strong(expected, true)) return;
+        if (readers[index] == 0) {
+            lists[index].clear();
+        }
+        stagingInUse = false;
+    }
+    
+private:
+    /**
+     * Make a staged list the published configuration (holding the staging list and the lock)
+     * Shares its templates and maps its registers for COM1 first, then flips the index readers pin
+     */
+    static void publish(GroupList& staged);
+    
+    /**
+     * Apply one operation to a copy of the configuration and publish it (single-item edits)
+     */
+    static bool commit(const ConfigOperation& op) {
+        GroupList* staged = acquireStaging();
+        if (!staged) {
+            Serial.println("[ModbusService] Another configuration change is in progress");
+            return false;
+        }
+        
+        const char* error = nullptr;
+        bool applied = false;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            *staged = lists[active];
+            applied = op.apply(*staged, error);
+            if (applied) {
+                publish(*staged);
+                save(op);
+            }
+        }
+        releaseStaging();
+        
+        if (!applied) {
+            Serial.printf("[ModbusService] %s\n", error);
+        }
+        return applied;
+    }
+    
+    static bool applyBatchTo(GroupList& updated, const std::vector<ConfigOperation>& operations,
+                             size_t& failedIndex, const char*& error) {
+        std::lock_guard<std::mutex> guard(lock);
+        updated = lists[active];
+        
+        for (size_t i = 0; i < operations.size(); i++) {
+            if (!operations[i].apply(updated, error)) {
+                failedIndex = i;
+                Serial.printf("[ModbusService] Batch rejected at operation %u: %s\n", (unsigned)i, error);
+                return false;
+            }
+        }
+        
+        publish(updated);
+        pendingOps.insert(pendingOps.end(), operations.begin(), operations.end());
+        save();
+        
+        Serial.printf("[ModbusService] Applied batch of %u operations\n", (unsigned)operations.size());
+        return true;
+    }
+    
+    static Group* findGroup(GroupList& groups, uint8_t groupId) {
+        for (auto& group : groups) {
+            if (group.id == groupId) {
+                return &group;
+            }
+        }
+        return nullptr;
+    }
+    
+    template <typename RegisterList>
+    static bool hasDuplicateIds(const RegisterList& registers) {
+        for (size_t i = 0; i < registers.size(); i++) {
+            for (size_t j = i + 1; j < registers.size(); j++) {
+                if (registers[i].id == registers[j].id) return true;
+            }
+        }
+        return false;
     }
 };
 
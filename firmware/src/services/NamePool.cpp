@@ -0,0 +1,123 @@
+#include "NamePool.h"
+#include <string.h>
+
+// Static member initialization
+char* NamePool::chunks[CHUNK_COUNT] = {NamePool::emptyChunk};
+char NamePool::emptyChunk[1] = {'\0'};
+size_t NamePool::chunkCount = 0;
+size_t NamePool::chunkUsed = 0;
+const char* NamePool::segments[SEGMENT_COUNT] = {nullptr, nullptr, nullptr};
+std::vector<uint16_t> NamePool::index;
+size_t NamePool::nameCount = 0;
+uint32_t NamePool::reusedCount = 0;
+uint32_t NamePool::rejectedCount = 0;
+std::mutex NamePool::lock;
+
+uint16_t NamePool::intern(const char* text, size_t length) {
+    if (length == 0) return EMPTY;
+    if (length >= NAME_POOL_CHUNK_BYTES) {
+        length = NAME_POOL_CHUNK_BYTES - 1;     // A name has to fit in one chunk
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    uint32_t h = hash(text, length);
+
+    // Linear probing, the table is never more than half full
+    if (!index.empty()) {
+        size_t mask = index.size() - 1;
+        for (size_t i = h & mask; index[i] != EMPTY; i = (i + 1) & mask) {
+            const char* known = resolve(RAM_SEGMENT, index[i]);
+            if (strncmp(known, text, length) == 0 && known[length] == '\0') {
+                reusedCount++;
+                return index[i];
+            }
+        }
+    }
+
+    uint16_t offset = append(text, length);
+    if (offset == EMPTY) return EMPTY;
+
+    nameCount++;
+    if ((nameCount + 1) * 2 > index.size()) {
+        growIndex();
+    }
+    insertIndex(offset, h);
+    return offset;
+}
+
+size_t NamePool::getUsedBytes() {
+    std::lock_guard<std::mutex> guard(lock);
+    return chunkCount == 0 ? 0 : (chunkCount - 1) * NAME_POOL_CHUNK_BYTES + chunkUsed;
+}
+
+size_t NamePool::getNameCount() {
+    std::lock_guard<std::mutex> guard(lock);
+    return nameCount;
+}
+
+uint32_t NamePool::getReusedCount() {
+    std::lock_guard<std::mutex> guard(lock);
+    return reusedCount;
+}
+
+uint32_t NamePool::getRejectedCount() {
+    std::lock_guard<std::mutex> guard(lock);
+    return rejectedCount;
+}
+
+uint32_t NamePool::hash(const char* text, size_t length) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ (uint8_t)text[i]) * 16777619u;
+    }
+    return h;
+}
+
+uint16_t NamePool::append(const char* text, size_t length) {
+    // The first chunk starts with the empty name, so offset 0 is ""
+    if (chunkCount == 0 || chunkUsed + length + 1 > NAME_POOL_CHUNK_BYTES) {
+        char* chunk = chunkCount < CHUNK_COUNT ? (char*)malloc(NAME_POOL_CHUNK_BYTES) : nullptr;
+        if (!chunk) {
+            if (rejectedCount++ == 0) {
+                Serial.printf("[NamePool] Name arena full (%u bytes), changes with new names are rejected\n",
+                              (unsigned)getCapacity());
+            }
+            return EMPTY;
+        }
+        chunkUsed = 0;
+        if (chunkCount == 0) {
+            chunk[chunkUsed++] = '\0';
+        }
+        chunks[chunkCount++] = chunk;
+    }
+
+    char* dst = chunks[chunkCount - 1] + chunkUsed;
+    memcpy(dst, text, length);
+    dst[length] = '\0';
+
+    uint16_t offset = (chunkCount - 1) * NAME_POOL_CHUNK_BYTES + chunkUsed;
+    chunkUsed += length + 1;
+    return offset;
+}
+
+void NamePool::insertIndex(uint16_t offset, uint32_t h) {
+    size_t mask = index.size() - 1;
+    size_t i = h & mask;
+    while (index[i] != EMPTY) {
+        i = (i + 1) & mask;
+    }
+    index[i] = offset;
+}
+
+void NamePool::growIndex() {
+    std::vector<uint16_t> old;
+    old.swap(index);
+    index.assign(old.empty() ? 64 : old.size() * 2, EMPTY);
+
+    for (uint16_t offset : old) {
+        if (offset == EMPTY) continue;
+        const char* name = resolve(RAM_SEGMENT, offset);
+        insertIndex(offset, hash(name, strlen(name)));
+    }
+}
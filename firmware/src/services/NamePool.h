@@ -0,0 +1,86 @@
+#ifndef NAME_POOL_H
+#define NAME_POOL_H
+
+#include <Arduino.h>
+#include <mutex>
+#include <vector>
+#include "../config.h"
+
+/**
+ * NamePool stores group, template and register names, addressed by a segment and a 16-bit offset
+ * - Segment 0 is an append-only RAM arena of NAME_POOL_CHUNK_BYTES chunks, identical
+ *   names are interned once. Chunks never move, so names can be read without a lock.
+ * - Segments 1 and 2 are the name blobs of the two configuration partition slots
+ *   (memory-mapped flash), registered by ConfigCodec when it links names in place
+ * - Nothing is ever freed: the arena holds every name seen since boot, so each rename
+ *   to a new name keeps the old one until the next reboot (when only the names of the
+ *   stored configuration are loaded again). This stays small because configurations
+ *   reuse the same names over and over, and is bounded by NAME_POOL_MAX_BYTES: once
+ *   the arena is full, new names are refused and the change adding them is rejected
+ *   (callers compare getRejectedCount() before and after, see ConfigOperation::apply)
+ */
+class NamePool {
+public:
+    static constexpr uint8_t RAM_SEGMENT = 0;
+    static constexpr uint8_t FLASH_SEGMENT = 1;     // Partition slot 0, slot 1 is FLASH_SEGMENT + 1
+    static constexpr uint8_t SEGMENT_COUNT = 3;
+    static constexpr uint16_t EMPTY = 0;            // Offset of "" in the RAM segment
+
+    /**
+     * Offset of a name in the RAM segment, added if new
+     * Returns EMPTY and counts a rejection (logged once) when the arena is full
+     */
+    static uint16_t intern(const char* text, size_t length);
+
+    static uint16_t intern(const char* text) {
+        return intern(text, strlen(text));
+    }
+
+    /**
+     * Register the name blob of a flash segment, replaces what the segment referenced before
+     */
+    static void mapSegment(uint8_t segment, const char* names) {
+        if (segment >= FLASH_SEGMENT && segment < SEGMENT_COUNT) {
+            segments[segment] = names;
+        }
+    }
+
+    /**
+     * The null-terminated name at an offset of a segment
+     */
+    static const char* resolve(uint8_t segment, uint16_t offset) {
+        if (segment == RAM_SEGMENT) {
+            return chunks[offset / NAME_POOL_CHUNK_BYTES] + offset % NAME_POOL_CHUNK_BYTES;
+        }
+        return segments[segment] + offset;
+    }
+
+    // Statistics for telemetry
+    static size_t getUsedBytes();
+    static size_t getCapacity() { return CHUNK_COUNT * NAME_POOL_CHUNK_BYTES; }
+    static size_t getNameCount();
+    static uint32_t getReusedCount();
+    static uint32_t getRejectedCount();
+
+private:
+    static constexpr size_t CHUNK_COUNT = NAME_POOL_MAX_BYTES / NAME_POOL_CHUNK_BYTES;
+    static_assert(NAME_POOL_MAX_BYTES <= 0x10000, "Name offsets are 16 bits");
+
+    static char* chunks[CHUNK_COUNT];
+    static char emptyChunk[1];                  // Backs the empty name before the first chunk exists
+    static size_t chunkCount;
+    static size_t chunkUsed;                    // Bytes used in the last chunk
+    static const char* segments[SEGMENT_COUNT];
+    static std::vector<uint16_t> index;         // Open addressing table of offsets, EMPTY = free
+    static size_t nameCount;
+    static uint32_t reusedCount;
+    static uint32_t rejectedCount;              // Names refused because the arena was full
+    static std::mutex lock;
+
+    static uint32_t hash(const char* text, size_t length);
+    static uint16_t append(const char* text, size_t length);
+    static void insertIndex(uint16_t offset, uint32_t h);
+    static void growIndex();
+};
+
+#endif // NAME_POOL_H
@@ -1,6 +1,10 @@
 #include "PreferencesService.h"
 
 // Static member initialization
-const char* PreferencesService::MODBUS_FILE = "/modbus_config.json";
+const char* PreferencesService::MODBUS_FILE = "/modbus_config.bin";
+const char* PreferencesService::LEGACY_JSON_FILE = "/modbus_config.json";
+const char* PreferencesService::MODBUS_TMP_FILE = "/modbus_config.tmp";
+const char* PreferencesService::JOURNAL_FILE = "/modbus_journal.jsonl";
 const char* PreferencesService::INTERFACES_FILE = "/interfaces_config.json";
-const size_t PreferencesService::JSON_CAPACITY = 16384;  // 16KB for modbus config
+const char* PreferencesService::HISTORY_FILE = "/history_config.json";
+const char* PreferencesService::VALUE_SNAPSHOT_FILES[2] = { "/values_a.bin", "/values_b.bin" };
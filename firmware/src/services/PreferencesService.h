@@ -4,18 +4,156 @@
 #include <SPIFFS.h>
 #include <ArduinoJson.h>
 #include "../models/Group.h"
+#include "../models/ConfigOperation.h"
 #include "../models/InterfacesData.h"
+#include "TelemetryService.h"
+#include "ConfigCodec.h"
+#include "ConfigPartition.h"
+#include "ConfigStreamParser.h"
+#include "JsonPool.h"
 
 /**
  * PreferencesService handles persistent storage of configuration to SPIFFS
- * - Modbus groups configuration
+ * - Modbus groups configuration (checkpoint plus append-only journal of changes)
  * - Interface settings
  */
 class PreferencesService {
 private:
-    static const char* MODBUS_FILE;
+    static const char* MODBUS_FILE;         // Checkpoint (binary, see ConfigCodec)
+    static const char* LEGACY_JSON_FILE;    // Checkpoint of earlier firmware
+    static const char* MODBUS_TMP_FILE;     // Checkpoint being written
+    static const char* JOURNAL_FILE;        // Changes since the checkpoint
     static const char* INTERFACES_FILE;
-    static const size_t JSON_CAPACITY;
+    static const char* HISTORY_FILE;
+    static const char* VALUE_SNAPSHOT_FILES[2];  // Alternating register value snapshots (see WarmStartService)
+    
+    /**
+     * Read the binary checkpoint with a single read and decode it
+     * The whole file is buffered because decode needs it contiguous: the binary form is
+     * bounded by the MODBUS_MAX_* limits to a few tens of KB and only read at boot
+     * onlyIfNewer: a checkpoint not newer than seq is left alone (true, groups and seq unchanged)
+     */
+    static bool loadCheckpoint(GroupList& groups, uint32_t& seq, bool onlyIfNewer = false) {
+        File file = SPIFFS.open(MODBUS_FILE, "r");
+        if (!file) {
+            Serial.println("[PreferencesService] Error: Could not open modbus config file");
+            return false;
+        }
+        
+        size_t size = file.size();
+        uint8_t* data = (uint8_t*)malloc(size ? size : 1);
+        if (!data) {
+            file.close();
+            Serial.println("[PreferencesService] Error: Out of memory reading modbus config");
+            return false;
+        }
+        
+        size_t read = file.read(data, size);
+        file.close();
+        
+        uint32_t fileSeq = 0;
+        bool ok = read == size && ConfigCodec::check(data, size, fileSeq) == size;
+        if (ok && onlyIfNewer && fileSeq <= seq) {
+            free(data);
+            return true;
+        }
+        ok = ok && ConfigCodec::decode(data, size, groups, seq);
+        free(data);
+        
+        if (!ok) {
+            Serial.println("[PreferencesService] Error: Invalid modbus config file");
+        }
+        return ok;
+    }
+    
+    /**
+     * Read the JSON configuration written by earlier firmware (converted after loading)
+     */
+    static bool loadLegacyJson(GroupList& groups, uint32_t& seq) {
+        File file = SPIFFS.open(LEGACY_JSON_FILE, "r");
+        if (!file) {
+            Serial.println("[PreferencesService] Error: Could not open modbus config file");
+            return false;
+        }
+        
+        // Parsed group by group, so the file size is not limited by a JSON document capacity
+        // Earlier firmware allowed larger groups than an import does; at boot they may use the heap
+        ConfigStreamParser parser(groups, CONFIG_LEGACY_GROUP_MAX_BYTES);
+        char chunk[256];
+        size_t length;
+        while ((length = file.read((uint8_t*)chunk, sizeof(chunk))) > 0) {
+            if (!parser.feed(chunk, length)) break;
+        }
+        file.close();
+        
+        if (!parser.finish()) {
+            Serial.printf("[PreferencesService] Error: Invalid modbus config file: %s\n", parser.getError());
+            return false;
+        }
+        
+        seq = parser.getSeq();
+        Serial.printf("[PreferencesService] Parsed legacy JSON config, largest group %u bytes\n",
+                      (unsigned)parser.getPeakGroupBytes());
+        return true;
+    }
+    
+    /**
+     * Apply journal records newer than seq
+     * Returns false if the journal ends in a torn record or a record does not apply: the
+     * replay stops there (the operations of that record before the failing one stay applied)
+     */
+    static bool replayJournal(GroupList& groups, uint32_t& seq) {
+        if (!SPIFFS.exists(JOURNAL_FILE)) return true;
+        
+        File file = SPIFFS.open(JOURNAL_FILE, "r");
+        if (!file) {
+            Serial.println("[PreferencesService] Error: Could not open journal");
+            return false;
+        }
+        
+        // Every record ends in a newline, anything else is an interrupted append
+        bool clean = true;
+        if (file.size() > 0) {
+            file.seek(file.size() - 1);
+            clean = file.read() == '\n';
+            file.seek(0);
+        }
+        
+        size_t replayed = 0;
+        bool diverged = false;
+        while (!diverged && file.available()) {
+            String line = file.readStringUntil('\n');
+            if (line.length() == 0) continue;
+            
+            JsonPool::Document doc;
+            if (deserializeJson(doc, line) || !doc.containsKey("seq")) {
+                clean = false;
+                break;
+            }
+            
+            uint32_t recordSeq = doc["seq"];
+            if (recordSeq <= seq) continue;  // Already part of the checkpoint
+            
+            // Records were applied once already, a failure means the state has diverged
+            for (JsonObject opObj : doc["ops"].as<JsonArray>()) {
+                const char* error = nullptr;
+                if (!ConfigOperation::fromJson(opObj).apply(groups, error)) {
+                    Serial.printf("[PreferencesService] Error: Journal record %u does not apply: %s\n",
+                                  (unsigned)recordSeq, error);
+                    diverged = true;
+                    break;
+                }
+            }
+            if (diverged) break;
+            seq = recordSeq;
+            replayed++;
+        }
+        file.close();
+        
+        Serial.printf("[PreferencesService] Replayed %u journal records%s\n", (unsigned)replayed,
+                      diverged ? ", dropped the rest" : clean ? "" : ", dropped torn record");
+        return clean && !diverged;
+    }
     
     // Initialize SPIFFS if not already done
     static bool initSPIFFS() {
@@ -28,81 +166,197 @@ private:
     
 public:
     /**
-     * Load all groups from persistent storage
+     * Load all groups from persistent storage: the checkpoint, then the journal on top
+     * seq receives the sequence number of the last change contained in the result
      */
-    static bool loadGroups(std::vector<Group>& groups) {
+    static bool loadGroups(GroupList& groups, uint32_t& seq) {
+        TelemetryService::AllocationScope scope(TelemetryService::CONFIG);
         if (!initSPIFFS()) return false;
         
-        if (!SPIFFS.exists(MODBUS_FILE)) {
+        uint32_t startUs = micros();
+        seq = 0;
+        groups.clear();
+        
+        // Leftover from an interrupted compaction: the new checkpoint is only complete
+        // once the old one has been removed
+        if (SPIFFS.exists(MODBUS_TMP_FILE)) {
+            if (SPIFFS.exists(MODBUS_FILE)) {
+                SPIFFS.remove(MODBUS_TMP_FILE);
+            } else {
+                Serial.println("[PreferencesService] Completing interrupted checkpoint");
+                SPIFFS.rename(MODBUS_TMP_FILE, MODBUS_FILE);
+            }
+        }
+        
+        // The partition checkpoint is used in place, names stay in flash
+        bool usePartition = ConfigPartition::begin();
+        bool fromPartition = false;
+        if (usePartition) {
+            size_t size;
+            const uint8_t* data = ConfigPartition::current(size, seq);
+            if (data) {
+                uint8_t segment = NamePool::FLASH_SEGMENT + ConfigPartition::getCurrentSlot();
+                if (!ConfigCodec::decode(data, size, groups, seq, segment)) return false;
+                fromPartition = true;
+            }
+        }
+        
+        // SPIFFS holds the checkpoint without a partition, or if it did not fit there
+        // (decoded over the partition's groups only if newer, so no second list is needed)
+        bool migrate = false;
+        if (SPIFFS.exists(MODBUS_FILE)) {
+            uint32_t fileSeq = seq;
+            if (!loadCheckpoint(groups, fileSeq, fromPartition)) {
+                if (!fromPartition) return false;
+            } else if (!fromPartition || fileSeq > seq) {
+                seq = fileSeq;
+                fromPartition = false;
+                migrate = usePartition;
+            }
+        } else if (!fromPartition && SPIFFS.exists(LEGACY_JSON_FILE)) {
+            if (!loadLegacyJson(groups, seq)) return false;
+            migrate = true;
+        } else if (!fromPartition) {
             Serial.println("[PreferencesService] Modbus config file not found, starting fresh");
-            return true;  // Not an error, just starting fresh
         }
+        uint32_t checkpointUs = micros() - startUs;
         
-        File file = SPIFFS.open(MODBUS_FILE, "r");
+        // A torn or failing record is dropped; rewrite the checkpoint so new records are not appended behind it
+        if (!replayJournal(groups, seq) || migrate) {
+            if (saveGroups(groups, seq) && migrate) {
+                SPIFFS.remove(LEGACY_JSON_FILE);
+                Serial.println("[PreferencesService] Converted configuration to the current checkpoint format");
+            }
+        }
+        
+        Serial.printf("[PreferencesService] Loaded %u groups from %s (checkpoint %u us, total %u us)\n",
+                      (unsigned)groups.size(), fromPartition ? "config partition" : "SPIFFS",
+                      (unsigned)checkpointUs, (unsigned)(micros() - startUs));
+        return true;
+    }
+    
+    /**
+     * Write a checkpoint of all groups (without register values) and clear the journal
+     * With a config partition the checkpoint goes to its other slot and the names of
+     * groups are relinked into it (so groups must not be the published configuration). Otherwise (or if it does
+     * not fit) it is written to a temporary SPIFFS file first, so the old one stays
+     * valid until the new one is complete.
+     */
+    static bool saveGroups(GroupList& groups, uint32_t seq) {
+        TelemetryService::AllocationScope scope(TelemetryService::CONFIG);
+        if (!initSPIFFS()) return false;
+        
+        std::vector<uint8_t> data;
+        if (!ConfigCodec::encode(groups, seq, data)) {
+            Serial.println("[PreferencesService] Error: Configuration does not fit the checkpoint format");
+            return false;
+        }
+        
+        if (ConfigPartition::isAvailable()) {
+            const uint8_t* written = ConfigPartition::write(data.data(), data.size());
+            if (written) {
+                ConfigCodec::linkNames(written, groups, NamePool::FLASH_SEGMENT + ConfigPartition::getCurrentSlot());
+                if (SPIFFS.exists(MODBUS_FILE)) {
+                    SPIFFS.remove(MODBUS_FILE);
+                }
+                if (SPIFFS.exists(JOURNAL_FILE)) {
+                    SPIFFS.remove(JOURNAL_FILE);
+                }
+                Serial.printf("[PreferencesService] Saved checkpoint of %u groups (%u bytes) to config partition\n",
+                              (unsigned)groups.size(), (unsigned)data.size());
+                return true;
+            }
+            Serial.println("[PreferencesService] Checkpoint does not fit the config partition, using SPIFFS");
+        }
+        
+        File file = SPIFFS.open(MODBUS_TMP_FILE, "w");
         if (!file) {
-            Serial.println("[PreferencesService] Error: Could not open modbus config file");
+            Serial.println("[PreferencesService] Error: Could not open modbus config file for writing");
             return false;
         }
         
-        DynamicJsonDocument doc(JSON_CAPACITY);
-        DeserializationError error = deserializeJson(doc, file);
+        size_t written = file.write(data.data(), data.size());
         file.close();
         
-        if (error) {
-            Serial.print("[PreferencesService] JSON deserialization error: ");
-            Serial.println(error.c_str());
+        if (written != data.size()) {
+            Serial.println("[PreferencesService] Error: Short write to modbus config file");
+            SPIFFS.remove(MODBUS_TMP_FILE);
             return false;
         }
         
-        groups.clear();
-        if (doc.containsKey("groups")) {
-            auto groupsArray = doc["groups"].as<JsonArray>();
-            for (const auto& groupObj : groupsArray) {
-                groups.push_back(Group::fromJson(groupObj));
-            }
+        // SPIFFS cannot rename over an existing file
+        if (SPIFFS.exists(MODBUS_FILE)) {
+            SPIFFS.remove(MODBUS_FILE);
+        }
+        if (!SPIFFS.rename(MODBUS_TMP_FILE, MODBUS_FILE)) {
+            Serial.println("[PreferencesService] Error: Could not replace modbus config file");
+            return false;
+        }
+        
+        // Every journal record up to seq is part of the checkpoint now
+        if (SPIFFS.exists(JOURNAL_FILE)) {
+            SPIFFS.remove(JOURNAL_FILE);
         }
         
-        Serial.print("[PreferencesService] Loaded ");
-        Serial.print(groups.size());
-        Serial.println(" groups from SPIFFS");
+        Serial.printf("[PreferencesService] Saved checkpoint of %u groups (%u bytes)\n",
+                      (unsigned)groups.size(), (unsigned)data.size());
         return true;
     }
     
     /**
-     * Save all groups to persistent storage (without register values)
+     * Append one journal record, a JSON line {"seq":N,"ops":[...]}
+     * The record is written with a single write, so a power loss loses at most this record
+     * Returns false if it could not be built or written (the caller falls back to a checkpoint)
      */
-    static bool saveGroups(const std::vector<Group>& groups) {
+    static bool appendJournal(uint32_t seq, const std::vector<ConfigOperation>& operations) {
+        TelemetryService::AllocationScope scope(TelemetryService::CONFIG);
         if (!initSPIFFS()) return false;
         
-        DynamicJsonDocument doc(JSON_CAPACITY);
-        auto groupsArray = doc.createNestedArray("groups");
-        
-        for (const auto& group : groups) {
-            auto groupObj = groupsArray.createNestedObject();
-            // Save without values - values are only in memory
-            group.toJson(groupObj, false);
+        JsonPool::Document doc;
+        doc["seq"] = seq;
+        auto opsArray = doc.createNestedArray("ops");
+        for (const auto& op : operations) {
+            auto opObj = opsArray.createNestedObject();
+            op.toJson(opObj);
         }
         
-        File file = SPIFFS.open(MODBUS_FILE, "w");
-        if (!file) {
-            Serial.println("[PreferencesService] Error: Could not open modbus config file for writing");
+        // A record that did not fit in memory is not written, the caller writes a checkpoint instead
+        String line;
+        if (doc.overflowed() || serializeJson(doc, line) != measureJson(doc)) {
+            Serial.println("[PreferencesService] Error: Out of memory building journal record");
             return false;
         }
+        line += '\n';
         
-        if (serializeJson(doc, file) == 0) {
-            Serial.println("[PreferencesService] Error: Could not serialize groups to JSON");
-            file.close();
+        File file = SPIFFS.open(JOURNAL_FILE, "a");
+        if (!file) {
+            Serial.println("[PreferencesService] Error: Could not open journal for appending");
             return false;
         }
         
+        size_t written = file.write((const uint8_t*)line.c_str(), line.length());
         file.close();
         
-        Serial.print("[PreferencesService] Saved ");
-        Serial.print(groups.size());
-        Serial.println(" groups to SPIFFS (without values)");
+        if (written != line.length()) {
+            Serial.println("[PreferencesService] Error: Short write to journal");
+            return false;
+        }
         return true;
     }
     
+    /**
+     * Size of the journal in bytes (0 if there is none)
+     */
+    static size_t getJournalSize() {
+        if (!initSPIFFS() || !SPIFFS.exists(JOURNAL_FILE)) return 0;
+        
+        File file = SPIFFS.open(JOURNAL_FILE, "r");
+        if (!file) return 0;
+        size_t size = file.size();
+        file.close();
+        return size;
+    }
+    
     /**
      * Load interface configuration from persistent storage
      */
@@ -120,7 +374,7 @@ public:
             return false;
         }
         
-        DynamicJsonDocument doc(256);
+        JsonPool::Document doc;
         DeserializationError error = deserializeJson(doc, file);
         file.close();
         
@@ -143,7 +397,7 @@ public:
     static bool saveInterfaces(const InterfacesData& data) {
         if (!initSPIFFS()) return false;
         
-        DynamicJsonDocument doc(256);
+        JsonPool::Document doc;
         JsonObject obj = doc.to<JsonObject>();
         data.toJson(obj);
         
@@ -165,6 +419,114 @@ public:
         return true;
     }
     
+    /**
+     * Load the registers selected for history (tokens [group:8][slave:8][reg:16])
+     */
+    static bool loadHistorySeries(std::vector<uint32_t>& tokens) {
+        if (!initSPIFFS()) return false;
+        
+        if (!SPIFFS.exists(HISTORY_FILE)) {
+            return true;  // Nothing tracked yet
+        }
+        
+        File file = SPIFFS.open(HISTORY_FILE, "r");
+        if (!file) {
+            Serial.println("[PreferencesService] Error: Could not open history config file");
+            return false;
+        }
+        
+        JsonPool::Document doc;
+        DeserializationError error = deserializeJson(doc, file);
+        file.close();
+        
+        if (error) {
+            Serial.print("[PreferencesService] JSON deserialization error: ");
+            Serial.println(error.c_str());
+            return false;
+        }
+        
+        tokens.clear();
+        for (const auto& entry : doc["series"].as<JsonArray>()) {
+            tokens.push_back(((uint32_t)(entry["group"] | 0) << 24) |
+                             ((uint32_t)(entry["slave"] | 0) << 16) |
+                             (uint16_t)(entry["reg"] | 0));
+        }
+        return true;
+    }
+    
+    /**
+     * Save the registers selected for history
+     */
+    static bool saveHistorySeries(const std::vector<uint32_t>& tokens) {
+        if (!initSPIFFS()) return false;
+        
+        JsonPool::Document doc;
+        auto seriesArray = doc.createNestedArray("series");
+        for (uint32_t token : tokens) {
+            auto entry = seriesArray.createNestedObject();
+            entry["group"] = (token >> 24) & 0xFF;
+            entry["slave"] = (token >> 16) & 0xFF;
+            entry["reg"] = token & 0xFFFF;
+        }
+        
+        File file = SPIFFS.open(HISTORY_FILE, "w");
+        if (!file) {
+            Serial.println("[PreferencesService] Error: Could not open history config file for writing");
+            return false;
+        }
+        
+        if (serializeJson(doc, file) == 0) {
+            Serial.println("[PreferencesService] Error: Could not serialize history selection to JSON");
+            file.close();
+            return false;
+        }
+        
+        file.close();
+        return true;
+    }
+    
+    /**
+     * Read register value snapshot 0 or 1, data is left empty if there is none
+     */
+    static bool loadValueSnapshot(uint8_t index, std::vector<uint8_t>& data) {
+        data.clear();
+        if (index > 1 || !initSPIFFS()) return false;
+        if (!SPIFFS.exists(VALUE_SNAPSHOT_FILES[index])) return true;
+        
+        File file = SPIFFS.open(VALUE_SNAPSHOT_FILES[index], "r");
+        if (!file) {
+            Serial.println("[PreferencesService] Error: Could not open value snapshot");
+            return false;
+        }
+        
+        data.resize(file.size());
+        size_t length = file.read(data.data(), data.size());
+        file.close();
+        data.resize(length);
+        return true;
+    }
+    
+    /**
+     * Overwrite register value snapshot 0 or 1
+     */
+    static bool saveValueSnapshot(uint8_t index, const uint8_t* data, size_t size) {
+        if (index > 1 || !initSPIFFS()) return false;
+        
+        File file = SPIFFS.open(VALUE_SNAPSHOT_FILES[index], "w");
+        if (!file) {
+            Serial.println("[PreferencesService] Error: Could not open value snapshot for writing");
+            return false;
+        }
+        
+        size_t written = file.write(data, size);
+        file.close();
+        if (written != size) {
+            Serial.println("[PreferencesService] Error: Could not write value snapshot");
+            return false;
+        }
+        return true;
+    }
+    
     /**
      * Get available space on SPIFFS
      */
@@ -1,5 +1,9 @@
 #include "RegisterMappingService.h"
 
 // Static member initialization
-std::map<uint8_t, std::map<uint16_t, uint16_t*>> RegisterMappingService::registerMap;
+RegisterMappingService::GroupSlots RegisterMappingService::groupSlots[MODBUS_MAX_GROUPS];
+size_t RegisterMappingService::groupCount = 0;
+uint16_t* RegisterMappingService::slotValues[MODBUS_MAX_SLOTS];
+size_t RegisterMappingService::slotCount = 0;
 bool RegisterMappingService::initialized = false;
+std::mutex RegisterMappingService::lock;
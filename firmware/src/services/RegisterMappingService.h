@@ -2,9 +2,12 @@
 #define REGISTER_MAPPING_SERVICE_H
 
 #include <Arduino.h>
-#include <vector>
-#include <map>
+#include <mutex>
+#include "../config.h"
 #include "ModbusService.h"
+#include "TelemetryService.h"
+#include "ValueSyncService.h"
+#include "WarmStartService.h"
 
 /**
  * RegisterMappingService creates fast pointer-based mappings 
@@ -12,12 +15,28 @@
  * 
  * Group ID = Modbus Server ID on COM1
  * Registers are mapped sequentially: group registers, then slave registers
+ * 
+ * Slots follow the same order over all groups, so the mapping is one static table of
+ * value pointers in slot order plus the first slot of each group: an address is an
+ * offset from its group's first slot. Nothing is allocated after boot.
+ * 
+ * The mapping is read from the COM1, loop and web tasks. buildMapping() rewrites the
+ * tables under the lock every reader takes.
  */
 class RegisterMappingService {
 private:
-    // Map structure: [groupId][registerAddress] -> pointer to value
-    static std::map<uint8_t, std::map<uint16_t, uint16_t*>> registerMap;
+    struct GroupSlots {
+        uint8_t id;
+        uint16_t firstSlot;
+        uint16_t count;
+    };
+    
+    static GroupSlots groupSlots[MODBUS_MAX_GROUPS];
+    static size_t groupCount;
+    static uint16_t* slotValues[MODBUS_MAX_SLOTS];  // Value pointers in slot order
+    static size_t slotCount;
     static bool initialized;
+    static std::mutex lock;                     // Held while the mapping is read or replaced
     
 public:
     /**
@@ -25,54 +44,53 @@ public:
      * Call this after loading groups or when groups change
      */
     static void buildMapping() {
-        registerMap.clear();
-        
-        auto& groups = ModbusService::getGroupsMutable();
-        
-        for (auto& group : groups) {
-            uint16_t address = 0;  // Start at address 0 for each group
-            
-            // Map group-level registers first
-            for (auto& reg : group.registers) {
-                registerMap[group.id][address] = &reg.value;
-                Serial.printf("[Mapping] Group %d: Address %d -> Group Register %d\n", 
-                             group.id, address, reg.id);
-                address++;
-            }
-            
-            // Then map slave registers sequentially
-            for (auto& slave : group.slaves) {
-                for (auto& reg : slave.registers) {
-                    registerMap[group.id][address] = &reg.value;
-                    Serial.printf("[Mapping] Group %d: Address %d -> Slave %d Register %d\n", 
-                                 group.id, address, slave.id, reg.id);
-                    address++;
+        buildMapping(ModbusService::getGroupsMutable());
+    }
+    
+    /**
+     * Build the register mapping of a list of groups, assigning their slots
+     */
+    static void buildMapping(GroupList& groups) {
+        TelemetryService::AllocationScope scope(TelemetryService::MAPPING);
+        size_t slots = 0;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            groupCount = 0;
+            for (auto& group : groups) {
+                // Address 0 of each group is its first slot
+                GroupSlots& entry = groupSlots[groupCount++];
+                entry.id = group.id;
+                entry.firstSlot = slots;
+                
+                // Map group-level registers first
+                for (auto& reg : group.registers) {
+                    reg.slot = slots;
+                    slotValues[slots++] = &reg.value;
+                }
+                
+                // Then map slave registers sequentially, in template order
+                for (auto& slave : group.slaves) {
+                    slave.firstSlot = slots;
+                    for (size_t i = 0; i < slave.registerCount(); i++) {
+                        slotValues[slots++] = &slave.values[i];
+                    }
                 }
+                entry.count = slots - entry.firstSlot;
             }
-            
-            Serial.printf("[Mapping] Group %d: Total %d registers mapped\n", group.id, address);
+            slotCount = slots;
+            initialized = true;
         }
         
-        initialized = true;
-        Serial.printf("[Mapping] Complete: %d groups mapped\n", groups.size());
+        ValueSyncService::resetLayout(slots);
+        WarmStartService::resetLayout();
+        Serial.printf("[Mapping] Complete: %u groups mapped, %u slots\n", (unsigned)groups.size(), (unsigned)slots);
     }
     
     /**
-     * Get pointer to register value by group ID and address
-     * Returns nullptr if not found
+     * Bytes of the static tables (see /api/capacity)
      */
-    static uint16_t* getRegisterPointer(uint8_t groupId, uint16_t address) {
-        auto groupIt = registerMap.find(groupId);
-        if (groupIt == registerMap.end()) {
-            return nullptr;  // Group not found
-        }
-        
-        auto regIt = groupIt->second.find(address);
-        if (regIt == groupIt->second.end()) {
-            return nullptr;  // Register not found
-        }
-        
-        return regIt->second;
+    static constexpr size_t getStaticBytes() {
+        return sizeof(groupSlots) + sizeof(slotValues);
     }
     
     /**
@@ -80,6 +98,7 @@ public:
      * Returns true if found, value is set in output parameter
      */
     static bool readRegister(uint8_t groupId, uint16_t address, uint16_t& value) {
+        std::lock_guard<std::mutex> guard(lock);
         uint16_t* ptr = getRegisterPointer(groupId, address);
         if (ptr) {
             value = *ptr;
@@ -94,30 +113,31 @@ public:
      * Note: This writes to the local cache, use with caution
      */
     static bool writeRegister(uint8_t groupId, uint16_t address, uint16_t value) {
-        uint16_t* ptr = getRegisterPointer(groupId, address);
-        if (ptr) {
-            *ptr = value;
-            return true;
+        std::lock_guard<std::mutex> guard(lock);
+        int slot = getRegisterSlot(groupId, address);
+        if (slot < 0) return false;
+        if (*slotValues[slot] != value) {
+            *slotValues[slot] = value;
+            ValueSyncService::markChanged(slot);
         }
-        return false;
+        return true;
     }
     
     /**
      * Get total register count for a group
      */
     static size_t getRegisterCount(uint8_t groupId) {
-        auto groupIt = registerMap.find(groupId);
-        if (groupIt == registerMap.end()) {
-            return 0;
-        }
-        return groupIt->second.size();
+        std::lock_guard<std::mutex> guard(lock);
+        const GroupSlots* entry = findGroup(groupId);
+        return entry ? entry->count : 0;
     }
     
     /**
      * Check if group exists
      */
     static bool groupExists(uint8_t groupId) {
-        return registerMap.find(groupId) != registerMap.end();
+        std::lock_guard<std::mutex> guard(lock);
+        return findGroup(groupId) != nullptr;
     }
     
     /**
@@ -126,7 +146,8 @@ public:
      */
     static bool getRegisterInfo(uint8_t groupId, uint16_t address, 
                                 uint8_t& outSlaveId, uint16_t& outRegId) {
-        const auto& groups = ModbusService::getGroups();
+        ModbusService::ReadGuard config;
+        const auto& groups = config.groups();
         
         for (const auto& group : groups) {
             if (group.id != groupId) continue;
@@ -143,16 +164,14 @@ public:
                 currentAddr++;
             }
             
-            // Check slave registers
+            // Check slave registers, each slave spans its template
             for (const auto& slave : group.slaves) {
-                for (const auto& reg : slave.registers) {
-                    if (currentAddr == address) {
-                        outSlaveId = slave.id;
-                        outRegId = reg.id;
-                        return true;
-                    }
-                    currentAddr++;
+                if (address < currentAddr + slave.registerCount()) {
+                    outSlaveId = slave.id;
+                    outRegId = slave.getDefinition(address - currentAddr).id;
+                    return true;
                 }
+                currentAddr += slave.registerCount();
             }
             
             return false;  // Address not found in this group
@@ -161,12 +180,72 @@ public:
         return false;  // Group not found
     }
     
+    /**
+     * Number of slots (registers over all groups)
+     */
+    static size_t getSlotCount() {
+        std::lock_guard<std::mutex> guard(lock);
+        return slotCount;
+    }
+    
+    /**
+     * Read a value by slot
+     */
+    static bool readSlot(uint16_t slot, uint16_t& value) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (slot >= slotCount) return false;
+        value = *slotValues[slot];
+        return true;
+    }
+    
+    /**
+     * Write a value by slot (restoring cached values, COM2 updates go through ModbusService)
+     */
+    static bool writeSlot(uint16_t slot, uint16_t value) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (slot >= slotCount) return false;
+        if (*slotValues[slot] != value) {
+            *slotValues[slot] = value;
+            ValueSyncService::markChanged(slot);
+        }
+        return true;
+    }
+    
     /**
      * Check if initialized
      */
     static bool isInitialized() {
         return initialized;
     }
+    
+private:
+    /**
+     * Mapping entry of a group, nullptr if not mapped (callers hold the lock)
+     */
+    static const GroupSlots* findGroup(uint8_t groupId) {
+        for (size_t i = 0; i < groupCount; i++) {
+            if (groupSlots[i].id == groupId) return &groupSlots[i];
+        }
+        return nullptr;
+    }
+    
+    /**
+     * Slot of a register by group ID and address, -1 if not found (callers hold the lock)
+     */
+    static int getRegisterSlot(uint8_t groupId, uint16_t address) {
+        const GroupSlots* entry = findGroup(groupId);
+        if (!entry || address >= entry->count) return -1;
+        return entry->firstSlot + address;
+    }
+    
+    /**
+     * Pointer to a register value by group ID and address, nullptr if not found
+     * Callers hold the lock, the pointer is only valid while they do
+     */
+    static uint16_t* getRegisterPointer(uint8_t groupId, uint16_t address) {
+        int slot = getRegisterSlot(groupId, address);
+        return slot < 0 ? nullptr : slotValues[slot];
+    }
 };
 
 #endif // REGISTER_MAPPING_SERVICE_H
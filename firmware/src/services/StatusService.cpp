@@ -4,15 +4,55 @@
 // Static member initialization
 StatusData StatusService::currentStatus;
 unsigned long StatusService::startTime = 0;
+std::atomic<uint32_t> StatusService::uart1Sent(0);
+std::atomic<uint32_t> StatusService::uart1Received(0);
+std::atomic<uint32_t> StatusService::uart2Sent(0);
+std::atomic<uint32_t> StatusService::uart2Received(0);
+std::atomic<uint32_t> StatusService::uart2DuplicatesAvoided(0);
+ErrorCounters StatusService::uart1Errors;
+ErrorCounters StatusService::uart2Errors;
+Histogram StatusService::com1Fc03ServiceUs;
+Histogram StatusService::com1Fc06ServiceUs;
+Histogram StatusService::com2Fc03RttUs;
+Histogram StatusService::com2Fc06RttUs;
+Histogram StatusService::com2QueueWaitUs;
 
 const StatusData& StatusService::getStatus() {
     // Update uptime
     unsigned long millisElapsed = millis() - startTime;
     currentStatus.uptime = millisElapsed / 1000;
     
+    // Snapshot frame counters and latency histograms
+    currentStatus.uart1_sent = uart1Sent.load(std::memory_order_relaxed);
+    currentStatus.uart1_received = uart1Received.load(std::memory_order_relaxed);
+    currentStatus.uart2_sent = uart2Sent.load(std::memory_order_relaxed);
+    currentStatus.uart2_received = uart2Received.load(std::memory_order_relaxed);
+    currentStatus.uart2_duplicates_avoided = uart2DuplicatesAvoided.load(std::memory_order_relaxed);
+    currentStatus.com1_fc03_service_us = com1Fc03ServiceUs.snapshot();
+    currentStatus.com1_fc06_service_us = com1Fc06ServiceUs.snapshot();
+    currentStatus.com2_fc03_rtt_us = com2Fc03RttUs.snapshot();
+    currentStatus.com2_fc06_rtt_us = com2Fc06RttUs.snapshot();
+    currentStatus.com2_queue_wait_us = com2QueueWaitUs.snapshot();
+    
     // Update polling metrics
     currentStatus.ongoing_requests = ModbusPollingService::getOngoingRequests();
     currentStatus.poll_delay_ms = ModbusPollingService::getPollDelayMs();
+    currentStatus.poll = ModbusPollingService::getMetrics(false);
+    
+    // Update COM2 timing statistics
+    Comport2* com2 = ModbusPollingService::getComport();
+    if (com2) {
+        currentStatus.com2_remotes = com2->getRemoteTimings();
+        currentStatus.uart2_timeout_ms = com2->getAppliedTimeoutMs();
+        currentStatus.uart2_timeout_min = com2->getTimeoutFloorMs();
+        currentStatus.uart2_timeout_max = com2->getTimeoutCeilingMs();
+        currentStatus.uart2_timeouts = 0;
+        currentStatus.uart2_late_responses = 0;
+        for (const auto& remote : currentStatus.com2_remotes) {
+            currentStatus.uart2_timeouts += remote.timeouts;
+            currentStatus.uart2_late_responses += remote.lateResponses;
+        }
+    }
     
     return currentStatus;
 }
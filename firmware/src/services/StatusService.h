@@ -2,7 +2,10 @@
 #define STATUS_SERVICE_H
 
 #include <Arduino.h>
+#include <atomic>
 #include "../models/StatusData.h"
+#include "../models/Histogram.h"
+#include "../models/ErrorCounters.h"
 
 /**
  * StatusService tracks system status and statistics
@@ -12,6 +15,24 @@ private:
     static StatusData currentStatus;
     static unsigned long startTime;
     
+    // Frame counters, updated from the eModbus worker tasks
+    static std::atomic<uint32_t> uart1Sent;
+    static std::atomic<uint32_t> uart1Received;
+    static std::atomic<uint32_t> uart2Sent;
+    static std::atomic<uint32_t> uart2Received;
+    static std::atomic<uint32_t> uart2DuplicatesAvoided;
+    
+    // Error counters by code
+    static ErrorCounters uart1Errors;       // Exceptions returned to the COM1 master
+    static ErrorCounters uart2Errors;       // Exceptions and eModbus errors on COM2 requests
+    
+    // Latency histograms (microseconds)
+    static Histogram com1Fc03ServiceUs;     // COM1 FC03 handler entry to return
+    static Histogram com1Fc06ServiceUs;     // COM1 FC06 handler entry to return
+    static Histogram com2Fc03RttUs;         // COM2 FC03 round trip on the wire
+    static Histogram com2Fc06RttUs;         // COM2 FC06 round trip on the wire
+    static Histogram com2QueueWaitUs;       // COM2 time from queueing to the wire
+    
 public:
     /**
      * Initialize StatusService
@@ -19,10 +40,7 @@ public:
     static void init() {
         startTime = millis();
         currentStatus.uptime = 0;
-        currentStatus.uart1_sent = 0;
-        currentStatus.uart1_received = 0;
-        currentStatus.uart2_sent = 0;
-        currentStatus.uart2_received = 0;
+        resetCounters();
         currentStatus.eth_status = "unknown";
         currentStatus.eth_ip = "0.0.0.0";
     }
@@ -41,31 +59,84 @@ public:
     }
     
     /**
-     * Increment UART1 sent counter
+     * Increment UART1 sent frame counter
      */
     static void addUart1Sent(uint32_t count = 1) {
-        currentStatus.uart1_sent += count;
+        uart1Sent.fetch_add(count, std::memory_order_relaxed);
     }
     
     /**
-     * Increment UART1 received counter
+     * Increment UART1 received frame counter
      */
     static void addUart1Received(uint32_t count = 1) {
-        currentStatus.uart1_received += count;
+        uart1Received.fetch_add(count, std::memory_order_relaxed);
     }
     
     /**
-     * Increment UART2 sent counter
+     * Increment UART2 sent frame counter
      */
     static void addUart2Sent(uint32_t count = 1) {
-        currentStatus.uart2_sent += count;
+        uart2Sent.fetch_add(count, std::memory_order_relaxed);
     }
     
     /**
-     * Increment UART2 received counter
+     * Increment UART2 received frame counter
      */
     static void addUart2Received(uint32_t count = 1) {
-        currentStatus.uart2_received += count;
+        uart2Received.fetch_add(count, std::memory_order_relaxed);
+    }
+    
+    /**
+     * Increment counter of UART2 reads merged into an in-flight request
+     */
+    static void addUart2DuplicateAvoided(uint32_t count = 1) {
+        uart2DuplicatesAvoided.fetch_add(count, std::memory_order_relaxed);
+    }
+    
+    /**
+     * Count an exception response sent on UART1
+     */
+    static void addUart1Error(uint8_t code) {
+        uart1Errors.add(code);
+    }
+    
+    /**
+     * Count a failed UART2 request by error code
+     */
+    static void addUart2Error(uint8_t code) {
+        uart2Errors.add(code);
+    }
+    
+    static const ErrorCounters& getUart1Errors() { return uart1Errors; }
+    static const ErrorCounters& getUart2Errors() { return uart2Errors; }
+    
+    /**
+     * Record COM1 handler service time for a function code
+     */
+    static void recordCom1Service(uint8_t functionCode, uint32_t us) {
+        if (functionCode == 0x06) {
+            com1Fc06ServiceUs.record(us);
+        } else {
+            com1Fc03ServiceUs.record(us);
+        }
+    }
+    
+    /**
+     * Record COM2 round-trip time for a function code
+     */
+    static void recordCom2Rtt(uint8_t functionCode, uint32_t us) {
+        if (functionCode == 0x06) {
+            com2Fc06RttUs.record(us);
+        } else {
+            com2Fc03RttUs.record(us);
+        }
+    }
+    
+    /**
+     * Record how long a COM2 request waited in the eModbus queue
+     */
+    static void recordCom2QueueWait(uint32_t us) {
+        com2QueueWaitUs.record(us);
     }
     
     /**
@@ -84,10 +155,23 @@ public:
     static void reset() {
         startTime = millis();
         currentStatus.uptime = 0;
-        currentStatus.uart1_sent = 0;
-        currentStatus.uart1_received = 0;
-        currentStatus.uart2_sent = 0;
-        currentStatus.uart2_received = 0;
+        resetCounters();
+    }
+    
+private:
+    static void resetCounters() {
+        uart1Sent = 0;
+        uart1Received = 0;
+        uart2Sent = 0;
+        uart2Received = 0;
+        uart2DuplicatesAvoided = 0;
+        uart1Errors.reset();
+        uart2Errors.reset();
+        com1Fc03ServiceUs.reset();
+        com1Fc06ServiceUs.reset();
+        com2Fc03RttUs.reset();
+        com2Fc06RttUs.reset();
+        com2QueueWaitUs.reset();
     }
 };
 
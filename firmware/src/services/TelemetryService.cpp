@@ -0,0 +1,145 @@
+#include "TelemetryService.h"
+#include "NamePool.h"
+#include "JsonPool.h"
+
+// Static member initialization
+bool TelemetryService::initialized = false;
+unsigned long TelemetryService::lastSampleTime = 0;
+TelemetrySample TelemetryService::samples[TELEMETRY_SAMPLE_COUNT];
+size_t TelemetryService::sampleHead = 0;
+size_t TelemetryService::sampleCount = 0;
+std::mutex TelemetryService::samplesLock;
+TelemetryService::WatchedTask TelemetryService::tasks[TELEMETRY_MAX_TASKS];
+std::atomic<size_t> TelemetryService::taskCount(0);
+std::mutex TelemetryService::tasksLock;
+TelemetryService::Allocations TelemetryService::allocations[SUBSYSTEM_COUNT];
+const char* const TelemetryService::SUBSYSTEM_NAMES[SUBSYSTEM_COUNT] = {
+    "config", "mapping", "polling"
+};
+
+void TelemetryService::watchTask(const char* name, TaskHandle_t handle) {
+    if (!handle) return;
+
+    std::lock_guard<std::mutex> lock(tasksLock);
+    size_t count = taskCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; i++) {
+        if (tasks[i].handle == handle) return;
+    }
+    if (count >= TELEMETRY_MAX_TASKS) {
+        Serial.printf("[Telemetry] Task table full, not watching %s\n", name);
+        return;
+    }
+
+    tasks[count].name = name;
+    tasks[count].handle = handle;
+    tasks[count].stackFreeMin = uxTaskGetStackHighWaterMark(handle);
+    // Publish the entry after it is complete
+    taskCount.store(count + 1, std::memory_order_release);
+    Serial.printf("[Telemetry] Watching task %s\n", name);
+}
+
+TelemetrySample TelemetryService::measure() {
+    TelemetrySample s;
+    s.timestampMs = millis();
+    s.freeHeap = ESP.getFreeHeap();
+    s.largestBlock = ESP.getMaxAllocHeap();
+    s.minFreeHeap = ESP.getMinFreeHeap();
+    return s;
+}
+
+void TelemetryService::sample() {
+    lastSampleTime = millis();
+    TelemetrySample s = measure();
+
+    {
+        std::lock_guard<std::mutex> lock(samplesLock);
+        samples[sampleHead] = s;
+        sampleHead = (sampleHead + 1) % TELEMETRY_SAMPLE_COUNT;
+        if (sampleCount < TELEMETRY_SAMPLE_COUNT) sampleCount++;
+    }
+
+    // The high-water mark only decreases, reading it is enough to keep the minimum
+    std::lock_guard<std::mutex> lock(tasksLock);
+    size_t count = taskCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; i++) {
+        tasks[i].stackFreeMin = uxTaskGetStackHighWaterMark(tasks[i].handle);
+    }
+}
+
+TelemetryData TelemetryService::getTelemetry(bool withSamples) {
+    TelemetryData data;
+    data.intervalMs = TELEMETRY_SAMPLE_INTERVAL_MS;
+    data.heapSize = ESP.getHeapSize();
+    data.current = measure();
+
+    {
+        std::lock_guard<std::mutex> lock(samplesLock);
+        data.sampleCount = sampleCount;
+        if (withSamples) {
+            data.samples.reserve(sampleCount);
+        }
+
+        size_t oldest = (sampleHead + TELEMETRY_SAMPLE_COUNT - sampleCount) % TELEMETRY_SAMPLE_COUNT;
+        data.windowMinFreeHeap = data.current.freeHeap;
+        data.windowMinLargestBlock = data.current.largestBlock;
+        data.windowMaxFragmentationPct = data.current.fragmentationPct();
+        for (size_t i = 0; i < sampleCount; i++) {
+            const TelemetrySample& s = samples[(oldest + i) % TELEMETRY_SAMPLE_COUNT];
+            if (s.freeHeap < data.windowMinFreeHeap) data.windowMinFreeHeap = s.freeHeap;
+            if (s.largestBlock < data.windowMinLargestBlock) data.windowMinLargestBlock = s.largestBlock;
+            if (s.fragmentationPct() > data.windowMaxFragmentationPct) data.windowMaxFragmentationPct = s.fragmentationPct();
+            if (withSamples) data.samples.push_back(s);
+        }
+
+        // Trend from the oldest sample to the newest
+        if (sampleCount >= 2) {
+            const TelemetrySample& first = samples[oldest];
+            const TelemetrySample& last = samples[(sampleHead + TELEMETRY_SAMPLE_COUNT - 1) % TELEMETRY_SAMPLE_COUNT];
+            uint32_t spanMs = last.timestampMs - first.timestampMs;
+            if (spanMs > 0) {
+                int64_t delta = (int64_t)last.freeHeap - (int64_t)first.freeHeap;
+                data.freeHeapTrend = (int32_t)(delta * 60000 / (int64_t)spanMs);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(tasksLock);
+        size_t count = taskCount.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; i++) {
+            // Refresh on read so a task that just peaked is reported
+            tasks[i].stackFreeMin = uxTaskGetStackHighWaterMark(tasks[i].handle);
+            TaskStackInfo info;
+            info.name = tasks[i].name;
+            info.stackFreeMin = tasks[i].stackFreeMin;
+            data.tasks.push_back(info);
+        }
+    }
+
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; i++) {
+        SubsystemAllocations a;
+        a.name = SUBSYSTEM_NAMES[i];
+        a.calls = allocations[i].calls.load(std::memory_order_relaxed);
+        a.netBytes = allocations[i].netBytes.load(std::memory_order_relaxed);
+        a.lastBytes = allocations[i].lastBytes.load(std::memory_order_relaxed);
+        a.maxBytes = allocations[i].maxBytes.load(std::memory_order_relaxed);
+        data.subsystems.push_back(a);
+    }
+
+    data.nameBytes = NamePool::getUsedBytes();
+    data.nameCapacity = NamePool::getCapacity();
+    data.nameCount = NamePool::getNameCount();
+    data.namesReused = NamePool::getReusedCount();
+
+    data.jsonArenaBytes = JsonPool::getArenaBytes();
+    data.jsonArenaPsram = JsonPool::inPsram();
+    data.jsonUsedBytes = JsonPool::getUsedBytes();
+    data.jsonPeakBytes = JsonPool::getPeakBytes();
+    data.jsonDocuments = JsonPool::getDocumentCount();
+    data.jsonPeakDocuments = JsonPool::getPeakDocuments();
+    data.jsonMaxDocuments = JsonPool::getMaxDocuments();
+    data.jsonFallbacks = JsonPool::getFallbackCount();
+    data.jsonRejected = JsonPool::getRejectedCount();
+
+    return data;
+}
@@ -0,0 +1,141 @@
+#ifndef TELEMETRY_SERVICE_H
+#define TELEMETRY_SERVICE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include "../config.h"
+#include "../models/TelemetryData.h"
+
+/**
+ * TelemetryService samples heap and task stack usage into a ring buffer
+ * - update() is called from loop() and samples every TELEMETRY_SAMPLE_INTERVAL_MS
+ * - Tasks are watched by handle; worker tasks register themselves with watchCurrentTask()
+ * - AllocationScope attributes heap growth around a call to a subsystem
+ */
+class TelemetryService {
+public:
+    // Subsystems that can be charged with heap growth
+    enum Subsystem : uint8_t {
+        CONFIG = 0,     // Loading and saving configuration
+        MAPPING,        // COM1 register map
+        POLLING,        // Queueing COM2 requests
+        SUBSYSTEM_COUNT
+    };
+
+    /**
+     * Charges the free-heap difference between construction and destruction to a subsystem
+     */
+    class AllocationScope {
+    public:
+        explicit AllocationScope(Subsystem subsystem)
+            : _subsystem(subsystem), _freeAtStart(ESP.getFreeHeap()) {}
+        ~AllocationScope() {
+            TelemetryService::recordAllocation(_subsystem, (int32_t)_freeAtStart - (int32_t)ESP.getFreeHeap());
+        }
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator=(const AllocationScope&) = delete;
+
+    private:
+        Subsystem _subsystem;
+        uint32_t _freeAtStart;
+    };
+
+    /**
+     * Initialize (call from setup(), watches the calling task and the web server task)
+     */
+    static void init() {
+        if (initialized) return;
+        watchTask("loopTask", xTaskGetCurrentTaskHandle());
+        TaskHandle_t asyncTcp = xTaskGetHandle("async_tcp");
+        if (asyncTcp) {
+            watchTask("async_tcp", asyncTcp);
+        }
+        initialized = true;
+        sample();
+    }
+
+    /**
+     * Take a sample when the interval has elapsed
+     */
+    static void update() {
+        if (!initialized) return;
+        if (millis() - lastSampleTime < TELEMETRY_SAMPLE_INTERVAL_MS) return;
+        sample();
+    }
+
+    /**
+     * Watch the stack of a task (ignored when already watched or the table is full)
+     */
+    static void watchTask(const char* name, TaskHandle_t handle);
+
+    /**
+     * Watch the calling task, cheap enough to call from every worker invocation
+     */
+    static void watchCurrentTask(const char* name) {
+        TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+        size_t count = taskCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            if (tasks[i].handle == handle) return;
+        }
+        watchTask(name, handle);
+    }
+
+    /**
+     * Add a heap delta (bytes retained, negative when released) to a subsystem
+     */
+    static void recordAllocation(Subsystem subsystem, int32_t bytes) {
+        if (subsystem >= SUBSYSTEM_COUNT) return;
+        Allocations& a = allocations[subsystem];
+        a.calls.fetch_add(1, std::memory_order_relaxed);
+        a.netBytes.fetch_add(bytes, std::memory_order_relaxed);
+        a.lastBytes.store(bytes, std::memory_order_relaxed);
+        if (bytes > 0) {
+            uint32_t current = a.maxBytes.load(std::memory_order_relaxed);
+            while ((uint32_t)bytes > current &&
+                   !a.maxBytes.compare_exchange_weak(current, (uint32_t)bytes, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    /**
+     * Current values, ring buffer aggregates and optionally the raw samples
+     */
+    static TelemetryData getTelemetry(bool withSamples);
+
+private:
+    struct WatchedTask {
+        const char* name;
+        TaskHandle_t handle;
+        uint32_t stackFreeMin;
+    };
+
+    struct Allocations {
+        std::atomic<uint32_t> calls;
+        std::atomic<int32_t> netBytes;
+        std::atomic<int32_t> lastBytes;
+        std::atomic<uint32_t> maxBytes;
+    };
+
+    static bool initialized;
+    static unsigned long lastSampleTime;
+
+    // Ring buffer of heap samples
+    static TelemetrySample samples[TELEMETRY_SAMPLE_COUNT];
+    static size_t sampleHead;                   // Next slot to write
+    static size_t sampleCount;
+    static std::mutex samplesLock;
+
+    // Watched tasks, appended only
+    static WatchedTask tasks[TELEMETRY_MAX_TASKS];
+    static std::atomic<size_t> taskCount;
+    static std::mutex tasksLock;
+
+    static Allocations allocations[SUBSYSTEM_COUNT];
+    static const char* const SUBSYSTEM_NAMES[SUBSYSTEM_COUNT];
+
+    static TelemetrySample measure();
+    static void sample();
+};
+
+#endif // TELEMETRY_SERVICE_H
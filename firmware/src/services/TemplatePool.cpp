@@ -0,0 +1,66 @@
+#include "TemplatePool.h"
+
+// Static member initialization
+alignas(8) uint8_t TemplatePool::blocks[MODBUS_MAX_TEMPLATES][BLOCK_SIZE];
+bool TemplatePool::used[MODBUS_MAX_TEMPLATES] = {};
+size_t TemplatePool::usedCount = 0;
+size_t TemplatePool::reservedCount = 0;
+size_t TemplatePool::peakCount = 0;
+uint32_t TemplatePool::rejectedCount = 0;
+std::mutex TemplatePool::lock;
+
+size_t TemplatePool::getUsed() {
+    std::lock_guard<std::mutex> guard(lock);
+    return usedCount;
+}
+
+size_t TemplatePool::getPeak() {
+    std::lock_guard<std::mutex> guard(lock);
+    return peakCount;
+}
+
+uint32_t TemplatePool::getRejectedCount() {
+    std::lock_guard<std::mutex> guard(lock);
+    return rejectedCount;
+}
+
+// The allocator cannot fail (allocate_shared has no null path), so create() takes the
+// block count first and allocate() is then guaranteed a free block
+bool TemplatePool::reserve() {
+    std::lock_guard<std::mutex> guard(lock);
+    if (usedCount + reservedCount >= MODBUS_MAX_TEMPLATES) {
+        if (rejectedCount++ == 0) {
+            Serial.printf("[TemplatePool] All %u template blocks in use, rejecting the change\n",
+                          (unsigned)MODBUS_MAX_TEMPLATES);
+        }
+        return false;
+    }
+    reservedCount++;
+    return true;
+}
+
+void* TemplatePool::allocate(size_t bytes) {
+    if (bytes > BLOCK_SIZE) {
+        // BLOCK_SIZE leaves room for the control block of the toolchains we build with
+        Serial.printf("[TemplatePool] Error: %u byte template does not fit a block\n", (unsigned)bytes);
+        abort();
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    reservedCount--;
+    for (size_t i = 0; i < MODBUS_MAX_TEMPLATES; i++) {
+        if (used[i]) continue;
+        used[i] = true;
+        usedCount++;
+        if (usedCount > peakCount) peakCount = usedCount;
+        return blocks[i];
+    }
+    return nullptr;  // Not reached, reserve() counted a free block
+}
+
+void TemplatePool::deallocate(void* p) {
+    uint8_t* block = static_cast<uint8_t*>(p);
+    std::lock_guard<std::mutex> guard(lock);
+    used[(block - blocks[0]) / BLOCK_SIZE] = false;
+    usedCount--;
+}
@@ -0,0 +1,67 @@
+#ifndef TEMPLATE_POOL_H
+#define TEMPLATE_POOL_H
+
+#include <Arduino.h>
+#include <memory>
+#include <mutex>
+#include "../config.h"
+#include "../models/RegisterTemplate.h"
+
+/**
+ * TemplatePool holds the register templates in MODBUS_MAX_TEMPLATES static blocks
+ * - create() returns a shared template whose control block and object live in one block
+ * - Blocks are reused as templates are released, nothing is allocated at runtime
+ * - When every block is taken (many slaves edited apart at once) create() returns null
+ *   and the edit is rejected like any other limit; refusals are counted and reported
+ *   by /api/capacity
+ */
+class TemplatePool {
+public:
+    // A new template, null when every block is in use
+    template <typename... Args>
+    static RegisterTemplatePtr create(Args&&... args) {
+        if (!reserve()) return nullptr;
+        return std::allocate_shared<RegisterTemplate>(Allocator<RegisterTemplate>(), std::forward<Args>(args)...);
+    }
+
+    static size_t getCapacity() { return MODBUS_MAX_TEMPLATES; }
+    static size_t getUsed();
+    static size_t getPeak();
+    static uint32_t getRejectedCount();
+    static size_t getStaticBytes() { return sizeof(blocks); }
+
+private:
+    // Control block and template, with room for the control block of any toolchain
+    static constexpr size_t BLOCK_SIZE = (sizeof(RegisterTemplate) + 48 + 7) & ~(size_t)7;
+
+    alignas(8) static uint8_t blocks[MODBUS_MAX_TEMPLATES][BLOCK_SIZE];
+    static bool used[MODBUS_MAX_TEMPLATES];
+    static size_t usedCount;
+    static size_t reservedCount;    // Blocks promised to create() calls about to allocate
+    static size_t peakCount;
+    static uint32_t rejectedCount;
+    static std::mutex lock;
+
+    static bool reserve();
+    static void* allocate(size_t bytes);
+    static void deallocate(void* p);
+
+    template <typename T>
+    struct Allocator {
+        using value_type = T;
+
+        Allocator() = default;
+        template <typename U>
+        Allocator(const Allocator<U>&) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(TemplatePool::allocate(n * sizeof(T))); }
+        void deallocate(T* p, size_t) { TemplatePool::deallocate(p); }
+
+        template <typename U>
+        bool operator==(const Allocator<U>&) const { return true; }
+        template <typename U>
+        bool operator!=(const Allocator<U>&) const { return false; }
+    };
+};
+
+#endif // TEMPLATE_POOL_H
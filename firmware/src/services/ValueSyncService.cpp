@@ -0,0 +1,8 @@
+#include "ValueSyncService.h"
+
+// Static member initialization
+uint32_t ValueSyncService::slotVersions[MODBUS_MAX_SLOTS];
+size_t ValueSyncService::slotCount = 0;
+uint32_t ValueSyncService::version = 0;
+uint32_t ValueSyncService::layoutGeneration = esp_random();  // Clients' layouts from before a reboot never match
+std::mutex ValueSyncService::lock;
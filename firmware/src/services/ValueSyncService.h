@@ -0,0 +1,82 @@
+#ifndef VALUE_SYNC_SERVICE_H
+#define VALUE_SYNC_SERVICE_H
+
+#include <Arduino.h>
+#include <mutex>
+#include "../config.h"
+
+/**
+ * ValueSyncService versions register values so clients can fetch only what changed
+ * - Every register has a slot: its position in COM1 address order over all groups
+ *   (groups in configuration order, group registers first, then each slave's registers)
+ * - A global version is bumped on every value change and stored for the changed slot
+ * - The layout generation changes whenever slots are reassigned (configuration change),
+ *   starting from a random value at boot as versions start over
+ * - Slot versions are a static table of MODBUS_MAX_SLOTS entries, nothing is allocated
+ */
+class ValueSyncService {
+public:
+    /**
+     * Reset after the register mapping was rebuilt, every slot counts as changed
+     */
+    static void resetLayout(size_t count) {
+        std::lock_guard<std::mutex> guard(lock);
+        layoutGeneration++;
+        version++;
+        slotCount = count < MODBUS_MAX_SLOTS ? count : MODBUS_MAX_SLOTS;
+        for (size_t slot = 0; slot < slotCount; slot++) {
+            slotVersions[slot] = version;
+        }
+    }
+    
+    /**
+     * Record a value change of a slot
+     */
+    static void markChanged(uint16_t slot) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (slot >= slotCount) return;
+        version++;
+        slotVersions[slot] = version;
+    }
+    
+    static uint32_t getVersion() {
+        std::lock_guard<std::mutex> guard(lock);
+        return version;
+    }
+    
+    /**
+     * Bytes of the static table (see /api/capacity)
+     */
+    static constexpr size_t getStaticBytes() {
+        return sizeof(slotVersions);
+    }
+    
+    static uint32_t getLayoutGeneration() {
+        std::lock_guard<std::mutex> guard(lock);
+        return layoutGeneration;
+    }
+    
+    /**
+     * Call fn(slot) for every slot changed after since, in slot order
+     * Returns the version the result is consistent with
+     */
+    template <typename F>
+    static uint32_t forEachChangedSince(uint32_t since, F fn) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t slot = 0; slot < slotCount; slot++) {
+            if (slotVersions[slot] > since) {
+                fn((uint16_t)slot);
+            }
+        }
+        return version;
+    }
+    
+private:
+    static uint32_t slotVersions[MODBUS_MAX_SLOTS];  // Version of the last change per slot
+    static size_t slotCount;
+    static uint32_t version;
+    static uint32_t layoutGeneration;
+    static std::mutex lock;
+};
+
+#endif // VALUE_SYNC_SERVICE_H
@@ -0,0 +1,200 @@
+#include "WarmStartService.h"
+#include "ConfigCodec.h"
+#include "ModbusService.h"
+#include "PreferencesService.h"
+#include "RegisterMappingService.h"
+#include "TelemetryService.h"
+#include "ValueSyncService.h"
+#include <stddef.h>
+
+#ifndef RTC_NOINIT_ATTR
+#define RTC_NOINIT_ATTR     // Host builds have no RTC memory
+#endif
+
+// Static member initialization
+RTC_NOINIT_ATTR uint32_t WarmStartService::rtcSnapshot[(RTC_SNAPSHOT_BYTES + 3) / 4];
+std::vector<bool> WarmStartService::staleSlots;
+std::atomic<size_t> WarmStartService::staleCount(0);
+std::mutex WarmStartService::staleLock;
+std::atomic<bool> WarmStartService::rtcRequested(false);
+uint32_t WarmStartService::counter = 0;
+uint32_t WarmStartService::layoutHash = 0;
+uint32_t WarmStartService::layoutGeneration = 0;
+uint32_t WarmStartService::rtcVersion = 0;
+uint32_t WarmStartService::flashVersion = 0;
+unsigned long WarmStartService::lastRtcMs = 0;
+unsigned long WarmStartService::lastFlashMs = 0;
+uint8_t WarmStartService::nextFile = 0;
+
+void WarmStartService::restore() {
+    uint32_t startUs = micros();
+    size_t slotCount = RegisterMappingService::getSlotCount();
+    uint32_t hash = currentLayoutHash();
+
+    // Candidates: RTC memory, then both flash files; the newest matching one wins
+    const uint8_t* best = nullptr;
+    uint32_t bestCounter = 0;
+    const char* bestSource = nullptr;
+    Header header;
+
+    const uint8_t* rtc = (const uint8_t*)rtcSnapshot;
+    if (validate(rtc, RTC_SNAPSHOT_BYTES, header)) {
+        counter = header.counter;
+        if (header.layoutHash == hash && header.slotCount == slotCount) {
+            best = rtc;
+            bestCounter = header.counter;
+            bestSource = "RTC memory";
+        }
+    }
+
+    std::vector<uint8_t> files[2];
+    uint32_t fileCounter[2] = {0, 0};
+    for (uint8_t i = 0; i < 2; i++) {
+        PreferencesService::loadValueSnapshot(i, files[i]);
+        if (!validate(files[i].data(), files[i].size(), header)) continue;
+
+        fileCounter[i] = header.counter;
+        if (header.counter > counter) counter = header.counter;
+        if (header.layoutHash == hash && header.slotCount == slotCount &&
+            (!best || header.counter > bestCounter)) {
+            best = files[i].data();
+            bestCounter = header.counter;
+            bestSource = "flash";
+        }
+    }
+
+    // Overwrite the older file first
+    nextFile = fileCounter[0] <= fileCounter[1] ? 0 : 1;
+
+    if (best) {
+        const uint8_t* values = best + sizeof(Header);
+        for (size_t slot = 0; slot < slotCount; slot++) {
+            uint16_t value;
+            memcpy(&value, values + slot * 2, 2);
+            RegisterMappingService::writeSlot(slot, value);
+        }
+
+        std::lock_guard<std::mutex> lock(staleLock);
+        staleSlots.assign(slotCount, true);
+        staleCount = slotCount;
+    }
+
+    // Nothing changed yet, no need to write the restored values back
+    rtcVersion = flashVersion = ValueSyncService::getVersion();
+    lastRtcMs = lastFlashMs = millis();
+
+    if (best) {
+        Serial.printf("[WarmStart] Restored %u values from %s (snapshot %u) in %u us\n",
+                      (unsigned)slotCount, bestSource, (unsigned)bestCounter, (unsigned)(micros() - startUs));
+    } else {
+        Serial.println("[WarmStart] No snapshot for this register layout, starting with zeros");
+    }
+}
+
+void WarmStartService::update() {
+    unsigned long now = millis();
+
+    if (rtcRequested.exchange(false)) {
+        lastRtcMs = now;
+        saveToRtc();
+    } else if (now - lastRtcMs >= WARM_START_RTC_INTERVAL_MS) {
+        lastRtcMs = now;
+        if (ValueSyncService::getVersion() != rtcVersion) {
+            saveToRtc();
+        }
+    }
+
+    if (now - lastFlashMs >= WARM_START_FLASH_INTERVAL_MS) {
+        lastFlashMs = now;
+        if (ValueSyncService::getVersion() != flashVersion) {
+            saveToFlash();
+        }
+    }
+}
+
+void WarmStartService::saveToRtc() {
+    uint32_t version = ValueSyncService::getVersion();
+    if (build((uint8_t*)rtcSnapshot, RTC_SNAPSHOT_BYTES) > 0) {
+        rtcVersion = version;
+    }
+}
+
+void WarmStartService::resetLayout() {
+    std::lock_guard<std::mutex> lock(staleLock);
+    staleSlots.clear();
+    staleCount = 0;
+}
+
+void WarmStartService::saveToFlash() {
+    TelemetryService::AllocationScope scope(TelemetryService::CONFIG);
+    uint32_t version = ValueSyncService::getVersion();
+
+    std::vector<uint8_t> data(sizeof(Header) + RegisterMappingService::getSlotCount() * 2);
+    size_t size = build(data.data(), data.size());
+    if (size == 0) return;
+
+    if (PreferencesService::saveValueSnapshot(nextFile, data.data(), size)) {
+        flashVersion = version;
+        nextFile ^= 1;
+    }
+}
+
+uint32_t WarmStartService::currentLayoutHash() {
+    uint32_t generation = ValueSyncService::getLayoutGeneration();
+    if (generation == layoutGeneration && layoutHash != 0) return layoutHash;
+
+    // Identify every slot by group, slave and register ID, in slot order
+    uint32_t hash = 0;
+    ModbusService::ReadGuard config;
+    for (const auto& group : config.groups()) {
+        for (const auto& reg : group.registers) {
+            uint32_t token = ((uint32_t)group.id << 24) | reg.id;
+            hash = ConfigCodec::crc32((const uint8_t*)&token, sizeof(token), hash);
+        }
+        for (const auto& slave : group.slaves) {
+            for (size_t i = 0; i < slave.registerCount(); i++) {
+                uint32_t token = ((uint32_t)group.id << 24) | ((uint32_t)slave.id << 16) | slave.getDefinition(i).id;
+                hash = ConfigCodec::crc32((const uint8_t*)&token, sizeof(token), hash);
+            }
+        }
+    }
+
+    layoutGeneration = generation;
+    layoutHash = hash;
+    return hash;
+}
+
+size_t WarmStartService::build(uint8_t* out, size_t capacity) {
+    size_t slotCount = RegisterMappingService::getSlotCount();
+    size_t size = sizeof(Header) + slotCount * 2;
+    if (slotCount > UINT16_MAX || size > capacity) return 0;
+
+    uint8_t* values = out + sizeof(Header);
+    for (size_t slot = 0; slot < slotCount; slot++) {
+        uint16_t value = 0;
+        RegisterMappingService::readSlot(slot, value);
+        memcpy(values + slot * 2, &value, 2);
+    }
+
+    Header header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.slotCount = slotCount;
+    header.layoutHash = currentLayoutHash();
+    header.counter = ++counter;
+    header.crc = ConfigCodec::crc32((const uint8_t*)&header, offsetof(Header, crc));
+    header.crc = ConfigCodec::crc32(values, slotCount * 2, header.crc);
+    memcpy(out, &header, sizeof(header));
+    return size;
+}
+
+bool WarmStartService::validate(const uint8_t* data, size_t size, Header& header) {
+    if (size < sizeof(Header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION) return false;
+    if (size < sizeof(Header) + header.slotCount * 2) return false;
+
+    uint32_t crc = ConfigCodec::crc32((const uint8_t*)&header, offsetof(Header, crc));
+    crc = ConfigCodec::crc32(data + sizeof(Header), header.slotCount * 2, crc);
+    return crc == header.crc;
+}
@@ -0,0 +1,115 @@
+#ifndef WARM_START_SERVICE_H
+#define WARM_START_SERVICE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "../config.h"
+
+/**
+ * WarmStartService keeps the last known register values across reboots
+ * - Snapshots of all values in slot order are copied to RTC memory every second
+ *   (survives ESP.restart, watchdog and panic resets) and written to SPIFFS every
+ *   15 minutes (survives power loss), both only when a value changed
+ * - The SPIFFS snapshot alternates between two files, so one stays valid while
+ *   the other is written and writes are spread over both
+ * - A snapshot is only restored into the same register layout (checked by hash)
+ * - Restored values are stale until COM2 delivers a fresh value for the register
+ */
+class WarmStartService {
+public:
+    /**
+     * Restore the newest matching snapshot, call after the register mapping is built
+     */
+    static void restore();
+
+    /**
+     * Take snapshots when due, call from loop()
+     */
+    static void update();
+
+    /**
+     * Copy the current values to RTC memory now (before a planned restart, loop task only)
+     */
+    static void saveToRtc();
+
+    /**
+     * Ask the loop task for an RTC snapshot on its next update(), callable from any task
+     * (timer callbacks and web handlers must not walk the configuration themselves)
+     */
+    static void requestSnapshot() {
+        rtcRequested = true;
+    }
+
+    /**
+     * Register slots were reassigned, restored values can no longer be told apart
+     */
+    static void resetLayout();
+
+    /**
+     * A value was received from COM2 for the slot
+     */
+    static void markFresh(uint16_t slot) {
+        if (staleCount.load(std::memory_order_relaxed) == 0) return;
+
+        std::lock_guard<std::mutex> lock(staleLock);
+        if (slot < staleSlots.size() && staleSlots[slot]) {
+            staleSlots[slot] = false;
+            staleCount--;
+        }
+    }
+
+    /**
+     * True while the slot holds a restored value that was not refreshed yet
+     */
+    static bool isStale(uint16_t slot) {
+        if (staleCount.load(std::memory_order_relaxed) == 0) return false;
+
+        std::lock_guard<std::mutex> lock(staleLock);
+        return slot < staleSlots.size() && staleSlots[slot];
+    }
+
+    static size_t getStaleCount() {
+        return staleCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x53575648;   // "HVWS"
+    static constexpr uint16_t VERSION = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t slotCount;
+        uint32_t layoutHash;
+        uint32_t counter;       // Increases with every snapshot, the newest one wins
+        uint32_t crc;           // Over the fields above and the values
+    };
+
+    static constexpr size_t RTC_SNAPSHOT_BYTES = sizeof(Header) + WARM_START_RTC_MAX_SLOTS * 2;
+
+    // In RTC memory: kept over soft resets, random after power-on (rejected by the checksum)
+    static uint32_t rtcSnapshot[(RTC_SNAPSHOT_BYTES + 3) / 4];
+
+    static std::vector<bool> staleSlots;
+    static std::atomic<size_t> staleCount;
+    static std::mutex staleLock;
+
+    static std::atomic<bool> rtcRequested;
+    static uint32_t counter;
+    static uint32_t layoutHash;
+    static uint32_t layoutGeneration;
+    static uint32_t rtcVersion;             // ValueSyncService version of the last RTC snapshot
+    static uint32_t flashVersion;           // ... and of the last flash snapshot
+    static unsigned long lastRtcMs;
+    static unsigned long lastFlashMs;
+    static uint8_t nextFile;
+
+    static uint32_t currentLayoutHash();
+    static size_t build(uint8_t* out, size_t capacity);
+    static bool validate(const uint8_t* data, size_t size, Header& header);
+    static void saveToFlash();
+};
+
+#endif // WARM_START_SERVICE_H
@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "services/WarmStartService.h"
 
 namespace utils {
 
@@ -83,11 +84,17 @@ namespace utils {
                 delete reasonPtr; // Clean up allocated memory
             }
             
+            // The snapshot was taken by the loop task (requested below), the timer task
+            // has a small stack and must not walk the configuration
             Serial.println("Restarting ESP32...");
             ESP.restart();
             }
         );
         
+        // RTC memory survives the restart, keep the latest values for the warm start
+        // (the loop task takes it within milliseconds and keeps refreshing it every second)
+        WarmStartService::requestSnapshot();
+        
         if (restartTimer != NULL) {
             // Store reason in timer ID if provided
             if (reason.length() > 0) {
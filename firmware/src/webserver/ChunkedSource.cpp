@@ -0,0 +1,96 @@
+#include "ChunkedSource.h"
+#include <stdarg.h>
+
+void ChunkedSource::send(AsyncWebServerRequest* request, const char* contentType,
+                         std::shared_ptr<ChunkedSource> source) {
+    AsyncWebServerResponse* response = beginResponse(request, contentType, source);
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+AsyncWebServerResponse* ChunkedSource::beginResponse(AsyncWebServerRequest* request, const char* contentType,
+                                                     std::shared_ptr<ChunkedSource> source) {
+    return request->beginChunkedResponse(contentType,
+        [source](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return source->fill(buffer, maxLen);
+        });
+}
+
+size_t ChunkedSource::fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (_offset >= _pending.length()) {
+            if (_done) break;
+            // Assigning keeps the buffer capacity for the next step
+            _pending = "";
+            _offset = 0;
+            if (!step()) {
+                _done = true;
+            }
+            continue;
+        }
+
+        size_t n = _pending.length() - _offset;
+        if (n > maxLen - written) {
+            n = maxLen - written;
+        }
+        memcpy(buffer + written, _pending.c_str() + _offset, n);
+        _offset += n;
+        written += n;
+    }
+    return written;
+}
+
+void ChunkedSource::write(const char* text) {
+    _pending += text;
+}
+
+void ChunkedSource::write(const String& text) {
+    _pending += text;
+}
+
+void ChunkedSource::writeJsonString(const char* text) {
+    _pending += '"';
+    for (const char* p = text; *p; p++) {
+        char c = *p;
+        switch (c) {
+            case '"':  _pending += "\\\""; break;
+            case '\\': _pending += "\\\\"; break;
+            case '\n': _pending += "\\n"; break;
+            case '\r': _pending += "\\r"; break;
+            case '\t': _pending += "\\t"; break;
+            default:
+                if ((uint8_t)c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)(uint8_t)c);
+                    _pending += escaped;
+                } else {
+                    _pending += c;
+                }
+        }
+    }
+    _pending += '"';
+}
+
+void ChunkedSource::writef(const char* format, ...) {
+    char line[160];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (len < 0) return;
+
+    if ((size_t)len < sizeof(line)) {
+        _pending.concat(line, len);
+        return;
+    }
+
+    // Longer than the line buffer: format again straight into a heap buffer
+    char* longLine = (char*)malloc(len + 1);
+    if (!longLine) return;
+    va_start(args, format);
+    vsnprintf(longLine, len + 1, format, args);
+    va_end(args);
+    _pending.concat(longLine, len);
+    free(longLine);
+}
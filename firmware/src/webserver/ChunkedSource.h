@@ -0,0 +1,59 @@
+#ifndef CHUNKEDSOURCE_H
+#define CHUNKEDSOURCE_H
+
+#include <ESPAsyncWebServer.h>
+#include <memory>
+
+/**
+ * ChunkedSource produces a response body incrementally for a chunked response
+ *
+ * Subclasses emit the body one small step at a time (a line, a record) through
+ * write()/writef(). The output of a step is staged in a reusable buffer and copied
+ * into the TCP chunks as the server asks for them, a step that does not fit is
+ * carried over into the next chunk. Memory use is bounded by the largest single
+ * step instead of the whole body.
+ */
+class ChunkedSource {
+public:
+    virtual ~ChunkedSource() {}
+
+    /**
+     * Send the source as a chunked response (the response owns the source)
+     */
+    static void send(AsyncWebServerRequest* request, const char* contentType,
+                     std::shared_ptr<ChunkedSource> source);
+
+    /**
+     * Create the chunked response without sending it, for callers that add their own headers
+     */
+    static AsyncWebServerResponse* beginResponse(AsyncWebServerRequest* request, const char* contentType,
+                                                 std::shared_ptr<ChunkedSource> source);
+
+    /**
+     * Copy the next part of the body into buffer, returns 0 once the body is complete
+     */
+    size_t fill(uint8_t* buffer, size_t maxLen);
+
+protected:
+    ChunkedSource() : _offset(0), _done(false) {
+        _pending.reserve(256);
+    }
+
+    /**
+     * Emit the next step of the body, return false when there is nothing left
+     */
+    virtual bool step() = 0;
+
+    void write(const char* text);
+    void write(const String& text);
+    void writef(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    void writeJsonString(const char* text);     // Quoted and escaped
+    void writeJsonString(const String& text) { writeJsonString(text.c_str()); }
+
+private:
+    String _pending;    // Output of the current step
+    size_t _offset;     // Bytes of _pending already handed to the server
+    bool _done;
+};
+
+#endif
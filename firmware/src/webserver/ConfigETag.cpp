@@ -0,0 +1,27 @@
+#include "ConfigETag.h"
+#include "../services/ModbusService.h"
+
+String ConfigETag::current() {
+    char tag[16];
+    snprintf(tag, sizeof(tag), "\"%08x\"", (unsigned)ModbusService::getGeneration());
+    return String(tag);
+}
+
+bool ConfigETag::sendNotModified(AsyncWebServerRequest* request) {
+    if (!request->hasHeader("If-None-Match")) return false;
+
+    // If-None-Match may list several tags or use the weak form, a substring match covers both
+    String etag = current();
+    if (request->header("If-None-Match").indexOf(etag.c_str()) < 0) return false;
+
+    AsyncWebServerResponse* response = request->beginResponse(304);
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+    return true;
+}
+
+void ConfigETag::addHeaders(AsyncWebServerResponse* response) {
+    response->addHeader("ETag", current());
+    response->addHeader("Cache-Control", "no-cache");
+}
@@ -0,0 +1,31 @@
+#ifndef CONFIGETAG_H
+#define CONFIGETAG_H
+
+#include <ESPAsyncWebServer.h>
+
+/**
+ * ConfigETag makes responses that only depend on the Modbus configuration cacheable
+ *
+ * The configuration generation is the ETag: a matching If-None-Match gets 304
+ * without touching the configuration, anything else is streamed fresh.
+ */
+class ConfigETag {
+public:
+    /**
+     * Answer with 304 if the client already has the current generation
+     * Returns true when the request has been answered
+     */
+    static bool sendNotModified(AsyncWebServerRequest* request);
+
+    /**
+     * Add the ETag and revalidation headers to a full response
+     */
+    static void addHeaders(AsyncWebServerResponse* response);
+
+    /**
+     * ETag of the current configuration generation
+     */
+    static String current();
+};
+
+#endif
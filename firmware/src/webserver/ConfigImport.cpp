@@ -0,0 +1,67 @@
+#include "ConfigImport.h"
+#include "../services/ModbusService.h"
+#include "JsonResponse.h"
+#include <new>
+
+// Static member initialization
+ConfigStreamParser* ConfigImport::parser = nullptr;
+AsyncWebServerRequest* ConfigImport::owner = nullptr;
+
+void ConfigImport::collect(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    if (index == 0) {
+        if (owner) return;  // Another import is in progress, answered with 409
+
+        GroupList* groups = ModbusService::acquireStaging();
+        if (!groups) return;
+        parser = new (std::nothrow) ConfigStreamParser(*groups);
+        if (!parser) {
+            Serial.println("[ConfigImport] Could not allocate parser");
+            ModbusService::releaseStaging();
+            return;
+        }
+        owner = request;
+        request->onDisconnect([request]() {
+            if (owner == request) release();
+        });
+    }
+
+    if (owner != request) return;
+    parser->feed((const char*)data, len);
+}
+
+GroupList* ConfigImport::take(AsyncWebServerRequest* request) {
+    if (owner != request) {
+        if (owner) {
+            sendError(request, 409, "Another import is in progress");
+        } else if (request->contentLength() > 0) {
+            sendError(request, 500, "Out of memory");
+        } else {
+            sendError(request, 400, "Request body is required");
+        }
+        return nullptr;
+    }
+
+    if (!parser->finish()) {
+        sendError(request, 400, parser->getError());
+        release();
+        return nullptr;
+    }
+
+    return &parser->getGroups();
+}
+
+void ConfigImport::release() {
+    if (!owner) return;
+    delete parser;
+    parser = nullptr;
+    owner = nullptr;
+    ModbusService::releaseStaging();
+}
+
+void ConfigImport::sendError(AsyncWebServerRequest* request, int code, const char* message) {
+    JsonResponse* response = new JsonResponse();
+    response->setCode(code);
+    response->getRoot()["error"] = message;
+    response->setLength();
+    request->send(response);
+}
@@ -0,0 +1,42 @@
+#ifndef CONFIG_IMPORT_H
+#define CONFIG_IMPORT_H
+
+#include <ESPAsyncWebServer.h>
+#include "../models/Group.h"
+#include "../services/ConfigStreamParser.h"
+
+/**
+ * ConfigImport parses an uploaded configuration while its body is still arriving
+ *
+ * Unlike RequestBody the body is never buffered as a whole: each chunk goes straight
+ * into a ConfigStreamParser, so the size of an import is not limited by a body buffer
+ * or a JSON document. Groups are built in ModbusService's staging list, so one
+ * import runs at a time; the parser and the list are released when the request is
+ * answered or the client disconnects.
+ */
+class ConfigImport {
+public:
+    /**
+     * Body handler for server.on(), parses one chunk of the body
+     */
+    static void collect(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+
+    /**
+     * The parsed groups of a complete body (the staging list), call release() when done
+     * Answers the request with 400/409/500 and returns nullptr if there are none
+     */
+    static GroupList* take(AsyncWebServerRequest* request);
+
+    /**
+     * Drop the parser and return the staging list
+     */
+    static void release();
+
+private:
+    static ConfigStreamParser* parser;
+    static AsyncWebServerRequest* owner;
+
+    static void sendError(AsyncWebServerRequest* request, int code, const char* message);
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "GroupsSource.h"
+#include "../services/ModbusService.h"
+#include "../services/WarmStartService.h"
+
+GroupsSource::GroupsSource(bool withValues)
+    : _single(false), _withValues(withValues), _firstGroup(0), _endGroup(SIZE_MAX),
+      _state(GROUP_OPEN), _group(0), _slave(0), _reg(0) {}
+
+GroupsSource::GroupsSource(size_t groupIndex, bool withValues)
+    : _single(true), _withValues(withValues), _firstGroup(groupIndex), _endGroup(groupIndex + 1),
+      _state(GROUP_OPEN), _group(groupIndex), _slave(0), _reg(0) {}
+
+bool GroupsSource::step() {
+    ModbusService::ReadGuard config;
+    const auto& groups = config.groups();
+    const Group* group = (_group < groups.size() && _group < _endGroup) ? &groups[_group] : nullptr;
+
+    switch (_state) {
+        case GROUP_OPEN:
+            if (!group) {
+                if (_single) {
+                    // Only reachable if the group disappeared before the first chunk
+                    if (_group == _firstGroup) write("null");
+                } else {
+                    write(_group == _firstGroup ? "[]" : "]");
+                }
+                _state = FINISHED;
+                return true;
+            }
+            if (!_single) write(_group == _firstGroup ? "[" : ",");
+            writef("{\"id\":%u,\"remote_address\":%u,\"name\":", group->id, group->remoteAddress);
+            writeJsonString(group->name.c_str());
+            write(",\"registers\":[");
+            _reg = 0;
+            _state = GROUP_REGISTER;
+            return true;
+
+        case GROUP_REGISTER:
+            if (group && _reg < group->registers.size()) {
+                const Register& reg = group->registers[_reg];
+                writeRegister(reg, reg.value, reg.slot, _reg == 0);
+                _reg++;
+                return true;
+            }
+            write("],\"slaves\":[");
+            _slave = 0;
+            _state = SLAVE_OPEN;
+            return true;
+
+        case SLAVE_OPEN:
+            if (group && _slave < group->slaves.size()) {
+                const Slave& slave = group->slaves[_slave];
+                writef("%s{\"id\":%u,\"template\":", _slave == 0 ? "" : ",", slave.id);
+                writeJsonString(slave.registerTemplate->name.c_str());
+                write(",\"registers\":[");
+                _reg = 0;
+                _state = SLAVE_REGISTER;
+                return true;
+            }
+            write("]}");
+            _group++;
+            _state = GROUP_OPEN;
+            return true;
+
+        case SLAVE_REGISTER: {
+            const Slave* slave = (group && _slave < group->slaves.size()) ? &group->slaves[_slave] : nullptr;
+            if (slave && _reg < slave->registerCount()) {
+                writeRegister(slave->getDefinition(_reg), slave->values[_reg], slave->slotOf(_reg), _reg == 0);
+                _reg++;
+                return true;
+            }
+            write("]}");
+            _slave++;
+            _state = SLAVE_OPEN;
+            return true;
+        }
+
+        case FINISHED:
+        default:
+            return false;
+    }
+}
+
+void GroupsSource::writeRegister(const Register& definition, uint16_t value, uint16_t slot, bool first) {
+    writef("%s{\"id\":%u,\"name\":", first ? "" : ",", definition.id);
+    writeJsonString(definition.name.c_str());
+    if (_withValues) {
+        writef(WarmStartService::isStale(slot) ? ",\"value\":%u,\"stale\":true}" : ",\"value\":%u}", value);
+    } else {
+        write("}");
+    }
+}
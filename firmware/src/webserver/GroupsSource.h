@@ -0,0 +1,46 @@
+#ifndef GROUPSSOURCE_H
+#define GROUPSSOURCE_H
+
+#include "ChunkedSource.h"
+#include "../models/Group.h"
+
+/**
+ * GroupsSource streams Modbus groups as JSON, one register per step
+ *
+ * Output matches Group::toJson: either the array of all groups or a single
+ * group object. Groups, slaves and registers are addressed by index and looked
+ * up again on every step, so a configuration change between chunks shortens
+ * the output instead of touching freed memory.
+ */
+class GroupsSource : public ChunkedSource {
+public:
+    /**
+     * All groups as an array
+     */
+    explicit GroupsSource(bool withValues);
+
+    /**
+     * A single group object (groupIndex into the published configuration)
+     */
+    GroupsSource(size_t groupIndex, bool withValues);
+
+protected:
+    bool step() override;
+
+private:
+    enum State { GROUP_OPEN, GROUP_REGISTER, SLAVE_OPEN, SLAVE_REGISTER, FINISHED };
+
+    bool _single;
+    bool _withValues;
+    size_t _firstGroup;
+    size_t _endGroup;       // One past the last group to write
+
+    State _state;
+    size_t _group;
+    size_t _slave;
+    size_t _reg;
+
+    void writeRegister(const Register& definition, uint16_t value, uint16_t slot, bool first);
+};
+
+#endif
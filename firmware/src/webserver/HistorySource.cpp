@@ -0,0 +1,123 @@
+#include "HistorySource.h"
+#include "../services/HistoryService.h"
+
+HistorySource::HistorySource(uint32_t token, size_t slot, uint32_t epoch, uint32_t fromS, uint8_t tiers)
+    : _token(token), _slot(slot), _epoch(epoch), _fromS(fromS), _tiers(tiers),
+      _section(HEADER), _first(true), _seq(0), _blockLoaded(false), _cursor(_block) {
+}
+
+void HistorySource::openArray(const char* name) {
+    writef(",\"%s\":[", name);
+    _first = true;
+    _seq = 0;
+    _blockLoaded = false;
+}
+
+void HistorySource::nextSection() {
+    if (_section == RAW || _section == MINUTE || _section == HOUR || _section == DAY) {
+        write("]");
+    }
+    _section = (Section)(_section + 1);
+    // Skip tiers that were not requested
+    while ((_section == RAW && !(_tiers & TIER_RAW)) ||
+           (_section == MINUTE && !(_tiers & TIER_MINUTE)) ||
+           (_section == HOUR && !(_tiers & TIER_HOUR)) ||
+           (_section == DAY && !(_tiers & TIER_DAY))) {
+        _section = (Section)(_section + 1);
+    }
+    if (_section == RAW) openArray("raw");
+    if (_section == MINUTE) openArray("minute");
+    if (_section == HOUR) openArray("hour");
+    if (_section == DAY) openArray("day");
+}
+
+bool HistorySource::step() {
+    switch (_section) {
+        case HEADER:
+            writef("{\"group\":%u,\"slave\":%u,\"reg\":%u,\"now\":%u,\"from\":%u",
+                   (unsigned)((_token >> 24) & 0xFF), (unsigned)((_token >> 16) & 0xFF),
+                   (unsigned)(_token & 0xFFFF), (unsigned)(millis() / 1000), (unsigned)_fromS);
+            nextSection();
+            return true;
+        case RAW:
+            if (!writeRaw()) nextSection();
+            return true;
+        case MINUTE:
+        case HOUR:
+        case DAY:
+            if (!writeRollups(_section)) nextSection();
+            return true;
+        case FOOTER:
+            write("}");
+            _section = FINISHED;
+            return true;
+        case FINISHED:
+            break;
+    }
+    return false;
+}
+
+bool HistorySource::writeRaw() {
+    if (!_blockLoaded) {
+        // Copy the next block still held; blocks overwritten meanwhile are skipped
+        bool found = false;
+        bool valid = HistoryService::readSeries(_slot, _epoch, [this, &found](const HistorySeries& s) {
+            if (s.blocks[s.rawSeq % HISTORY_RAW_BLOCKS].count == 0) return;
+            if (_seq < s.oldestRawSeq()) _seq = s.oldestRawSeq();
+            if (_seq > s.rawSeq) return;
+            _block = s.blocks[_seq % HISTORY_RAW_BLOCKS];
+            found = true;
+        });
+        if (!valid || !found) return false;
+        _cursor = HistoryBlock::Cursor(_block);
+        _blockLoaded = true;
+        _seq++;
+    }
+
+    uint32_t timeMs;
+    uint16_t value;
+    for (size_t i = 0; i < SAMPLES_PER_STEP; i++) {
+        if (!_cursor.next(timeMs, value)) {
+            _blockLoaded = false;
+            return true;
+        }
+        if (timeMs / 1000 < _fromS) continue;
+        writef(_first ? "[%u,%u]" : ",[%u,%u]", (unsigned)(timeMs / 1000), (unsigned)value);
+        _first = false;
+    }
+    return true;
+}
+
+void HistorySource::writeRollup(const HistoryRollup& rollup) {
+    if (rollup.count == 0 || rollup.startS < _fromS) return;
+    writef(_first ? "[%u,%u,%u,%.1f,%u]" : ",[%u,%u,%u,%.1f,%u]",
+           (unsigned)rollup.startS, (unsigned)rollup.min, (unsigned)rollup.max,
+           rollup.avg(), (unsigned)rollup.count);
+    _first = false;
+}
+
+bool HistorySource::writeRollups(Section tier) {
+    // _seq walks the completed rollups, the open period is written last
+    HistoryRollup rollup;
+    bool more = false;
+    bool valid = HistoryService::readSeries(_slot, _epoch, [&](const HistorySeries& s) {
+        const HistoryRollup* ring = tier == DAY ? s.days : tier == HOUR ? s.hours : s.minutes;
+        uint32_t slots = tier == DAY ? HISTORY_DAY_SLOTS : tier == HOUR ? HISTORY_HOUR_SLOTS : HISTORY_MINUTE_SLOTS;
+        uint32_t written = tier == DAY ? s.daysWritten : tier == HOUR ? s.hoursWritten : s.minutesWritten;
+        const HistoryRollup& current = tier == DAY ? s.currentDay : tier == HOUR ? s.currentHour : s.currentMinute;
+        uint32_t oldest = written > slots ? written - slots : 0;
+        if (_seq < oldest) _seq = oldest;
+        if (_seq < written) {
+            rollup = ring[_seq % slots];
+            more = true;
+        } else if (_seq == written) {
+            rollup = current;
+            more = true;
+        }
+    });
+    if (!valid || !more) return false;
+
+    _seq++;
+    writeRollup(rollup);
+    return true;
+}
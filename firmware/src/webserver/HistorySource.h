@@ -0,0 +1,57 @@
+#ifndef HISTORYSOURCE_H
+#define HISTORYSOURCE_H
+
+#include "ChunkedSource.h"
+#include "../models/History.h"
+
+/**
+ * HistorySource streams the history of one register as JSON
+ *
+ * {"group":1,"slave":0,"reg":5,"now":3600,"from":0,
+ *  "raw":[[t,value],...],
+ *  "minute":[[t,min,max,avg,count],...],
+ *  "hour":[[t,min,max,avg,count],...],
+ *  "day":[[t,min,max,avg,count],...]}
+ *
+ * Raw blocks are copied one at a time under the history lock and decoded from
+ * the copy, so recording is never blocked for longer than one block copy.
+ */
+class HistorySource : public ChunkedSource {
+public:
+    // Tier selection bits
+    static constexpr uint8_t TIER_RAW = 1;
+    static constexpr uint8_t TIER_MINUTE = 2;
+    static constexpr uint8_t TIER_HOUR = 4;
+    static constexpr uint8_t TIER_DAY = 8;
+
+    HistorySource(uint32_t token, size_t slot, uint32_t epoch, uint32_t fromS, uint8_t tiers);
+
+protected:
+    bool step() override;
+
+private:
+    enum Section { HEADER, RAW, MINUTE, HOUR, DAY, FOOTER, FINISHED };
+
+    static constexpr size_t SAMPLES_PER_STEP = 16;
+
+    uint32_t _token;
+    size_t _slot;
+    uint32_t _epoch;
+    uint32_t _fromS;
+    uint8_t _tiers;
+
+    Section _section;
+    bool _first;                // No element written yet in the current array
+    uint32_t _seq;              // Next raw block or rollup sequence number
+    bool _blockLoaded;
+    HistoryBlock _block;        // Copy of the raw block being decoded
+    HistoryBlock::Cursor _cursor;
+
+    bool writeRaw();
+    bool writeRollups(Section tier);
+    void writeRollup(const HistoryRollup& rollup);
+    void openArray(const char* name);
+    void nextSection();
+};
+
+#endif
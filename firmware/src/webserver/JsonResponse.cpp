@@ -0,0 +1,62 @@
+#include "JsonResponse.h"
+
+namespace {
+
+/**
+ * Print that keeps the bytes [from, from + len) of what is written to it
+ */
+class SlicePrint : public Print {
+public:
+    SlicePrint(uint8_t* destination, size_t from, size_t len)
+        : _destination(destination), _skip(from), _left(len) {}
+
+    size_t write(uint8_t c) override {
+        if (_skip > 0) {
+            _skip--;
+            return 1;
+        }
+        if (_left == 0) return 0;
+        *_destination++ = c;
+        _left--;
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        size_t n = 0;
+        while (n < size && write(buffer[n])) n++;
+        return n;
+    }
+
+private:
+    uint8_t* _destination;
+    size_t _skip;
+    size_t _left;
+};
+
+}
+
+JsonResponse::JsonResponse(bool isArray) : _isValid(false) {
+    setCode(200);
+    setContentType("application/json");
+    if (isArray) {
+        _root = _doc.to<JsonArray>();
+    } else {
+        _root = _doc.to<JsonObject>();
+    }
+}
+
+size_t JsonResponse::setLength() {
+    size_t length = measureJson(_root);
+    setContentLength(length);
+    _isValid = length > 0;
+    return length;
+}
+
+size_t JsonResponse::_fillBuffer(uint8_t* data, size_t len) {
+    // Serializing again from the start is cheaper than keeping the whole body in memory
+    size_t remaining = _contentLength - _sentLength;
+    if (len > remaining) len = remaining;
+    SlicePrint slice(data, _sentLength, len);
+    serializeJson(_root, slice);
+    return len;
+}
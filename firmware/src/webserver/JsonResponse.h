@@ -0,0 +1,35 @@
+#ifndef JSONRESPONSE_H
+#define JSONRESPONSE_H
+
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+#include "../services/JsonPool.h"
+
+/**
+ * JsonResponse is AsyncJsonResponse with its document in the JSON pool
+ *
+ * Same interface (getRoot(), setCode(), setLength()), so handlers build the body the
+ * same way. The document is released to the pool once the response has been sent,
+ * and the body is serialized straight into the TCP buffers chunk by chunk.
+ */
+class JsonResponse : public AsyncAbstractResponse {
+public:
+    explicit JsonResponse(bool isArray = false);
+
+    JsonVariant& getRoot() { return _root; }
+
+    /**
+     * Measure the body, must be called once the root is complete
+     */
+    size_t setLength();
+
+    bool _sourceValid() const override { return _isValid; }
+    size_t _fillBuffer(uint8_t* data, size_t len) override;
+
+private:
+    JsonPool::Document _doc;
+    JsonVariant _root;
+    bool _isValid;
+};
+
+#endif
@@ -4,11 +4,57 @@
 #include "../controllers/InterfacesController.h"
 #include "../controllers/ModbusController.h"
 #include "../controllers/MapController.h"
+#include "../controllers/MetricsController.h"
+#include "../controllers/TelemetryController.h"
+#include "../controllers/HistoryController.h"
+#include "../controllers/ValuesController.h"
+#include "../controllers/CapacityController.h"
+#include "ValueSocket.h"
+#include "../services/JsonPool.h"
 #include <SPIFFS.h>
 
 // Initialize static member variables
 AsyncWebServer LocalWebServer::server(80);
 
+// Fingerprinted assets (/a/<name>.<hash>.<ext>) never change under the same name
+static const char* ASSET_CACHE_CONTROL = "public, max-age=31536000, immutable";
+// index.html references the current hashes, so it must be revalidated
+static const char* PAGE_CACHE_CONTROL = "no-cache";
+
+const char* LocalWebServer::contentTypeFor(const String& path) {
+    if (path.endsWith(".html")) return "text/html";
+    if (path.endsWith(".js")) return "application/javascript";
+    if (path.endsWith(".css")) return "text/css";
+    if (path.endsWith(".json")) return "application/json";
+    if (path.endsWith(".svg")) return "image/svg+xml";
+    if (path.endsWith(".png")) return "image/png";
+    if (path.endsWith(".ico")) return "image/x-icon";
+    return "application/octet-stream";
+}
+
+void LocalWebServer::sendStatic(AsyncWebServerRequest* request, const String& path, const char* cacheControl) {
+    String file = "/public" + path;
+    String gzFile = file + ".gz";
+    
+    bool acceptsGzip = request->hasHeader("Accept-Encoding") &&
+                       request->header("Accept-Encoding").indexOf("gzip") >= 0;
+    
+    AsyncWebServerResponse* response = nullptr;
+    if (acceptsGzip && SPIFFS.exists(gzFile)) {
+        response = request->beginResponse(SPIFFS, gzFile, contentTypeFor(path));
+        response->addHeader("Content-Encoding", "gzip");
+    } else if (SPIFFS.exists(file)) {
+        response = request->beginResponse(SPIFFS, file, contentTypeFor(path));
+    } else {
+        request->send(404, "text/plain", "Not found");
+        return;
+    }
+    
+    response->addHeader("Cache-Control", cacheControl);
+    response->addHeader("Vary", "Accept-Encoding");
+    request->send(response);
+}
+
 void LocalWebServer::start() {
     // Initialize SPIFFS
     if(!SPIFFS.begin(true)){
@@ -18,16 +64,49 @@ void LocalWebServer::start() {
     
     Serial.println("SPIFFS mounted successfully");
     
+    // Every API request builds JSON documents: refuse new ones while the pool is taken
+    // (responses still being sent to slow clients) instead of growing the heap
+    server.addMiddleware([](AsyncWebServerRequest* request, ArMiddlewareNext next) {
+        if (request->url().startsWith("/api/") && JsonPool::isBusy()) {
+            JsonPool::countRejected();
+            AsyncWebServerResponse* response =
+                request->beginResponse(503, "application/json", "{\"error\":\"Server busy\"}");
+            response->addHeader("Retry-After", "1");
+            request->send(response);
+            return;
+        }
+        next();
+    });
+    
     // Register API controllers
     Serial.println("Registering API routes...");
     StatusController::registerRoutes(server);
     InterfacesController::registerRoutes(server);
     ModbusController::registerRoutes(server);
     MapController::registerRoutes(server);
+    MetricsController::registerRoutes(server);
+    TelemetryController::registerRoutes(server);
+    HistoryController::registerRoutes(server);
+    ValuesController::registerRoutes(server);
+    CapacityController::registerRoutes(server);
+    
+    // Value change push for the UI
+    ValueSocket::attach(server);
+    
+    // Content-hashed assets and the page that references them (gzip when accepted)
+    server.on("/a/*", HTTP_GET, [](AsyncWebServerRequest *request){
+        sendStatic(request, request->url(), ASSET_CACHE_CONTROL);
+    });
+    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){
+        sendStatic(request, "/index.html", PAGE_CACHE_CONTROL);
+    });
+    server.on("/index.html", HTTP_GET, [](AsyncWebServerRequest *request){
+        sendStatic(request, "/index.html", PAGE_CACHE_CONTROL);
+    });
     
-    // Serve static files from SPIFFS root without authentication
+    // Serve remaining static files from SPIFFS root without authentication
     // This should be last so API routes take precedence
-    server.serveStatic("/", SPIFFS, "/public").setDefaultFile("index.html");
+    server.serveStatic("/", SPIFFS, "/public").setDefaultFile("index.html").setCacheControl(PAGE_CACHE_CONTROL);
     
     // Optional: Add a catch-all route for debugging
     server.onNotFound([](AsyncWebServerRequest *request){
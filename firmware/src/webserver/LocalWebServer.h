@@ -10,5 +10,12 @@ public:
 
 private:
     static AsyncWebServer server;
+    
+    /**
+     * Serve a file from /public, preferring its precompressed .gz variant
+     * when the client accepts gzip
+     */
+    static void sendStatic(AsyncWebServerRequest* request, const String& path, const char* cacheControl);
+    static const char* contentTypeFor(const String& path);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "MapSource.h"
+#include "../services/ModbusService.h"
+#include "../services/RegisterMappingService.h"
+
+MapSource::MapSource()
+    : _state(HEADER), _group(0), _slave(0), _reg(0), _address(0) {}
+
+bool MapSource::step() {
+    ModbusService::ReadGuard config;
+    const auto& groups = config.groups();
+    const Group* group = _group < groups.size() ? &groups[_group] : nullptr;
+
+    switch (_state) {
+        case HEADER:
+            write("{\"groups\":[");
+            _state = GROUP_OPEN;
+            return true;
+
+        case GROUP_OPEN:
+            if (!group) {
+                _state = FOOTER;
+                return true;
+            }
+            writef("%s{\"id\":%u,\"remote_address\":%u,\"name\":", _group == 0 ? "" : ",",
+                   group->id, group->remoteAddress);
+            writeJsonString(group->name.c_str());
+            write(",\"registers\":[");
+            _reg = 0;
+            _address = 0;
+            _state = GROUP_REGISTER;
+            return true;
+
+        case GROUP_REGISTER:
+            if (group && _reg < group->registers.size()) {
+                const Register& reg = group->registers[_reg];
+                writef("%s{\"address\":%u,\"id\":%u,\"name\":", _address == 0 ? "" : ",", _address, reg.id);
+                writeJsonString(reg.name.c_str());
+                write(",\"type\":\"group\",\"slave_id\":0}");
+                _reg++;
+                _address++;
+                return true;
+            }
+            _slave = 0;
+            _reg = 0;
+            _state = SLAVE_REGISTER;
+            return true;
+
+        case SLAVE_REGISTER: {
+            // Skip slaves without registers (and past the end of this one)
+            while (group && _slave < group->slaves.size() && _reg >= group->slaves[_slave].registerCount()) {
+                _slave++;
+                _reg = 0;
+            }
+            if (group && _slave < group->slaves.size()) {
+                const Slave& slave = group->slaves[_slave];
+                const Register& reg = slave.getDefinition(_reg);
+                writef("%s{\"address\":%u,\"id\":%u,\"name\":", _address == 0 ? "" : ",", _address, reg.id);
+                writeJsonString(reg.name.c_str());
+                writef(",\"type\":\"slave\",\"slave_id\":%u}", slave.id);
+                _reg++;
+                _address++;
+                return true;
+            }
+            writef("],\"total_registers\":%u}", _address);
+            _group++;
+            _state = GROUP_OPEN;
+            return true;
+        }
+
+        case FOOTER:
+            writef("],\"initialized\":%s,\"total_groups\":%u}",
+                   RegisterMappingService::isInitialized() ? "true" : "false", (unsigned)groups.size());
+            _state = FINISHED;
+            return true;
+
+        case FINISHED:
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef MAPSOURCE_H
+#define MAPSOURCE_H
+
+#include "ChunkedSource.h"
+#include "../models/Group.h"
+
+/**
+ * MapSource streams the COM1 register mapping as JSON, one register per step
+ *
+ * {"groups":[{"id":1,"remote_address":1,"name":"...",
+ *   "registers":[{"address":0,"id":5,"name":"...","type":"group","slave_id":0},...],
+ *   "total_registers":N}],
+ *  "initialized":true,"total_groups":N}
+ *
+ * Like GroupsSource, positions are indices that are checked again on every step.
+ */
+class MapSource : public ChunkedSource {
+public:
+    MapSource();
+
+protected:
+    bool step() override;
+
+private:
+    enum State { HEADER, GROUP_OPEN, GROUP_REGISTER, SLAVE_REGISTER, FOOTER, FINISHED };
+
+    State _state;
+    size_t _group;
+    size_t _slave;
+    size_t _reg;
+    uint16_t _address;      // COM1 address within the current group
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "PrometheusSource.h"
+#include "../services/StatusService.h"
+#include "../services/ModbusPollingService.h"
+#include "../services/ModbusService.h"
+#include "../services/WarmStartService.h"
+
+PrometheusSource::PrometheusSource()
+    : _status(StatusService::getStatus()), _section(GAUGES), _index(0), _bucket(0), _cumulative(0) {
+}
+
+bool PrometheusSource::step() {
+    // Each writer returns false once its section is exhausted
+    while (_section != FINISHED) {
+        bool more = false;
+        switch (_section) {
+            case GAUGES:     more = writeGauge(_index); break;
+            case COUNTERS:   more = writeCounter(_index); break;
+            case ERRORS:     more = writeError(_index); break;
+            case HISTOGRAMS: more = writeHistogramLine(_index); break;
+            case REMOTES:    more = writeRemote(_index); break;
+            case GROUPS:     more = writeGroup(_index); break;
+            case FINISHED:   break;
+        }
+        if (more) {
+            return true;
+        }
+        _section = (Section)(_section + 1);
+        _index = 0;
+    }
+    return false;
+}
+
+void PrometheusSource::writeHeader(const char* name, const char* help, const char* type) {
+    writef("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+bool PrometheusSource::writeGauge(size_t index) {
+    const char* name;
+    const char* help;
+    uint32_t value;
+
+    switch (index) {
+        case 0: name = "hvac_uptime_seconds"; help = "Time since boot or the last counter reset";
+                value = _status.uptime; break;
+        case 1: name = "hvac_heap_free_bytes"; help = "Free heap";
+                value = ESP.getFreeHeap(); break;
+        case 2: name = "hvac_heap_min_free_bytes"; help = "Lowest free heap since boot";
+                value = ESP.getMinFreeHeap(); break;
+        case 3: name = "hvac_heap_max_alloc_bytes"; help = "Largest allocatable heap block";
+                value = ESP.getMaxAllocHeap(); break;
+        case 4: name = "hvac_poll_ongoing_requests"; help = "COM2 requests issued by the polling service and not yet answered";
+                value = _status.ongoing_requests; break;
+        case 5: {
+            name = "hvac_com2_queue_depth"; help = "Requests queued in the COM2 client";
+            Comport2* com2 = ModbusPollingService::getComport();
+            value = com2 ? com2->getInFlightCount() : 0;
+            break;
+        }
+        case 6: name = "hvac_poll_delay_milliseconds"; help = "Current adaptive polling delay";
+                value = _status.poll_delay_ms; break;
+        case 7: name = "hvac_com2_timeout_milliseconds"; help = "Response timeout applied on COM2";
+                value = _status.uart2_timeout_ms; break;
+        case 8: name = "hvac_warm_start_stale_registers"; help = "Registers still holding a value restored at boot";
+                value = WarmStartService::getStaleCount(); break;
+        default:
+            return false;
+    }
+
+    writeHeader(name, help, "gauge");
+    writef("%s %u\n", name, (unsigned)value);
+    _index++;
+    return true;
+}
+
+bool PrometheusSource::writeCounter(size_t index) {
+    switch (index) {
+        case 0:
+            writeHeader("hvac_uart_frames_total", "Modbus frames on each port", "counter");
+            writef("hvac_uart_frames_total{port=\"1\",direction=\"rx\"} %u\n", (unsigned)_status.uart1_received);
+            writef("hvac_uart_frames_total{port=\"1\",direction=\"tx\"} %u\n", (unsigned)_status.uart1_sent);
+            writef("hvac_uart_frames_total{port=\"2\",direction=\"tx\"} %u\n", (unsigned)_status.uart2_sent);
+            writef("hvac_uart_frames_total{port=\"2\",direction=\"rx\"} %u\n", (unsigned)_status.uart2_received);
+            break;
+        case 1:
+            writeHeader("hvac_com2_merged_reads_total", "COM2 reads merged into an in-flight request", "counter");
+            writef("hvac_com2_merged_reads_total %u\n", (unsigned)_status.uart2_duplicates_avoided);
+            break;
+        case 2:
+            writeHeader("hvac_com2_late_responses_total", "COM2 responses slower than their adaptive timeout", "counter");
+            writef("hvac_com2_late_responses_total %u\n", (unsigned)_status.uart2_late_responses);
+            break;
+        case 3:
+            writeHeader("hvac_poll_cycles_total", "Completed COM2 polling cycles", "counter");
+            writef("hvac_poll_cycles_total %u\n", (unsigned)_status.poll.cycles);
+            break;
+        default:
+            return false;
+    }
+    _index++;
+    return true;
+}
+
+bool PrometheusSource::writeError(size_t index) {
+    // One line per non-zero code, COM1 slots first then COM2
+    const size_t slots = ErrorCounters::SLOT_COUNT;
+    if (index == 0) {
+        writeHeader("hvac_modbus_errors_total", "Modbus errors by port and code (0 = other)", "counter");
+    }
+    while (index < 2 * slots) {
+        const ErrorCounters& counters = index < slots ? StatusService::getUart1Errors()
+                                                      : StatusService::getUart2Errors();
+        unsigned port = index < slots ? 1 : 2;
+        size_t slot = index % slots;
+        uint32_t count = counters.get(slot);
+        index++;
+        if (count > 0) {
+            writef("hvac_modbus_errors_total{port=\"%u\",code=\"0x%02X\"} %u\n",
+                   port, ErrorCounters::codeForSlot(slot), (unsigned)count);
+            break;
+        }
+    }
+    _index = index;
+    return index < 2 * slots;
+}
+
+bool PrometheusSource::histogramAt(size_t index, HistogramSeries& out) const {
+    switch (index) {
+        case 0: out = {"hvac_com1_service_microseconds", "COM1 request handler service time", "fc=\"3\"", &_status.com1_fc03_service_us}; break;
+        case 1: out = {"hvac_com1_service_microseconds", nullptr, "fc=\"6\"", &_status.com1_fc06_service_us}; break;
+        case 2: out = {"hvac_com2_rtt_microseconds", "COM2 request round-trip time", "fc=\"3\"", &_status.com2_fc03_rtt_us}; break;
+        case 3: out = {"hvac_com2_rtt_microseconds", nullptr, "fc=\"6\"", &_status.com2_fc06_rtt_us}; break;
+        case 4: out = {"hvac_com2_queue_wait_microseconds", "COM2 time from queueing to the wire", "", &_status.com2_queue_wait_us}; break;
+        case 5: out = {"hvac_poll_cycle_milliseconds", "Full polling cycle duration", "", &_status.poll.cycleMs}; break;
+        case 6: out = {"hvac_poll_cycle_requests", "COM2 requests per polling cycle", "", &_status.poll.requestsPerCycle}; break;
+        case 7: out = {"hvac_poll_cycle_bytes", "Bytes on the COM2 bus per polling cycle", "", &_status.poll.bytesPerCycle}; break;
+        default: return false;
+    }
+    return true;
+}
+
+bool PrometheusSource::writeHistogramLine(size_t index) {
+    HistogramSeries series;
+    if (!histogramAt(index, series)) {
+        return false;
+    }
+
+    const HistogramSnapshot& snap = *series.snapshot;
+    const char* sep = series.labels[0] ? "," : "";
+
+    if (_bucket == 0) {
+        if (series.help) {
+            writeHeader(series.name, series.help, "histogram");
+        }
+        _cumulative = 0;
+    }
+
+    if (_bucket < HistogramSnapshot::BOUND_COUNT) {
+        _cumulative += snap.buckets[_bucket];
+        writef("%s_bucket{%s%sle=\"%u\"} %u\n", series.name, series.labels, sep,
+               (unsigned)HistogramSnapshot::BOUNDS[_bucket], (unsigned)_cumulative);
+    } else if (_bucket == HistogramSnapshot::BOUND_COUNT) {
+        _cumulative += snap.buckets[_bucket];
+        writef("%s_bucket{%s%sle=\"+Inf\"} %u\n", series.name, series.labels, sep, (unsigned)_cumulative);
+    } else {
+        // Count must match the +Inf bucket even if a sample landed while snapshotting
+        const char* open = series.labels[0] ? "{" : "";
+        const char* close = series.labels[0] ? "}" : "";
+        writef("%s_sum%s%s%s %llu\n", series.name, open, series.labels, close, (unsigned long long)snap.sum);
+        writef("%s_count%s%s%s %u\n", series.name, open, series.labels, close, (unsigned)_cumulative);
+        _bucket = 0;
+        _index++;
+        return true;
+    }
+
+    _bucket++;
+    return true;
+}
+
+bool PrometheusSource::writeRemote(size_t index) {
+    // Families are written one after the other, each over every remote
+    const size_t remotes = _status.com2_remotes.size();
+    if (remotes == 0 || index >= 3 * remotes) {
+        return false;
+    }
+
+    size_t family = index / remotes;
+    const RemoteTiming& remote = _status.com2_remotes[index % remotes];
+    bool first = index % remotes == 0;
+
+    switch (family) {
+        case 0:
+            if (first) writeHeader("hvac_com2_srtt_microseconds", "Smoothed COM2 round-trip time per remote address", "gauge");
+            writef("hvac_com2_srtt_microseconds{remote=\"%u\"} %u\n", remote.remoteAddress, (unsigned)remote.srttUs);
+            break;
+        case 1:
+            if (first) writeHeader("hvac_com2_rto_milliseconds", "Adaptive COM2 response timeout per remote address", "gauge");
+            writef("hvac_com2_rto_milliseconds{remote=\"%u\"} %u\n", remote.remoteAddress,
+                   (unsigned)remote.rtoMs(_status.uart2_timeout_min, _status.uart2_timeout_max));
+            break;
+        default:
+            if (first) writeHeader("hvac_com2_timeouts_total", "COM2 requests that timed out per remote address", "counter");
+            writef("hvac_com2_timeouts_total{remote=\"%u\"} %u\n", remote.remoteAddress, (unsigned)remote.timeouts);
+            break;
+    }
+    _index++;
+    return true;
+}
+
+bool PrometheusSource::writeGroup(size_t index) {
+    ModbusService::ReadGuard config;
+    const auto& groups = config.groups();
+    if (index == 0) {
+        writeHeader("hvac_group_update_age_seconds", "Time since a value of the group was last received from COM2", "gauge");
+    }
+    while (index < groups.size()) {
+        const Group& group = groups[index++];
+        if (group.lastUpdateMs != 0) {
+            writef("hvac_group_update_age_seconds{group=\"%u\"} %.3f\n", group.id,
+                   (millis() - group.lastUpdateMs) / 1000.0f);
+            break;
+        }
+    }
+    _index = index;
+    return index < groups.size();
+}
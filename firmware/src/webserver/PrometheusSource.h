@@ -0,0 +1,48 @@
+#ifndef PROMETHEUSSOURCE_H
+#define PROMETHEUSSOURCE_H
+
+#include "ChunkedSource.h"
+#include "../models/StatusData.h"
+
+/**
+ * PrometheusSource writes the gateway metrics in Prometheus text exposition format
+ *
+ * Counters and histograms are snapshotted when the scrape starts, every metric
+ * family is then written line by line so no document is built in memory.
+ */
+class PrometheusSource : public ChunkedSource {
+public:
+    PrometheusSource();
+
+protected:
+    bool step() override;
+
+private:
+    enum Section { GAUGES, COUNTERS, ERRORS, HISTOGRAMS, REMOTES, GROUPS, FINISHED };
+
+    // A histogram series and the metric family it belongs to
+    struct HistogramSeries {
+        const char* name;
+        const char* help;
+        const char* labels;         // Extra labels without braces, "" for none
+        const HistogramSnapshot* snapshot;
+    };
+
+    StatusData _status;             // Snapshot taken when the scrape started
+    Section _section;
+    size_t _index;                  // Position inside the current section
+    size_t _bucket;                 // Next histogram line (buckets, +Inf, sum, count)
+    uint32_t _cumulative;           // Running bucket total of the current histogram
+
+    bool writeGauge(size_t index);
+    bool writeCounter(size_t index);
+    bool writeError(size_t index);
+    bool writeHistogramLine(size_t index);
+    bool writeRemote(size_t index);
+    bool writeGroup(size_t index);
+
+    bool histogramAt(size_t index, HistogramSeries& out) const;
+    void writeHeader(const char* name, const char* help, const char* type);
+};
+
+#endif
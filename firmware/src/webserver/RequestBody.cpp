@@ -0,0 +1,57 @@
+#include "RequestBody.h"
+#include "JsonResponse.h"
+
+void RequestBody::collect(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total,
+                          size_t maxBytes) {
+    if (index == 0) {
+        if (request->_tempObject || total > maxBytes) return;
+
+        // Freed with free() by the request destructor
+        Buffer* buffer = (Buffer*)malloc(sizeof(Buffer) + total + 1);
+        if (!buffer) {
+            Serial.printf("[RequestBody] Could not allocate %u bytes\n", (unsigned)total);
+            return;
+        }
+        buffer->size = total;
+        buffer->received = 0;
+        buffer->data()[total] = '\0';
+        request->_tempObject = buffer;
+    }
+
+    Buffer* buffer = (Buffer*)request->_tempObject;
+    if (!buffer || index + len > buffer->size) return;
+
+    memcpy(buffer->data() + index, data, len);
+    buffer->received += len;
+}
+
+char* RequestBody::require(AsyncWebServerRequest* request, size_t& length, size_t maxBytes) {
+    Buffer* buffer = (Buffer*)request->_tempObject;
+
+    if (!buffer) {
+        if (request->contentLength() > maxBytes) {
+            sendError(request, 413, "Request body too large");
+        } else if (request->contentLength() > 0) {
+            sendError(request, 500, "Out of memory");
+        } else {
+            sendError(request, 400, "Request body is required");
+        }
+        return nullptr;
+    }
+
+    if (buffer->received != buffer->size) {
+        sendError(request, 400, "Incomplete request body");
+        return nullptr;
+    }
+
+    length = buffer->size;
+    return buffer->data();
+}
+
+void RequestBody::sendError(AsyncWebServerRequest* request, int code, const char* message) {
+    JsonResponse* response = new JsonResponse();
+    response->setCode(code);
+    response->getRoot()["error"] = message;
+    response->setLength();
+    request->send(response);
+}
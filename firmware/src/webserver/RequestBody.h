@@ -0,0 +1,40 @@
+#ifndef REQUESTBODY_H
+#define REQUESTBODY_H
+
+#include <ESPAsyncWebServer.h>
+#include "../config.h"
+
+/**
+ * RequestBody collects a request body into a buffer owned by the request
+ *
+ * The buffer is allocated once from the Content-Length on the first chunk and
+ * attached to request->_tempObject, which the server frees together with the
+ * request. Concurrent requests therefore never share state, and bodies above
+ * the route's limit (REQUEST_BODY_MAX_BYTES by default) are never buffered at all.
+ */
+class RequestBody {
+public:
+    /**
+     * Body handler for server.on(), stores one chunk of the body
+     */
+    static void collect(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total,
+                        size_t maxBytes = REQUEST_BODY_MAX_BYTES);
+
+    /**
+     * The complete, null-terminated body (mutable, so it can be parsed in place)
+     * Answers the request with 400/413/500 and returns nullptr if there is none
+     */
+    static char* require(AsyncWebServerRequest* request, size_t& length,
+                         size_t maxBytes = REQUEST_BODY_MAX_BYTES);
+
+private:
+    struct Buffer {
+        size_t size;
+        size_t received;
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    static void sendError(AsyncWebServerRequest* request, int code, const char* message);
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include "ValueSocket.h"
+#include "../config.h"
+#include "../services/ValueSyncService.h"
+#include "../services/RegisterMappingService.h"
+
+AsyncWebSocket ValueSocket::socket("/ws/values");
+unsigned long ValueSocket::lastPushTime = 0;
+uint32_t ValueSocket::lastPushedVersion = 0;
+
+void ValueSocket::attach(AsyncWebServer& server) {
+    socket.onEvent(onEvent);
+    server.addHandler(&socket);
+}
+
+void ValueSocket::onEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type,
+                          void* arg, uint8_t* data, size_t len) {
+    if (type == WS_EVT_CONNECT) {
+        // Full snapshot; the next batch may repeat some slots, values are absolute
+        uint32_t version;
+        client->text(buildMessage(0, version));
+        Serial.printf("[ValueSocket] Client %u connected (%u total)\n", client->id(), server->count());
+    } else if (type == WS_EVT_DISCONNECT) {
+        Serial.printf("[ValueSocket] Client %u disconnected\n", client->id());
+    }
+}
+
+void ValueSocket::update() {
+    if (millis() - lastPushTime < VALUE_PUSH_INTERVAL_MS) return;
+    lastPushTime = millis();
+
+    socket.cleanupClients();
+
+    uint32_t current = ValueSyncService::getVersion();
+    if (socket.count() == 0 || current == lastPushedVersion) {
+        // New clients start from a snapshot, nothing to catch up on
+        lastPushedVersion = current;
+        return;
+    }
+
+    uint32_t version;
+    String message = buildMessage(lastPushedVersion, version);
+    lastPushedVersion = version;
+    socket.textAll(message);
+}
+
+String ValueSocket::buildMessage(uint32_t since, uint32_t& version) {
+    String message;
+    message.reserve(48 + (since == 0 ? RegisterMappingService::getSlotCount() * 12 : 64));
+
+    char entry[24];
+    bool first = true;
+    message += "{\"d\":[";
+    version = ValueSyncService::forEachChangedSince(since, [&](uint16_t slot) {
+        uint16_t value;
+        if (!RegisterMappingService::readSlot(slot, value)) return;
+        snprintf(entry, sizeof(entry), first ? "[%u,%u]" : ",[%u,%u]", slot, value);
+        message += entry;
+        first = false;
+    });
+
+    snprintf(entry, sizeof(entry), "],\"v\":%u", (unsigned)version);
+    message += entry;
+    snprintf(entry, sizeof(entry), ",\"layout\":%u}", (unsigned)ValueSyncService::getLayoutGeneration());
+    message += entry;
+    return message;
+}
@@ -0,0 +1,36 @@
+#ifndef VALUESOCKET_H
+#define VALUESOCKET_H
+
+#include <ESPAsyncWebServer.h>
+
+/**
+ * ValueSocket pushes register value changes over a WebSocket at /ws/values
+ *
+ * Messages are JSON text: {"d":[[slot,value],...],"v":version,"layout":generation}
+ * A client receives every slot right after connecting, then one batch of changed
+ * slots per VALUE_PUSH_INTERVAL_MS. A batch is built once and shared by all clients.
+ * When "layout" changes the slots were renumbered and the client should reload
+ * the configuration and reconnect.
+ */
+class ValueSocket {
+public:
+    static void attach(AsyncWebServer& server);
+
+    /**
+     * Push pending changes (call from loop())
+     */
+    static void update();
+
+private:
+    static AsyncWebSocket socket;
+    static unsigned long lastPushTime;
+    static uint32_t lastPushedVersion;
+
+    // Build a message with all slots changed after since
+    static String buildMessage(uint32_t since, uint32_t& version);
+
+    static void onEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type,
+                        void* arg, uint8_t* data, size_t len);
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef CONFIG_FIXTURE_H
+#define CONFIG_FIXTURE_H
+
+/**
+ * Generated JSON configurations shared by the host tests
+ * Every group has FIXTURE_GROUP_REGISTERS registers and FIXTURE_SLAVES slaves of the same
+ * model with FIXTURE_SLAVE_REGISTERS registers, so a site of MODBUS_MAX_GROUPS groups
+ * fills MODBUS_MAX_TOTAL_SLAVES while each group stays under CONFIG_STREAM_GROUP_MAX_BYTES
+ */
+
+#include <string>
+#include "../src/config.h"
+
+constexpr size_t FIXTURE_GROUP_REGISTERS = 20;
+constexpr size_t FIXTURE_SLAVES = MODBUS_MAX_TOTAL_SLAVES / MODBUS_MAX_GROUPS;
+constexpr size_t FIXTURE_SLAVE_REGISTERS = 8;
+
+// {"seq":N,"groups":[...]} as written by earlier firmware and accepted by the import
+// (groups with more registers than the defaults may exceed the import limit per group)
+inline std::string generateConfig(size_t groupCount, uint32_t seq,
+                                  size_t groupRegisters = FIXTURE_GROUP_REGISTERS,
+                                  size_t slaveRegisters = FIXTURE_SLAVE_REGISTERS) {
+    std::string json = "{\"seq\":" + std::to_string(seq) + ",\"comment\":\"Generated \\\"site\\\" [test]\",\"groups\":[";
+    for (size_t g = 1; g <= groupCount; g++) {
+        if (g > 1) json += ",";
+        json += "{\"id\":" + std::to_string(g) + ",\"remote_address\":" + std::to_string(100 + g) +
+                ",\"name\":\"Outdoor unit " + std::to_string(g) + " {roof}\",\"registers\":[";
+        for (size_t r = 0; r < groupRegisters; r++) {
+            if (r > 0) json += ",";
+            json += "{\"id\":" + std::to_string(50 + r) + ",\"name\":\"Outdoor register " + std::to_string(r) +
+                    "\",\"value\":123}";
+        }
+        json += "],\"slaves\":[";
+        for (size_t s = 1; s <= FIXTURE_SLAVES; s++) {
+            if (s > 1) json += ",";
+            json += "{\"id\":" + std::to_string(s) + ",\"template\":\"Indoor unit AR-09\",\"registers\":[";
+            for (size_t r = 0; r < slaveRegisters; r++) {
+                if (r > 0) json += ",";
+                json += "{\"id\":" + std::to_string(4000 + r) + ",\"name\":\"Indoor register " + std::to_string(r) +
+                        "\"}";
+            }
+            json += "]}";
+        }
+        json += "]}";
+    }
+    json += "]}";
+    return json;
+}
+
+#endif // CONFIG_FIXTURE_H
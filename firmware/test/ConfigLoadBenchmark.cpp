@@ -0,0 +1,123 @@
+/**
+ * Host benchmark of the boot load: the JSON file of earlier firmware against the binary checkpoint
+ *
+ * Loads the same generated site at the MODBUS_MAX_* limits (every group and slave, and
+ * MODBUS_MAX_SLOTS registers) both ways, the JSON read in 256-byte chunks like
+ * PreferencesService::loadLegacyJson and the binary one decoded from
+ * a single buffer like loadCheckpoint, and checks that both give the same configuration.
+ * Storage reads are not included. Build and run with scripts/host-test.sh.
+ */
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include "../src/config.h"
+#include "../src/models/Group.h"
+#include "../src/services/ConfigCodec.h"
+#include "../src/services/ConfigStreamParser.h"
+#include "../src/services/JsonPool.h"
+#include "ConfigFixture.h"
+
+HardwareSerial Serial;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                          \
+    do {                                                                          \
+        if (!(condition)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                           \
+        }                                                                         \
+    } while (0)
+
+constexpr int RUNS = 20;
+constexpr size_t SLAVE_REGISTERS = MODBUS_MAX_SLAVE_VALUES / MODBUS_MAX_TOTAL_SLAVES;
+
+GroupList fromJson;     // Static like the configuration lists, too large for the stack
+GroupList fromBinary;
+
+bool loadJson(const std::string& json, GroupList& groups) {
+    ConfigStreamParser parser(groups, CONFIG_LEGACY_GROUP_MAX_BYTES);
+    for (size_t pos = 0; pos < json.size(); pos += 256) {
+        size_t length = json.size() - pos < 256 ? json.size() - pos : 256;
+        if (!parser.feed(json.data() + pos, length)) break;
+    }
+    return parser.finish();
+}
+
+bool loadBinary(const std::vector<uint8_t>& data, GroupList& groups) {
+    uint32_t seq = 0;
+    return ConfigCodec::check(data.data(), data.size(), seq) == data.size() &&
+           ConfigCodec::decode(data.data(), data.size(), groups, seq);
+}
+
+// Best of RUNS loads, in microseconds
+template <typename Load>
+uint32_t measure(Load load) {
+    uint32_t best = UINT32_MAX;
+    for (int run = 0; run < RUNS; run++) {
+        uint32_t startUs = micros();
+        if (!load()) return 0;
+        uint32_t elapsedUs = micros() - startUs;
+        if (elapsedUs < best) best = elapsedUs;
+    }
+    return best;
+}
+
+bool sameConfiguration(const GroupList& a, const GroupList& b) {
+    if (a.size() != b.size() || a.slaveCount() != b.slaveCount() || a.valueCount() != b.valueCount()) {
+        return false;
+    }
+    for (size_t g = 0; g < a.size(); g++) {
+        const Group& x = a[g];
+        const Group& y = b[g];
+        if (x.id != y.id || x.remoteAddress != y.remoteAddress || strcmp(x.name.c_str(), y.name.c_str()) != 0 ||
+            x.registers.size() != y.registers.size() || x.slaves.size() != y.slaves.size()) {
+            return false;
+        }
+        for (size_t r = 0; r < x.registers.size(); r++) {
+            if (x.registers[r].id != y.registers[r].id ||
+                strcmp(x.registers[r].name.c_str(), y.registers[r].name.c_str()) != 0) {
+                return false;
+            }
+        }
+        for (size_t s = 0; s < x.slaves.size(); s++) {
+            const Slave& u = x.slaves[s];
+            const Slave& v = y.slaves[s];
+            if (u.id != v.id || !u.registerTemplate->sameRegisters(*v.registerTemplate)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    JsonPool::init();
+
+    std::string json = generateConfig(MODBUS_MAX_GROUPS, 42, MODBUS_MAX_GROUP_REGISTERS, SLAVE_REGISTERS);
+    CHECK(loadJson(json, fromJson));
+    CHECK(fromJson.slaveCount() == MODBUS_MAX_TOTAL_SLAVES);
+    CHECK(fromJson.size() * MODBUS_MAX_GROUP_REGISTERS + fromJson.valueCount() == MODBUS_MAX_SLOTS);
+
+    std::vector<uint8_t> binary;
+    CHECK(ConfigCodec::encode(fromJson, 42, binary));
+    CHECK(loadBinary(binary, fromBinary));
+    CHECK(sameConfiguration(fromJson, fromBinary));
+
+    uint32_t jsonUs = measure([&] { return loadJson(json, fromJson); });
+    uint32_t binaryUs = measure([&] { return loadBinary(binary, fromBinary); });
+    CHECK(jsonUs > 0 && binaryUs > 0);
+
+    fprintf(stderr, "%u groups, %u slaves, %u slave register values (best of %d loads)\n",
+            (unsigned)fromJson.size(), (unsigned)fromJson.slaveCount(), (unsigned)fromJson.valueCount(), RUNS);
+    fprintf(stderr, "  JSON    %7u bytes %7u us\n", (unsigned)json.size(), (unsigned)jsonUs);
+    fprintf(stderr, "  binary  %7u bytes %7u us\n", (unsigned)binary.size(), (unsigned)binaryUs);
+
+    fprintf(stderr, "%s (%d failed checks)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * Host test of ConfigStreamParser on configurations far larger than one JSON document
+ *
+ * Generates a site at the MODBUS_MAX_* limits (over 100 KB of JSON) and feeds it
+ * in small chunks of varying size, the way the import request body and the legacy
+ * configuration file arrive. Build and run with scripts/host-test.sh.
+ */
+
+#include <Arduino.h>
+#include <string>
+#include "../src/config.h"
+#include "../src/models/Group.h"
+#include "../src/services/ConfigStreamParser.h"
+#include "../src/services/JsonPool.h"
+#include "ConfigFixture.h"
+
+HardwareSerial Serial;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                          \
+    do {                                                                          \
+        if (!(condition)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                           \
+        }                                                                         \
+    } while (0)
+
+GroupList groups;   // Static like the configuration lists, too large for the stack
+
+struct Result {
+    bool ok;
+    const char* error;
+    uint32_t seq;
+    size_t peakGroupBytes;
+};
+
+// Parse into groups, fed in chunks of 1 to maxChunk bytes (fixed pseudo-random sequence)
+Result parse(const std::string& json, size_t maxChunk) {
+    ConfigStreamParser parser(groups);
+    uint32_t random = 12345;
+    bool ok = true;
+    for (size_t pos = 0; ok && pos < json.size();) {
+        random = random * 1103515245u + 12345u;
+        size_t length = 1 + (random >> 16) % maxChunk;
+        if (length > json.size() - pos) length = json.size() - pos;
+        ok = parser.feed(json.data() + pos, length);
+        pos += length;
+    }
+    ok = ok && parser.finish();
+    return {ok, parser.getError(), parser.getSeq(), parser.getPeakGroupBytes()};
+}
+
+void testLargeConfiguration() {
+    std::string json = generateConfig(MODBUS_MAX_GROUPS, 42);
+    fprintf(stderr, "Generated configuration: %u bytes\n", (unsigned)json.size());
+    CHECK(json.size() > 100 * 1024);
+
+    for (size_t maxChunk : {1, 7, 64, 700}) {
+        Result result = parse(json, maxChunk);
+        CHECK(result.ok);
+        if (!result.ok) {
+            fprintf(stderr, "  chunks up to %u bytes: %s\n", (unsigned)maxChunk, result.error);
+            continue;
+        }
+
+        CHECK(result.seq == 42);
+        CHECK(result.peakGroupBytes <= CONFIG_STREAM_GROUP_MAX_BYTES);
+        CHECK(groups.size() == MODBUS_MAX_GROUPS);
+        CHECK(groups.slaveCount() == MODBUS_MAX_TOTAL_SLAVES);
+        CHECK(groups.valueCount() == MODBUS_MAX_TOTAL_SLAVES * FIXTURE_SLAVE_REGISTERS);
+        CHECK(Group::countTemplates(groups) == 1);
+
+        const Group& group = groups[6];
+        CHECK(group.id == 7);
+        CHECK(group.remoteAddress == 107);
+        CHECK(strcmp(group.name.c_str(), "Outdoor unit 7 {roof}") == 0);
+        CHECK(group.registers.size() == FIXTURE_GROUP_REGISTERS);
+        CHECK(group.registers[3].id == 53);
+        CHECK(group.registers[3].value == 0);
+        CHECK(strcmp(group.registers[3].name.c_str(), "Outdoor register 3") == 0);
+        CHECK(group.slaves.size() == FIXTURE_SLAVES);
+
+        const Slave& slave = group.slaves[FIXTURE_SLAVES - 1];
+        CHECK(slave.id == FIXTURE_SLAVES);
+        CHECK(slave.values.size() == FIXTURE_SLAVE_REGISTERS);
+        CHECK(slave.getDefinition(7).id == 4007);
+        CHECK(strcmp(slave.registerTemplate->name.c_str(), "Indoor unit AR-09") == 0);
+        fprintf(stderr, "  chunks up to %u bytes: largest group %u bytes\n", (unsigned)maxChunk,
+                (unsigned)result.peakGroupBytes);
+    }
+
+    // Every group document was served by the arena (JSON_POOL_BYTES)
+    fprintf(stderr, "JSON pool high-water mark: %u of %u bytes\n", (unsigned)JsonPool::getPeakBytes(),
+            (unsigned)JsonPool::getArenaBytes());
+    CHECK(JsonPool::getFallbackCount() == 0);
+}
+
+void testBareArray() {
+    std::string json = generateConfig(2, 0);
+    size_t start = json.find("[{");
+    json = json.substr(start, json.size() - start - 1);
+
+    Result result = parse(json, 16);
+    CHECK(result.ok);
+    CHECK(groups.size() == 2);
+    CHECK(result.seq == 0);
+}
+
+void testRejected() {
+    Result tooMany = parse(generateConfig(MODBUS_MAX_GROUPS + 1, 1), 64);
+    CHECK(!tooMany.ok);
+    CHECK(strcmp(tooMany.error, "Too many groups") == 0);
+
+    std::string json = generateConfig(3, 1);
+    Result truncated = parse(json.substr(0, json.size() - 10), 64);
+    CHECK(!truncated.ok);
+    CHECK(strcmp(truncated.error, "Unexpected end of configuration") == 0);
+
+    Result trailing = parse(generateConfig(1, 1) + "x", 64);
+    CHECK(!trailing.ok);
+    CHECK(strcmp(trailing.error, "Unexpected data after the configuration") == 0);
+}
+
+}  // namespace
+
+int main() {
+    JsonPool::init();
+
+    testLargeConfiguration();
+    testBareArray();
+    testRejected();
+
+    fprintf(stderr, "%s (%d failed checks)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
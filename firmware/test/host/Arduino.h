@@ -0,0 +1,107 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * The parts of the Arduino core the host tests link against
+ * Only what the models and the configuration services use; anything talking to the
+ * hardware (serial ports, network, flash) is not built for the host.
+ */
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+class String {
+public:
+    String() {}
+    String(const char* text) : text(text ? text : "") {}
+    String(const std::string& text) : text(text) {}
+    explicit String(int value) : text(std::to_string(value)) {}
+    explicit String(unsigned value) : text(std::to_string(value)) {}
+    explicit String(long value) : text(std::to_string(value)) {}
+    explicit String(unsigned long value) : text(std::to_string(value)) {}
+
+    const char* c_str() const { return text.c_str(); }
+    size_t length() const { return text.size(); }
+    bool reserve(size_t size) {
+        text.reserve(size);
+        return true;
+    }
+    bool concat(const char* other) {
+        text += other;
+        return true;
+    }
+
+    String& operator=(const char* other) {
+        text = other ? other : "";
+        return *this;
+    }
+    String& operator+=(const String& other) {
+        text += other.text;
+        return *this;
+    }
+    String& operator+=(const char* other) {
+        text += other;
+        return *this;
+    }
+    String& operator+=(char c) {
+        text += c;
+        return *this;
+    }
+
+    bool operator==(const String& other) const { return text == other.text; }
+    bool operator==(const char* other) const { return text == other; }
+    bool operator!=(const String& other) const { return text != other.text; }
+    bool operator!=(const char* other) const { return text != other; }
+    char operator[](size_t index) const { return text[index]; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.text + b.text); }
+    friend String operator+(const String& a, const char* b) { return String(a.text + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.text); }
+
+private:
+    std::string text;
+};
+
+class HardwareSerial {
+public:
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        int written = vfprintf(stderr, format, args);
+        va_end(args);
+        return written < 0 ? 0 : written;
+    }
+    size_t print(const char* text) { return fputs(text, stderr) < 0 ? 0 : strlen(text); }
+    size_t println(const char* text = "") { return printf("%s\n", text); }
+};
+
+extern HardwareSerial Serial;
+
+inline unsigned long micros() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline unsigned long millis() {
+    return micros() / 1000;
+}
+
+// No PSRAM, and the heap is the heap
+#define MALLOC_CAP_8BIT 0x4
+#define MALLOC_CAP_SPIRAM 0x400
+#define MALLOC_CAP_INTERNAL 0x800
+
+inline bool psramFound() {
+    return false;
+}
+
+inline void* heap_caps_malloc(size_t size, uint32_t) {
+    return malloc(size);
+}
+
+#endif // HOST_ARDUINO_H
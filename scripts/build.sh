@@ -2,6 +2,7 @@
 # This script compiles the Arduino project in the parent directory
 # for the device with FQBN:
 # esp32:esp32:wt32-eth01:UploadSpeed=115200,FlashFreq=40,FlashMode=dio,PartitionScheme=min_spiffs
+# firmware/partitions.csv overrides the partition scheme (adds the hvaccfg config partition)
 
 # Do not exit immediately on error so we can handle it manually.
 set +e
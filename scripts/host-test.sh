@@ -0,0 +1,30 @@
+#!/bin/bash
+# This script builds and runs the host tests in firmware/test (no board needed)
+# Needs g++ and ArduinoJson (installed by install-libs.sh into the Arduino libraries
+# folder, or point ARDUINOJSON_SRC at its src directory)
+
+set -e
+
+# Move to the firmware directory (assumed to be one level up from the script's directory)
+cd "$(dirname "$0")/../firmware/"
+
+ARDUINOJSON_SRC="${ARDUINOJSON_SRC:-$HOME/Arduino/libraries/ArduinoJson/src}"
+if [ ! -f "$ARDUINOJSON_SRC/ArduinoJson.h" ]; then
+    echo "ArduinoJson not found in $ARDUINOJSON_SRC, run install-libs.sh or set ARDUINOJSON_SRC."
+    exit 1
+fi
+
+BUILD_DIR="$(mktemp -d)"
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+# Sources each test links against, besides the test itself
+SOURCES="src/services/ConfigStreamParser.cpp src/services/ConfigCodec.cpp src/services/NamePool.cpp \
+    src/services/TemplatePool.cpp src/services/JsonPool.cpp"
+
+for TEST in ConfigStreamParserTest ConfigLoadBenchmark; do
+    echo "Building $TEST..."
+    g++ -std=gnu++17 -O1 -Wall -I test/host -I "$ARDUINOJSON_SRC" test/$TEST.cpp $SOURCES -o "$BUILD_DIR/$TEST"
+
+    echo "Running $TEST..."
+    "$BUILD_DIR/$TEST"
+done
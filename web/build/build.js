@@ -7,6 +7,8 @@ const terser = require('terser');
 const CleanCSS = require('clean-css');
 const { execFile } = require('child_process');
 const { promisify } = require('util');
+const crypto = require('crypto');
+const zlib = require('zlib');
 const injectables = require('./injectables.json');
 
 const execFileAsync = promisify(execFile);
@@ -72,6 +74,51 @@ async function copyAndMinify(src, dest) {
   }
 }
 
+// Hashed assets live in /a/ under SPIFFS' 31 character path limit: /public/a/style.xxxxxx.css.gz
+const ASSET_DIR = 'a';
+const HASH_LENGTH = 6;
+
+async function writeGzip(file) {
+  const content = await fs.readFile(file);
+  await fs.writeFile(`${file}.gz`, zlib.gzipSync(content, { level: 9 }));
+}
+
+// Move top-level JS/CSS to content-hashed names, point the HTML at them and add .gz variants
+async function fingerprintAssets(dist) {
+  const assetDir = path.join(dist, ASSET_DIR);
+  await ensureDir(assetDir);
+
+  const renames = {};
+  for (const entry of await fs.readdir(dist)) {
+    const ext = path.extname(entry).toLowerCase();
+    if (ext !== '.js' && ext !== '.css') continue;
+
+    const src = path.join(dist, entry);
+    const content = await fs.readFile(src);
+    const hash = crypto.createHash('sha256').update(content).digest('hex').slice(0, HASH_LENGTH);
+    const hashedName = `${path.basename(entry, ext)}.${hash}${ext}`;
+    const dest = path.join(assetDir, hashedName);
+
+    await fs.rename(src, dest);
+    await writeGzip(dest);
+    renames[entry] = `${ASSET_DIR}/${hashedName}`;
+    console.log(`🔖 ${entry} -> ${renames[entry]}`);
+  }
+
+  for (const entry of await fs.readdir(dist)) {
+    if (path.extname(entry).toLowerCase() !== '.html') continue;
+
+    const file = path.join(dist, entry);
+    let html = await fs.readFile(file, 'utf8');
+    for (const [name, hashed] of Object.entries(renames)) {
+      const escaped = name.replace(/[.*+?^${}()|[\]\\]/g, '\\$&');
+      html = html.replace(new RegExp(`((?:href|src)=["']?)${escaped}(?=["'\\s>])`, 'g'), `$1${hashed}`);
+    }
+    await fs.writeFile(file, html, 'utf8');
+    await writeGzip(file);
+  }
+}
+
 async function runFinishScript(scripts) {
   await runPreScript(scripts);
 }
@@ -135,6 +182,8 @@ async function main() {
     await copyAndMinify(src, dist);
   }
 
+  await fingerprintAssets(dist);
+
   await runFinishScript(finishScripts);
 
   console.log('✅ Minification complete. Output: /firmware/data');
@@ -17,8 +17,28 @@ let mockData = {
 		uart1_recived: 15418,
 		uart2_sent: 8934,
 		uart2_recived: 8932,
+		uart2_duplicates_avoided: 12,
+		uart2_timeouts: 3,
+		uart2_late_responses: 0,
+		uart2_timeout_ms: 85,
 		eth_status: "connected",
 		eth_ip: "192.168.1.100",
+		poll: {
+			cycles: 1520,
+			last_cycle_ms: 4210,
+			last_cycle_requests: 38,
+			last_cycle_bytes: 570,
+			cycle_ms: { count: 1520, p50: 4150, p95: 4480, p99: 4790, max: 5120 },
+			requests_per_cycle: { count: 1520, p50: 38, p95: 38, p99: 38, max: 40 },
+			bytes_per_cycle: { count: 1520, p50: 570, p95: 570, p99: 570, max: 600 },
+		},
+		latency: {
+			com1_fc03_service_us: { count: 15418, p50: 38, p95: 71, p99: 140, max: 910 },
+			com1_fc06_service_us: { count: 12, p50: 95, p95: 180, p99: 180, max: 210 },
+			com2_fc03_rtt_us: { count: 8932, p50: 18500, p95: 27000, p99: 41000, max: 96000 },
+			com2_fc06_rtt_us: { count: 12, p50: 21000, p95: 30000, p99: 30000, max: 33000 },
+			com2_queue_wait_us: { count: 8934, p50: 900, p95: 19000, p99: 45000, max: 120000 },
+		},
 	},
 
 	interfaces: {
@@ -26,10 +46,14 @@ let mockData = {
 		uart1_data: "8",
 		uart1_stop: "1",
 		uart1_parity: "0",
+		uart1_frame_gap: 0,
 		uart2_baud: "9600",
 		uart2_data: "8",
 		uart2_stop: "1",
 		uart2_parity: "0",
+		uart2_frame_gap: 0,
+		uart2_timeout_min: 50,
+		uart2_timeout_max: 500,
 	},
 
 	modbus: [
@@ -154,6 +178,99 @@ app.get("/api/status", (req, res) => {
 	res.json(mockData.status);
 });
 
+app.get("/api/metrics/poll", (req, res) => {
+	const groups = mockData.modbus.map((group) => ({
+		id: group.id,
+		duration_ms: { count: mockData.status.poll.cycles, p50: 1200, p95: 1350, p99: 1420, max: 1500 },
+	}));
+	res.json({ ...mockData.status.poll, groups });
+});
+
+app.get("/api/telemetry", (req, res) => {
+	const now = Date.now() % 0xffffffff;
+	const sample = (i) => ({ t: now - i * 5000, free_heap: 182000 - i * 8, largest_block: 110580, min_free_heap: 171200, fragmentation_pct: 39 });
+	const telemetry = {
+		interval_ms: 5000,
+		heap_size: 327680,
+		current: sample(0),
+		window: { samples: 60, min_free_heap: 181528, min_largest_block: 110580, max_fragmentation_pct: 40, free_heap_trend_per_min: -96 },
+		names: { bytes: 3214, capacity: 65536, count: 187, reused: 2410 },
+		json_pool: {
+			arena_bytes: 32768,
+			psram: false,
+			used_bytes: 1024,
+			peak_bytes: 14336,
+			documents: 1,
+			peak_documents: 5,
+			max_documents: 8,
+			fallbacks: 0,
+			rejected: 0,
+		},
+		tasks: [
+			{ name: "loopTask", stack_free_min: 5120 },
+			{ name: "async_tcp", stack_free_min: 9876 },
+			{ name: "com2", stack_free_min: 2210 },
+			{ name: "com1", stack_free_min: 2480 },
+		],
+		subsystems: [
+			{ name: "config", calls: 3, net_bytes: 412, last_bytes: 0, max_bytes: 412 },
+			{ name: "mapping", calls: 2, net_bytes: 1840, last_bytes: 920, max_bytes: 920 },
+			{ name: "polling", calls: 5123, net_bytes: 64, last_bytes: 0, max_bytes: 96 },
+		],
+	};
+	if (req.query.samples === "1") {
+		telemetry.samples = Array.from({ length: 60 }, (_, i) => sample(59 - i));
+	}
+	res.json(telemetry);
+});
+
+app.get("/api/capacity", (req, res) => {
+	const limit = (used, max) => ({ used, max, free: Math.max(max - used, 0) });
+	res.json({
+		groups: limit(mockData.modbus.length, 16),
+		slaves_per_group: limit(Math.max(0, ...mockData.modbus.map((g) => g.slaves.length)), 16),
+		group_registers: limit(Math.max(0, ...mockData.modbus.map((g) => g.registers.length)), 32),
+		slave_registers: limit(Math.max(0, ...mockData.modbus.flatMap((g) => g.slaves.map((s) => s.registers.length))), 32),
+		templates: { ...limit(2, 32), peak: 3, overflows: 0 },
+		name_bytes: limit(3214, 65536),
+		registers: mockData.modbus.reduce((n, g) => n + g.registers.length + g.slaves.reduce((m, s) => m + s.registers.length, 0), 0),
+		static_bytes: 66560,
+		staging_in_use: false,
+	});
+});
+
+// Binary value dump in slot order (see ValuesController.h for the layout)
+app.get("/api/values", (req, res) => {
+	const values = [];
+	mockData.modbus.forEach((group) => {
+		(group.registers || []).forEach((register) => values.push(register.value || 0));
+		(group.slaves || []).forEach((slave) => (slave.registers || []).forEach((register) => values.push(register.value || 0)));
+	});
+
+	const body = Buffer.alloc(12 + values.length * 2);
+	body.writeUInt8(1, 0);
+	body.writeUInt8(0, 1);
+	body.writeUInt16LE(values.length, 2);
+	body.writeUInt32LE(1, 4);
+	body.writeUInt32LE(Math.floor(Date.now() / 1000) >>> 0, 8);
+	values.forEach((value, slot) => body.writeUInt16LE(value & 0xffff, 12 + slot * 2));
+
+	res.set("Cache-Control", "no-store");
+	res.type("application/octet-stream").send(body);
+});
+
+app.get("/api/history/series", (req, res) => {
+	res.json({ capacity: 4, series: [{ group: 1, slave: 0, reg: 1, raw_samples: 412, minutes: 120, hours: 5, days: 0 }] });
+});
+
+app.get("/api/history", (req, res) => {
+	const now = Math.floor(process.uptime());
+	const from = Number(req.query.from || 0);
+	const raw = Array.from({ length: 60 }, (_, i) => [now - (60 - i) * 10, 215 + Math.round(Math.sin(i / 6) * 4)]).filter(([t]) => t >= from);
+	const minute = Array.from({ length: 10 }, (_, i) => [now - now % 60 - (9 - i) * 60, 211, 219, 215.2, 58]).filter(([t]) => t >= from);
+	res.json({ group: Number(req.query.group), slave: Number(req.query.slave || 0), reg: Number(req.query.reg), now, from, raw, minute, hour: [], day: [] });
+});
+
 // ============================================================
 // ROUTES: INTERFACES
 // ============================================================
@@ -163,7 +280,7 @@ app.get("/api/interfaces", (req, res) => {
 });
 
 app.post("/api/interfaces", (req, res) => {
-	const { uart1_baud, uart1_data, uart1_stop, uart1_parity, uart2_baud, uart2_data, uart2_stop, uart2_parity } = req.body;
+	const { uart1_baud, uart1_data, uart1_stop, uart1_parity, uart2_baud, uart2_data, uart2_stop, uart2_parity, uart1_frame_gap = 0, uart2_frame_gap = 0, uart2_timeout_min = 50, uart2_timeout_max = 500 } = req.body;
 
 	// Validate inputs
 	const validBauds = ["9600", "19200", "38400", "57600", "115200"];
@@ -187,15 +304,23 @@ app.post("/api/interfaces", (req, res) => {
 		return res.status(400).json({ error: "Invalid parity" });
 	}
 
+	if (uart2_timeout_min < 10 || uart2_timeout_max > 10000 || uart2_timeout_min > uart2_timeout_max) {
+		return res.status(400).json({ error: "Invalid timeout bounds" });
+	}
+
 	mockData.interfaces = {
 		uart1_baud: String(uart1_baud),
 		uart1_data: String(uart1_data),
 		uart1_stop: String(uart1_stop),
 		uart1_parity: String(uart1_parity),
+		uart1_frame_gap: Number(uart1_frame_gap),
 		uart2_baud: String(uart2_baud),
 		uart2_data: String(uart2_data),
 		uart2_stop: String(uart2_stop),
 		uart2_parity: String(uart2_parity),
+		uart2_frame_gap: Number(uart2_frame_gap),
+		uart2_timeout_min: Number(uart2_timeout_min),
+		uart2_timeout_max: Number(uart2_timeout_max),
 	};
 
 	res.json({ message: "Settings saved successfully", data: mockData.interfaces });
@@ -648,6 +773,101 @@ app.delete("/api/modbus/group/update/register", (req, res) => {
 	}
 });
 
+// ============================================================
+// ROUTES: BATCH
+// ============================================================
+
+// Apply one operation to a list of groups, returns an error message or null
+function applyBatchOperation(groups, op) {
+	const group = groups.find((g) => g.id === (op.op.endsWith("_group") ? op.id : op.group));
+
+	switch (op.op) {
+		case "create_group": {
+			if (group) return "Group already exists";
+			const slaves = [];
+			for (let i = 1; i <= (op.slaves || 0); i++) slaves.push({ id: i, registers: [] });
+			groups.push({ id: op.id, remote_address: op.remote || op.id, name: `Outdoor Device ${op.id}`, registers: [], slaves });
+			return null;
+		}
+		case "update_group":
+			if (!group) return "Group not found";
+			if (op.new_id !== undefined && op.new_id !== op.id) {
+				if (groups.some((g) => g.id === op.new_id)) return "Group ID already exists";
+				group.id = op.new_id;
+			}
+			if (op.slaves !== undefined) {
+				group.slaves = group.slaves.slice(0, op.slaves);
+				for (let i = group.slaves.length + 1; i <= op.slaves; i++) group.slaves.push({ id: i, registers: [] });
+			}
+			if (op.remote !== undefined) group.remote_address = op.remote;
+			return null;
+		case "delete_group":
+			if (!group) return "Group not found";
+			groups.splice(groups.indexOf(group), 1);
+			return null;
+		case "add_register":
+		case "update_register":
+		case "delete_register": {
+			if (!group) return "Group not found";
+			const owner = op.slave ? group.slaves.find((s) => s.id === op.slave) : group;
+			if (!owner) return "Slave not found";
+			const index = owner.registers.findIndex((r) => r.id === op.id);
+
+			if (op.op === "add_register") {
+				if (index !== -1 || !op.name) return "Register ID already exists";
+				owner.registers.push({ id: op.id, name: op.name });
+			} else if (op.op === "update_register") {
+				const newId = op.new_id !== undefined ? op.new_id : op.id;
+				if (index === -1 || !op.name || (newId !== op.id && owner.registers.some((r) => r.id === newId))) {
+					return "Register not found or duplicate ID";
+				}
+				owner.registers[index] = { id: newId, name: op.name };
+			} else {
+				if (index === -1) return "Register not found";
+				owner.registers.splice(index, 1);
+			}
+			return null;
+		}
+		default:
+			return "Invalid operation";
+	}
+}
+
+app.post("/api/modbus/batch", (req, res) => {
+	const operations = req.body && req.body.operations;
+	if (!Array.isArray(operations)) {
+		return res.status(400).json({ error: 'Invalid JSON, expected {"operations":[...]}' });
+	}
+
+	// All or nothing: work on a copy and swap it in only if every operation applies
+	const groups = JSON.parse(JSON.stringify(mockData.modbus));
+	for (let i = 0; i < operations.length; i++) {
+		const error = applyBatchOperation(groups, operations[i]);
+		if (error) {
+			return res.status(400).json({ error, index: i });
+		}
+	}
+
+	mockData.modbus = groups;
+	res.json({ message: "Batch applied successfully", applied: operations.length });
+});
+
+app.post("/api/modbus/import", (req, res) => {
+	const groups = Array.isArray(req.body) ? req.body : req.body && req.body.groups;
+	if (!Array.isArray(groups)) {
+		return res.status(400).json({ error: "Invalid JSON, expected an array of groups" });
+	}
+
+	mockData.modbus = groups.map((g) => ({
+		id: g.id,
+		remote_address: g.remote_address !== undefined ? g.remote_address : g.id,
+		name: g.name,
+		registers: (g.registers || []).map((r) => ({ id: r.id, name: r.name })),
+		slaves: (g.slaves || []).map((s) => ({ id: s.id, registers: (s.registers || []).map((r) => ({ id: r.id, name: r.name })) })),
+	}));
+	res.json({ message: "Configuration imported successfully", groups: mockData.modbus.length });
+});
+
 // ============================================================
 // CORS MIDDLEWARE
 // ============================================================
@@ -687,5 +907,7 @@ app.listen(PORT, () => {
 	console.log("  PATCH  /api/modbus/group/update/register?id={id}&slave={slave}&registerId={registerId}");
 	console.log("  DELETE /api/modbus/group/update/register?id={id}&slave={slave}&registerId={registerId}");
 	console.log("  GET    /api/modbus/group?id={id}");
+	console.log("  POST   /api/modbus/batch");
+	console.log("  POST   /api/modbus/import");
 	console.log("  GET    /api/map");
 });
@@ -10,6 +10,10 @@ const applicationState = {
 		refreshRate: 5000,
 		groups: [],
 		groupsInitialized: false,
+		socket: null,
+		socketFailed: false,
+		layout: null,
+		slotElements: [],
 	},
 	modalsState: {
 		addGroupPending: false,
@@ -63,10 +67,16 @@ function initializeDashboardMetrics() {
 		"UART 1 Received Packets",
 		"UART 2 Sent Packets",
 		"UART 2 Received Packets",
+		"UART 2 Merged Reads",
+		"UART 2 Timeouts",
+		"UART 2 Timeout",
 		"Ethernet Status",
 		"Ethernet IP",
 		"Pending Requests",
 		"Polling Delay",
+		"Poll Cycle (last / p95)",
+		"COM1 Service Time (p95)",
+		"COM2 Round Trip (p95)",
 	];
 
 	const metricsHtml = metricLabels
@@ -94,10 +104,16 @@ async function updateDashboardMetrics() {
 			String(statusData.uart1_recived),
 			String(statusData.uart2_sent),
 			String(statusData.uart2_recived),
+			String(statusData.uart2_duplicates_avoided),
+			String(statusData.uart2_timeouts),
+			String(statusData.uart2_timeout_ms) + " ms",
 			statusData.eth_status,
 			statusData.eth_ip || "None",
 			String(statusData.ongoing_requests),
 			String(statusData.poll_delay_ms) + " ms",
+			statusData.poll ? `${statusData.poll.last_cycle_ms} / ${statusData.poll.cycle_ms.p95} ms` : "--",
+			statusData.latency ? `${statusData.latency.com1_fc03_service_us.p95} µs` : "--",
+			statusData.latency ? `${(statusData.latency.com2_fc03_rtt_us.p95 / 1000).toFixed(1)} ms` : "--",
 		];
 
 		document.querySelectorAll(".metric_value").forEach((element, index) => {
@@ -158,11 +174,15 @@ function populateInterfacesForm(data) {
 	document.getElementById("uart1_data").value = data.uart1_data;
 	document.getElementById("uart1_stop").value = data.uart1_stop;
 	document.getElementById("uart1_parity").value = data.uart1_parity;
+	document.getElementById("uart1_frame_gap").value = data.uart1_frame_gap || 0;
 
 	document.getElementById("uart2_baud").value = data.uart2_baud;
 	document.getElementById("uart2_data").value = data.uart2_data;
 	document.getElementById("uart2_stop").value = data.uart2_stop;
 	document.getElementById("uart2_parity").value = data.uart2_parity;
+	document.getElementById("uart2_frame_gap").value = data.uart2_frame_gap || 0;
+	document.getElementById("uart2_timeout_min").value = data.uart2_timeout_min;
+	document.getElementById("uart2_timeout_max").value = data.uart2_timeout_max;
 }
 
 async function saveInterfaces(event) {
@@ -176,10 +196,14 @@ async function saveInterfaces(event) {
 			uart1_data: document.getElementById("uart1_data").value,
 			uart1_stop: document.getElementById("uart1_stop").value,
 			uart1_parity: document.getElementById("uart1_parity").value,
+			uart1_frame_gap: parseInt(document.getElementById("uart1_frame_gap").value) || 0,
 			uart2_baud: document.getElementById("uart2_baud").value,
 			uart2_data: document.getElementById("uart2_data").value,
 			uart2_stop: document.getElementById("uart2_stop").value,
 			uart2_parity: document.getElementById("uart2_parity").value,
+			uart2_frame_gap: parseInt(document.getElementById("uart2_frame_gap").value) || 0,
+			uart2_timeout_min: parseInt(document.getElementById("uart2_timeout_min").value),
+			uart2_timeout_max: parseInt(document.getElementById("uart2_timeout_max").value),
 		};
 
 		await apiCall("POST", "/api/interfaces", interfacesData);
@@ -218,10 +242,31 @@ function displayModbusGroups() {
 	}
 
 	container.innerHTML = applicationState.modbusState.groups.map((group) => createGroupColumn(group)).join("");
+	indexRegisterSlots();
+}
+
+// Slots follow COM1 address order: groups in order, group registers first, then each slave's registers
+function indexRegisterSlots() {
+	const slots = [];
 
 	applicationState.modbusState.groups.forEach((group) => {
-		updateModbusGroupValues(group.id);
+		const groupElement = document.querySelector(`[data-group-id="${group.id}"]`);
+		const find = (selector) => (groupElement ? groupElement.querySelector(`${selector} .register_value`) : null);
+
+		(group.registers || []).forEach((register) => {
+			const registerId = typeof register === "object" ? register.id : register;
+			slots.push(find(`[data-register-type="group"][data-register-id="${registerId}"]`));
+		});
+
+		(group.slaves || []).forEach((slave) => {
+			(slave.registers || []).forEach((register) => {
+				const registerId = typeof register === "object" ? register.id : register;
+				slots.push(find(`[data-register-type="slave"][data-slave-id="${slave.id}"][data-register-id="${registerId}"]`));
+			});
+		});
 	});
+
+	applicationState.modbusState.slotElements = slots;
 }
 
 function createGroupColumn(group) {
@@ -352,15 +397,82 @@ function startModbusRefresh() {
 	const refreshRate = parseInt(document.getElementById("refresh_rate").value);
 	applicationState.modbusState.refreshRate = refreshRate;
 
-	if (applicationState.modbusState.refreshInterval) {
-		clearInterval(applicationState.modbusState.refreshInterval);
+	stopModbusRefresh();
+
+	// Prefer pushed deltas, fall back to polling each group if the socket cannot be opened
+	if ("WebSocket" in window && !applicationState.modbusState.socketFailed) {
+		openValueSocket();
+	} else {
+		startModbusPolling();
 	}
+}
 
-	applicationState.modbusState.refreshInterval = setInterval(() => {
+function startModbusPolling() {
+	const refreshAll = () => {
 		applicationState.modbusState.groups.forEach((group) => {
 			updateModbusGroupValues(group.id);
 		});
-	}, applicationState.modbusState.refreshRate);
+	};
+
+	refreshAll();
+	applicationState.modbusState.refreshInterval = setInterval(refreshAll, applicationState.modbusState.refreshRate);
+}
+
+function openValueSocket() {
+	const protocol = window.location.protocol === "https:" ? "wss:" : "ws:";
+	const socket = new WebSocket(`${protocol}//${window.location.host}/ws/values`);
+	let opened = false;
+
+	socket.onopen = () => {
+		opened = true;
+	};
+
+	socket.onmessage = (event) => {
+		try {
+			applyValueDeltas(JSON.parse(event.data));
+		} catch (error) {
+			console.error("Invalid value message:", error);
+		}
+	};
+
+	socket.onclose = () => {
+		if (applicationState.modbusState.socket !== socket) return; // Closed on purpose
+
+		applicationState.modbusState.socket = null;
+		if (!opened) {
+			applicationState.modbusState.socketFailed = true;
+			startModbusPolling();
+			return;
+		}
+
+		// Dropped connection: reconnect, the server sends a fresh snapshot
+		setTimeout(() => {
+			if (applicationState.currentPage === "modbus" && !applicationState.modbusState.socket) {
+				startModbusRefresh();
+			}
+		}, 2000);
+	};
+
+	applicationState.modbusState.socket = socket;
+}
+
+function applyValueDeltas(message) {
+	const state = applicationState.modbusState;
+
+	// Slots were renumbered by a configuration change: reload and resubscribe
+	if (state.layout !== null && message.layout !== state.layout) {
+		state.layout = null;
+		loadModbusConfig();
+		return;
+	}
+	state.layout = message.layout;
+
+	message.d.forEach(([slot, value]) => {
+		const valueElement = state.slotElements[slot];
+		if (valueElement) {
+			valueElement.textContent = value;
+		}
+	});
 }
 
 function stopModbusRefresh() {
@@ -368,6 +480,13 @@ function stopModbusRefresh() {
 		clearInterval(applicationState.modbusState.refreshInterval);
 		applicationState.modbusState.refreshInterval = null;
 	}
+
+	const socket = applicationState.modbusState.socket;
+	if (socket) {
+		applicationState.modbusState.socket = null;
+		socket.close();
+	}
+	applicationState.modbusState.layout = null;
 }
 
 function openAddGroupModal() {